@@ -0,0 +1,231 @@
+/* headless simulation runner, steps the world with a fixed timestep and reports the throughput */
+#include <memory>
+#include <string>
+#include <chrono>
+#include <optional>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#ifdef HEADLESS_USE_EGL
+#include <cstring>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include "OGLRenderer.h"
+#include "ModelInstanceCamData.h"
+#include "Logger.h"
+#include "Tools.h"
+#include "AllocationCounter.h"
+
+namespace {
+  /* models and levels keep their data in GPU buffers, so we still need a context, but no window or display */
+  struct HeadlessContext {
+#ifdef HEADLESS_USE_EGL
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLSurface surface = EGL_NO_SURFACE;
+    EGLContext context = EGL_NO_CONTEXT;
+#else
+    GLFWwindow* window = nullptr;
+#endif
+  };
+
+#ifdef HEADLESS_USE_EGL
+  void destroyContext(HeadlessContext& headlessContext) {
+    if (headlessContext.display == EGL_NO_DISPLAY) {
+      return;
+    }
+    eglMakeCurrent(headlessContext.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (headlessContext.context != EGL_NO_CONTEXT) {
+      eglDestroyContext(headlessContext.display, headlessContext.context);
+    }
+    if (headlessContext.surface != EGL_NO_SURFACE) {
+      eglDestroySurface(headlessContext.display, headlessContext.surface);
+    }
+    eglTerminate(headlessContext.display);
+    headlessContext = HeadlessContext{};
+  }
+
+  bool createContext(HeadlessContext& headlessContext) {
+    /* Mesa can create contexts without any window system, the other drivers use the default display */
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+      headlessContext.display = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+    }
+    if (headlessContext.display == EGL_NO_DISPLAY) {
+      headlessContext.display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint majorVersion = 0;
+    EGLint minorVersion = 0;
+    if (headlessContext.display == EGL_NO_DISPLAY ||
+        !eglInitialize(headlessContext.display, &majorVersion, &minorVersion)) {
+      Logger::log(1, "%s error: could not initialize EGL\n", __FUNCTION__);
+      headlessContext = HeadlessContext{};
+      return false;
+    }
+    Logger::log(1, "%s: EGL %d.%d initialized\n", __FUNCTION__, majorVersion, minorVersion);
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+      Logger::log(1, "%s error: EGL has no desktop OpenGL support\n", __FUNCTION__);
+      destroyContext(headlessContext);
+      return false;
+    }
+
+    const EGLint configAttributes[] = {
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint numberOfConfigs = 0;
+    if (!eglChooseConfig(headlessContext.display, configAttributes, &config, 1, &numberOfConfigs) ||
+        numberOfConfigs == 0) {
+      Logger::log(1, "%s error: no matching EGL config\n", __FUNCTION__);
+      destroyContext(headlessContext);
+      return false;
+    }
+
+    /* the renderer draws into its own framebuffer, a minimal surface is enough */
+    const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+    headlessContext.surface = eglCreatePbufferSurface(headlessContext.display, config, surfaceAttributes);
+
+    const EGLint contextAttributes[] = {
+      EGL_CONTEXT_MAJOR_VERSION, 4,
+      EGL_CONTEXT_MINOR_VERSION, 6,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+      EGL_NONE
+    };
+    headlessContext.context = eglCreateContext(headlessContext.display, config, EGL_NO_CONTEXT, contextAttributes);
+
+    if (headlessContext.surface == EGL_NO_SURFACE || headlessContext.context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(headlessContext.display, headlessContext.surface, headlessContext.surface, headlessContext.context)) {
+      Logger::log(1, "%s error: could not create an OpenGL 4.6 core context (EGL error 0x%x)\n", __FUNCTION__,
+        eglGetError());
+      destroyContext(headlessContext);
+      return false;
+    }
+    return true;
+  }
+
+  GLADloadproc getLoadFunction() {
+    return (GLADloadproc)eglGetProcAddress;
+  }
+#else
+  /* no EGL on this platform, fall back to a hidden window */
+  void destroyContext(HeadlessContext& headlessContext) {
+    if (headlessContext.window) {
+      glfwDestroyWindow(headlessContext.window);
+    }
+    glfwTerminate();
+    headlessContext = HeadlessContext{};
+  }
+
+  bool createContext(HeadlessContext& headlessContext) {
+    if (!glfwInit()) {
+      Logger::log(1, "%s: glfwInit() error\n", __FUNCTION__);
+      return false;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    headlessContext.window = glfwCreateWindow(640, 480, "OpenGL Renderer - Headless", nullptr, nullptr);
+    if (!headlessContext.window) {
+      Logger::log(1, "%s error: Could not create hidden window\n", __FUNCTION__);
+      destroyContext(headlessContext);
+      return false;
+    }
+
+    glfwMakeContextCurrent(headlessContext.window);
+    return true;
+  }
+
+  GLADloadproc getLoadFunction() {
+    return (GLADloadproc)glfwGetProcAddress;
+  }
+#endif
+
+  void printUsage(const char* programName) {
+    Logger::log(1, "usage: %s <config file> [number of frames] [timestep in seconds]\n", programName);
+    Logger::log(1, "  number of frames: integer larger than zero, default 1000\n");
+    Logger::log(1, "  timestep: number larger than zero, default 0.016667\n");
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 4) {
+    printUsage(argv[0]);
+    return -1;
+  }
+
+  std::string configFileName = argv[1];
+  std::optional<int> framesArgument = argc > 2 ? Tools::parseInt(argv[2]) : std::optional<int>(1000);
+  std::optional<float> timeStepArgument = argc > 3 ? Tools::parseFloat(argv[3]) : std::optional<float>(1.0f / 60.0f);
+
+  if (!framesArgument || framesArgument.value() <= 0 || !timeStepArgument || timeStepArgument.value() <= 0.0f) {
+    Logger::log(1, "%s error: invalid number of frames or timestep\n", __FUNCTION__);
+    printUsage(argv[0]);
+    return -1;
+  }
+  int numberOfFrames = framesArgument.value();
+  float timeStep = timeStepArgument.value();
+
+  HeadlessContext headlessContext{};
+  if (!createContext(headlessContext)) {
+    return -1;
+  }
+
+  /* the renderer gets no window, so it skips the user interface and all window calls */
+  std::unique_ptr<OGLRenderer> renderer = std::make_unique<OGLRenderer>(getLoadFunction());
+
+  /* no window title to update */
+  ModelInstanceCamData& rendererMICData = renderer->getModInstCamData();
+  rendererMICData.micGetWindowTitleFunction = []() { return std::string("Headless"); };
+  rendererMICData.micSetWindowTitleFunction = [](std::string windowTitle) {};
+
+  if (!renderer->init(640, 480, configFileName)) {
+    destroyContext(headlessContext);
+    Logger::log(1, "%s error: Could not init renderer\n", __FUNCTION__);
+    return -1;
+  }
+
+  /* first instance is the null instance */
+  size_t numberOfInstances = rendererMICData.micAssimpInstances.size() - 1;
+  Logger::log(1, "%s: running %i frames with %i instances, timestep %fs\n", __FUNCTION__,
+    numberOfFrames, static_cast<int>(numberOfInstances), timeStep);
+
+  AllocationCounter allocationCounter{};
+  allocationCounter.start();
+  std::chrono::time_point<std::chrono::steady_clock> startTime = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < numberOfFrames; ++i) {
+    renderer->updateWorld(timeStep);
+    renderer->endFrame();
+  }
+
+  std::chrono::time_point<std::chrono::steady_clock> endTime = std::chrono::steady_clock::now();
+  size_t numberOfAllocations = allocationCounter.stop();
+  float runTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1'000'000.0f;
+
+  /* instances may have been removed during the run (i.e. falling out of the level) */
+  size_t remainingInstances = rendererMICData.micAssimpInstances.size() - 1;
+
+  Logger::log(1, "%s: %i frames in %fs (%f ms/frame, %f simulated seconds)\n", __FUNCTION__,
+    numberOfFrames, runTime, runTime * 1000.0f / numberOfFrames, numberOfFrames * timeStep);
+  if (runTime > 0.0f) {
+    Logger::log(1, "%s: %f frames/s, %f instances/s (%i instances remaining)\n", __FUNCTION__,
+      numberOfFrames / runTime, numberOfInstances * numberOfFrames / runTime, static_cast<int>(remainingInstances));
+  }
+
+  Logger::log(1, "%s: %i heap allocations (%f per frame)\n", __FUNCTION__, static_cast<int>(numberOfAllocations),
+    static_cast<float>(numberOfAllocations) / numberOfFrames);
+
+  renderer->cleanup();
+  destroyContext(headlessContext);
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+/* offline model cache builder, imports every model below an asset directory once and writes the processed model caches */
+#include <memory>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <assimp/Importer.hpp>
+
+#include "AssimpModel.h"
+#include "TextureManager.h"
+#include "Timer.h"
+#include "Logger.h"
+
+int main(int argc, char *argv[]) {
+  std::string assetDirectory = argc > 1 ? argv[1] : "assets";
+
+  if (!std::filesystem::is_directory(assetDirectory)) {
+    Logger::log(1, "%s error: '%s' is not a directory\n", __FUNCTION__, assetDirectory.c_str());
+    return -1;
+  }
+
+  if (!glfwInit()) {
+    Logger::log(1, "%s: glfwInit() error\n", __FUNCTION__);
+    return -1;
+  }
+
+  /* the model loader creates the textures and buffers too, we need a hidden context */
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+  GLFWwindow *window = glfwCreateWindow(640, 480, "OpenGL Renderer - Model Cache Builder", nullptr, nullptr);
+  if (!window) {
+    glfwTerminate();
+    Logger::log(1, "%s error: Could not create hidden window\n", __FUNCTION__);
+    return -1;
+  }
+
+  glfwMakeContextCurrent(window);
+
+  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    Logger::log(1, "%s error: failed to initialize GLAD\n", __FUNCTION__);
+    return -1;
+  }
+
+  /* collect first, the loader adds the cache files to the directory */
+  std::vector<std::string> modelFileNames{};
+  Assimp::Importer importer;
+  for (const auto& entry : std::filesystem::recursive_directory_iterator(assetDirectory)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+
+    std::string extension = entry.path().extension().generic_string();
+    if (!extension.empty() && importer.IsExtensionSupported(extension)) {
+      modelFileNames.emplace_back(entry.path().generic_string());
+    }
+  }
+
+  Logger::log(1, "%s: found %i model files in '%s'\n", __FUNCTION__, modelFileNames.size(), assetDirectory.c_str());
+
+  TextureManager textureManager{};
+  size_t numberOfModels = 0;
+  size_t numberOfFailures = 0;
+  Timer buildTimer{};
+  buildTimer.start();
+
+  for (const auto& modelFileName : modelFileNames) {
+    /* loadModel() writes the cache if it is missing or outdated */
+    std::shared_ptr<AssimpModel> model = std::make_shared<AssimpModel>();
+    if (!model->loadModel(modelFileName, textureManager)) {
+      Logger::log(1, "%s error: could not load model '%s'\n", __FUNCTION__, modelFileName.c_str());
+      ++numberOfFailures;
+      continue;
+    }
+    model->cleanup();
+    textureManager.evictUnusedTextures();
+    ++numberOfModels;
+  }
+
+  Logger::log(1, "%s: processed %i models in %f ms, %i failed\n", __FUNCTION__, numberOfModels, buildTimer.stop(),
+    numberOfFailures);
+
+  textureManager.cleanup();
+
+  glfwDestroyWindow(window);
+  glfwTerminate();
+
+  return numberOfFailures == 0 ? 0 : -1;
+}
@@ -0,0 +1,136 @@
+/* path finding micro benchmark, loads the level(s) of a config and runs random path queries with flat and hierarchical search */
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <optional>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "OGLRenderer.h"
+#include "ModelInstanceCamData.h"
+#include "PathFinder.h"
+#include "Logger.h"
+#include "Tools.h"
+#include "AllocationCounter.h"
+
+int main(int argc, char *argv[]) {
+  std::string configFileName = argc > 1 ? argv[1] : "config/de_dust_nav.acfg";
+  std::optional<int> queriesArgument = argc > 2 ? Tools::parseInt(argv[2]) : std::optional<int>(10000);
+
+  if (!queriesArgument || queriesArgument.value() <= 0) {
+    Logger::log(1, "%s error: number of queries must be an integer larger than zero\n", __FUNCTION__);
+    Logger::log(1, "usage: %s [config file] [number of queries]\n", argv[0]);
+    return -1;
+  }
+  int numberOfQueries = queriesArgument.value();
+
+  if (!glfwInit()) {
+    Logger::log(1, "%s: glfwInit() error\n", __FUNCTION__);
+    return -1;
+  }
+
+  /* the level data is created on the GPU first, we need a hidden context */
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+  GLFWwindow *window = glfwCreateWindow(640, 480, "OpenGL Renderer - Path Benchmark", nullptr, nullptr);
+  if (!window) {
+    glfwTerminate();
+    Logger::log(1, "%s error: Could not create hidden window\n", __FUNCTION__);
+    return -1;
+  }
+
+  glfwMakeContextCurrent(window);
+
+  std::unique_ptr<OGLRenderer> renderer = std::make_unique<OGLRenderer>(window);
+
+  ModelInstanceCamData& rendererMICData = renderer->getModInstCamData();
+  rendererMICData.micGetWindowTitleFunction = []() { return std::string("Path Benchmark"); };
+  rendererMICData.micSetWindowTitleFunction = [](std::string windowTitle) {};
+
+  if (!renderer->init(640, 480, configFileName)) {
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    Logger::log(1, "%s error: Could not init renderer\n", __FUNCTION__);
+    return -1;
+  }
+
+  PathFinder& pathFinder = renderer->getPathFinder();
+  std::vector<int> groundTriangles = pathFinder.getGroundTriangleIndices();
+  if (groundTriangles.size() < 2) {
+    Logger::log(1, "%s error: config '%s' has no level with ground triangles\n", __FUNCTION__, configFileName.c_str());
+    renderer->cleanup();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return -1;
+  }
+
+  /* fixed seed, every run uses the same queries */
+  std::mt19937 randomEngine(1234);
+  std::uniform_int_distribution<size_t> triangleDistribution(0, groundTriangles.size() - 1);
+  std::vector<std::pair<int, int>> queries(numberOfQueries);
+  for (auto& query : queries) {
+    query.first = groundTriangles.at(triangleDistribution(randomEngine));
+    query.second = groundTriangles.at(triangleDistribution(randomEngine));
+  }
+
+  Logger::log(1, "%s: running %i path queries on %i ground triangles (%i clusters)\n", __FUNCTION__, numberOfQueries,
+    groundTriangles.size(), pathFinder.getNumberOfClusters());
+
+  /* same queries for both modes */
+  for (const bool hierarchical : { false, true }) {
+    const char* searchMode = hierarchical ? "hierarchical" : "flat";
+
+    /* the first search sizes the per-thread arrays */
+    pathFinder.findPath(queries.at(0).first, queries.at(0).second, hierarchical);
+
+    size_t pathsFound = 0;
+    size_t totalPathLength = 0;
+    size_t totalNodesExpanded = 0;
+    float maxQueryTime = 0.0f;
+
+    AllocationCounter allocationCounter{};
+    allocationCounter.start();
+    std::chrono::time_point<std::chrono::steady_clock> startTime = std::chrono::steady_clock::now();
+
+    for (const auto& query : queries) {
+      std::chrono::time_point<std::chrono::steady_clock> queryStartTime = std::chrono::steady_clock::now();
+      const std::vector<int>& path = pathFinder.findPath(query.first, query.second, hierarchical);
+      std::chrono::time_point<std::chrono::steady_clock> queryEndTime = std::chrono::steady_clock::now();
+
+      float queryTime = std::chrono::duration_cast<std::chrono::nanoseconds>(queryEndTime - queryStartTime).count() / 1000.0f;
+      maxQueryTime = std::max(maxQueryTime, queryTime);
+      totalNodesExpanded += PathFinder::getLastNodesExpanded();
+
+      if (!path.empty()) {
+        ++pathsFound;
+        totalPathLength += path.size();
+      }
+    }
+
+    std::chrono::time_point<std::chrono::steady_clock> endTime = std::chrono::steady_clock::now();
+    size_t numberOfAllocations = allocationCounter.stop();
+    float runTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f;
+
+    Logger::log(1, "%s: %s: %i queries in %f ms (%f us/query, slowest %f us)\n", __FUNCTION__, searchMode,
+      numberOfQueries, runTime, runTime * 1000.0f / numberOfQueries, maxQueryTime);
+    Logger::log(1, "%s: %s: %i paths found, %f triangles per path, %f nodes expanded per query\n", __FUNCTION__, searchMode,
+      pathsFound, pathsFound > 0 ? static_cast<float>(totalPathLength) / pathsFound : 0.0f,
+      static_cast<float>(totalNodesExpanded) / numberOfQueries);
+    Logger::log(1, "%s: %s: %i heap allocations (%f per query)\n", __FUNCTION__, searchMode, numberOfAllocations,
+      static_cast<float>(numberOfAllocations) / numberOfQueries);
+  }
+
+  renderer->cleanup();
+
+  glfwDestroyWindow(window);
+  glfwTerminate();
+
+  return 0;
+}
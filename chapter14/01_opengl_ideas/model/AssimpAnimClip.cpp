@@ -35,6 +35,14 @@ void AssimpAnimClip::setClipName(std::string name) {
   mClipName = name;
 }
 
+void AssimpAnimClip::setClipDuration(float duration) {
+  mClipDuration = duration;
+}
+
+void AssimpAnimClip::setClipTicksPerSecond(float ticksPerSecond) {
+  mClipTicksPerSecond = ticksPerSecond;
+}
+
 const std::vector<std::shared_ptr<AssimpAnimChannel>>& AssimpAnimClip::getChannels() {
   return mAnimChannels;
 }
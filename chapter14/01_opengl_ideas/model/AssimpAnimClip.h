@@ -21,6 +21,9 @@ class AssimpAnimClip {
     const unsigned int getNumChannels();
 
     void setClipName(std::string name);
+    /* for clips restored from the model cache, without channels */
+    void setClipDuration(float duration);
+    void setClipTicksPerSecond(float ticksPerSecond);
 
   private:
     std::string mClipName;
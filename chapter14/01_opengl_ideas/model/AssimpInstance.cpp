@@ -72,7 +72,7 @@ void AssimpInstance::updateAnimation(float deltaTime) {
 }
 
 void AssimpInstance::updateAnimStateMachine(float deltaTime) {
-  ModelSettings modSettings = mAssimpModel->getModelSettings();
+  const ModelSettings& modSettings = mAssimpModel->getModelSettings();
 
   moveState currentState = mInstanceSettings.isMoveState;
   moveState nextState = mNextMoveState;
@@ -94,13 +94,13 @@ void AssimpInstance::updateAnimStateMachine(float deltaTime) {
 
         IdleWalkRunBlending blend;
         if (modSettings.msIWRBlendings.count(mInstanceSettings.isMoveDirection) > 0 ) {
-          blend = modSettings.msIWRBlendings[mInstanceSettings.isMoveDirection];
+          blend = modSettings.msIWRBlendings.at(mInstanceSettings.isMoveDirection);
         } else if (modSettings.msIWRBlendings.count(mPrevMoveDirection) > 0 ) {
-          blend = modSettings.msIWRBlendings[mPrevMoveDirection];
+          blend = modSettings.msIWRBlendings.at(mPrevMoveDirection);
         } else if (modSettings.msIWRBlendings.count(moveDirection::any) > 0) {
-          blend = modSettings.msIWRBlendings[moveDirection::any];
+          blend = modSettings.msIWRBlendings.at(moveDirection::any);
         } else if (modSettings.msIWRBlendings.count(moveDirection::none) > 0) {
-          blend = modSettings.msIWRBlendings[moveDirection::none];
+          blend = modSettings.msIWRBlendings.at(moveDirection::none);
         } else {
           /* no animation configured, jump to next state... */
           mAnimState = animationState::transitionFromIdleWalkRun;
@@ -275,7 +275,7 @@ void AssimpInstance::updateInstanceSpeed(float deltaTime) {
 
 void AssimpInstance::updateInstancePosition(float deltaTime) {
   if (!mInstanceSettings.isNoMovement) {
-    ModelSettings modSettings = mAssimpModel->getModelSettings();
+    const ModelSettings& modSettings = mAssimpModel->getModelSettings();
     /* rotate accel/speed according to instance azimuth -> WASD */
     float sinRot = std::sin(glm::radians(mInstanceSettings.isWorldRotation.y)) * modSettings.msForwardSpeedFactor;
     float cosRot = std::cos(glm::radians(mInstanceSettings.isWorldRotation.y)) * modSettings.msForwardSpeedFactor;
@@ -299,7 +299,7 @@ void AssimpInstance::applyGravity(float deltaTime) {
 
   /* we are off ground on hop and jump, do not apply gravity */
   if (mInstanceSettings.isMoveState != moveState::hop && mInstanceSettings.isMoveState != moveState::jump) {
-    if (!mInstanceSettings.isInstanceOnGround) {
+    if (!mRuntimeData.irdInstanceOnGround) {
       mInstanceSettings.isWorldPosition -= gravity;
     }
   }
@@ -367,16 +367,16 @@ void AssimpInstance::rotateTo(glm::vec3 targetPos, float deltaTime) {
 }
 
 void AssimpInstance::blendActionAnimation(float deltaTime, bool backwards) {
-  ModelSettings modSettings = mAssimpModel->getModelSettings();
+  const ModelSettings& modSettings = mAssimpModel->getModelSettings();
   IdleWalkRunBlending blend;
   if (modSettings.msIWRBlendings.count(mInstanceSettings.isMoveDirection) > 0 ) {
-    blend = modSettings.msIWRBlendings[mInstanceSettings.isMoveDirection];
+    blend = modSettings.msIWRBlendings.at(mInstanceSettings.isMoveDirection);
   } else if (modSettings.msIWRBlendings.count(mPrevMoveDirection) > 0 ) {
-    blend = modSettings.msIWRBlendings[mPrevMoveDirection];
+    blend = modSettings.msIWRBlendings.at(mPrevMoveDirection);
   } else if (modSettings.msIWRBlendings.count(moveDirection::any) > 0) {
-    blend = modSettings.msIWRBlendings[moveDirection::any];
+    blend = modSettings.msIWRBlendings.at(moveDirection::any);
   } else if (modSettings.msIWRBlendings.count(moveDirection::none) > 0) {
-    blend = modSettings.msIWRBlendings[moveDirection::none];
+    blend = modSettings.msIWRBlendings.at(moveDirection::none);
   } else {
     /* no animation configured, jump to next state... */
     if (backwards) {
@@ -400,8 +400,15 @@ void AssimpInstance::blendActionAnimation(float deltaTime, bool backwards) {
     blendSpeedFactor *= 25;
   }
 
-  mInstanceSettings.isSecondAnimClipNr = modSettings.msActionClipMappings[mActionMoveState].aaClipNr;
-  float animSpeed = modSettings.msActionClipMappings[mActionMoveState].aaClipSpeed;
+  /* unmapped action states use the default clip */
+  ActionAnimation actionAnim{};
+  const auto actionClip = modSettings.msActionClipMappings.find(mActionMoveState);
+  if (actionClip != modSettings.msActionClipMappings.end()) {
+    actionAnim = actionClip->second;
+  }
+
+  mInstanceSettings.isSecondAnimClipNr = actionAnim.aaClipNr;
+  float animSpeed = actionAnim.aaClipSpeed;
 
   if (backwards) {
     mInstanceSettings.isAnimBlendFactor -= blendSpeedFactor;
@@ -414,7 +421,7 @@ void AssimpInstance::blendActionAnimation(float deltaTime, bool backwards) {
     mInstanceSettings.isAnimBlendFactor += blendSpeedFactor;
 
     if (mInstanceSettings.isAnimBlendFactor >= 1.0f) {
-      mInstanceSettings.isFirstAnimClipNr = modSettings.msActionClipMappings[mActionMoveState].aaClipNr;
+      mInstanceSettings.isFirstAnimClipNr = actionAnim.aaClipNr;
       mInstanceSettings.isAnimBlendFactor = 0.0f;
       mAnimState = animationState::playActionAnim;
     }
@@ -424,13 +431,13 @@ void AssimpInstance::blendActionAnimation(float deltaTime, bool backwards) {
 }
 
 void AssimpInstance::playActionAnimation() {
-  ModelSettings modSettings = mAssimpModel->getModelSettings();
+  const ModelSettings& modSettings = mAssimpModel->getModelSettings();
   if (modSettings.msActionClipMappings.count(mActionMoveState) == 0) {
     return;
   }
 
-  mInstanceSettings.isFirstAnimClipNr = modSettings.msActionClipMappings[mActionMoveState].aaClipNr;
-  mInstanceSettings.isAnimSpeedFactor = modSettings.msActionClipMappings[mActionMoveState].aaClipSpeed;
+  mInstanceSettings.isFirstAnimClipNr = modSettings.msActionClipMappings.at(mActionMoveState).aaClipNr;
+  mInstanceSettings.isAnimSpeedFactor = modSettings.msActionClipMappings.at(mActionMoveState).aaClipSpeed;
   mInstanceSettings.isMoveState = mActionMoveState;
 }
 
@@ -445,7 +452,7 @@ void AssimpInstance::blendIdleWalkRunAnimation(float deltaTime) {
 }
 
 void AssimpInstance::playIdleWalkRunAnimation() {
-  ModelSettings modSettings = mAssimpModel->getModelSettings();
+  const ModelSettings& modSettings = mAssimpModel->getModelSettings();
   IdleWalkRunBlending blend;
 
   /* do not play any animation in preview mode, use values from UI */
@@ -454,13 +461,13 @@ void AssimpInstance::playIdleWalkRunAnimation() {
   }
 
   if (modSettings.msIWRBlendings.count(mInstanceSettings.isMoveDirection) > 0 ) {
-    blend = modSettings.msIWRBlendings[mInstanceSettings.isMoveDirection];
+    blend = modSettings.msIWRBlendings.at(mInstanceSettings.isMoveDirection);
   } else if (modSettings.msIWRBlendings.count(mPrevMoveDirection) > 0 ) {
-    blend = modSettings.msIWRBlendings[mPrevMoveDirection];
+    blend = modSettings.msIWRBlendings.at(mPrevMoveDirection);
   } else if (modSettings.msIWRBlendings.count(moveDirection::any) > 0) {
-    blend = modSettings.msIWRBlendings[moveDirection::any];
+    blend = modSettings.msIWRBlendings.at(moveDirection::any);
   } else if (modSettings.msIWRBlendings.count(moveDirection::none) > 0) {
-    blend = modSettings.msIWRBlendings[moveDirection::none];
+    blend = modSettings.msIWRBlendings.at(moveDirection::none);
   } else {
     /* no animation configured... */
     return;
@@ -540,7 +547,7 @@ void AssimpInstance::setInstanceSettings(InstanceSettings settings) {
   updateModelRootMatrix();
 }
 
-InstanceSettings AssimpInstance::getInstanceSettings() {
+const InstanceSettings& AssimpInstance::getInstanceSettings() {
   return mInstanceSettings;
 }
 int AssimpInstance::getInstanceIndexPosition() {
@@ -586,23 +593,36 @@ void AssimpInstance::setHeadAnim(glm::vec2 leftRightUpDownValues) {
 }
 
 void AssimpInstance::setInstanceOnGround(bool value) {
-  mInstanceSettings.isInstanceOnGround = value;
+  mRuntimeData.irdInstanceOnGround = value;
+}
+
+bool AssimpInstance::isInstanceOnGround() {
+  return mRuntimeData.irdInstanceOnGround;
+}
+
+void AssimpInstance::setCollidingTriangles(const std::vector<int>& collidingTriangles) {
+  /* copy assignment reuses the capacity of the previous frames */
+  mRuntimeData.irdCollidingTriangles = collidingTriangles;
 }
 
-void AssimpInstance::setCollidingTriangles(std::vector<MeshTriangle>& collidingTriangles) {
-  mInstanceSettings.isCollidingTriangles = collidingTriangles;
+const std::vector<int>& AssimpInstance::getCollidingTriangles() {
+  return mRuntimeData.irdCollidingTriangles;
 }
 
 void AssimpInstance::setCurrentGroundTriangleIndex(int index) {
-  mInstanceSettings.isCurrentGroundTriangleIndex = index;
+  mRuntimeData.irdCurrentGroundTriangleIndex = index;
+}
+
+void AssimpInstance::setNeighborGroundTriangleIndices(const std::vector<int>& indices) {
+  mRuntimeData.irdNeighborGroundTriangles = indices;
 }
 
-void AssimpInstance::setNeighborGroundTriangleIndices(std::vector<int> indices) {
-  mInstanceSettings.isNeighborGroundTriangles = indices;
+const std::vector<int>& AssimpInstance::getNeighborGroundTriangleIndices() {
+  return mRuntimeData.irdNeighborGroundTriangles;
 }
 
 int AssimpInstance::getCurrentGroundTriangleIndex() {
-  return mInstanceSettings.isCurrentGroundTriangleIndex;
+  return mRuntimeData.irdCurrentGroundTriangleIndex;
 }
 
 void AssimpInstance::setNavigationEnabled(bool value) {
@@ -614,25 +634,29 @@ bool AssimpInstance::isNavigationEnabled() {
 }
 
 void AssimpInstance::setPathStartTriIndex(int index) {
-  mInstanceSettings.isPathStartTriangleIndex = index;
+  mRuntimeData.irdPathStartTriangleIndex = index;
+}
+
+int AssimpInstance::getPathStartTriIndex() {
+  return mRuntimeData.irdPathStartTriangleIndex;
 }
 
 void AssimpInstance::setPathTargetTriIndex(int index) {
-  mInstanceSettings.isPathTargetTriangleIndex = index;
+  mRuntimeData.irdPathTargetTriangleIndex = index;
 }
 
 int AssimpInstance::getPathTargetTriIndex() {
-  return mInstanceSettings.isPathTargetTriangleIndex;
+  return mRuntimeData.irdPathTargetTriangleIndex;
 }
 
 void AssimpInstance::setPathTargetInstanceId(int index) {
   mInstanceSettings.isPathTargetInstance = index;
 }
 
-void AssimpInstance::setPathToTarget(std::vector<int> indices) {
-  mInstanceSettings.isPathToTarget = indices;
+void AssimpInstance::setPathToTarget(const std::vector<int>& indices) {
+  mRuntimeData.irdPathToTarget = indices;
 }
 
-std::vector<int> AssimpInstance::getPathToTarget() {
-  return mInstanceSettings.isPathToTarget;
+const std::vector<int>& AssimpInstance::getPathToTarget() {
+  return mRuntimeData.irdPathToTarget;
 }
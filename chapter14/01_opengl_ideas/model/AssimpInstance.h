@@ -10,6 +10,7 @@
 #include "AssimpNode.h"
 #include "AssimpBone.h"
 #include "InstanceSettings.h"
+#include "InstanceRuntimeData.h"
 #include "BoundingBox3D.h"
 
 class AssimpInstance {
@@ -33,7 +34,8 @@ class AssimpInstance {
     glm::vec3 get2DRotationVector();
 
     void setInstanceSettings(InstanceSettings settings);
-    InstanceSettings getInstanceSettings();
+    /* reference stays valid as long as the instance lives, copy it before calling setters if you need the old values */
+    const InstanceSettings& getInstanceSettings();
 
     int getInstanceIndexPosition();
     int getInstancePerModelIndexPosition();
@@ -67,27 +69,32 @@ class AssimpInstance {
     void setHeadAnim(glm::vec2 leftRightUpDownValues);
     void applyGravity(float deltaTime);
     void setInstanceOnGround(bool value);
-    void setCollidingTriangles(std::vector<MeshTriangle>& collidingTriangles);
+    bool isInstanceOnGround();
+    void setCollidingTriangles(const std::vector<int>& collidingTriangles);
+    const std::vector<int>& getCollidingTriangles();
 
     void setCurrentGroundTriangleIndex(int index);
     int getCurrentGroundTriangleIndex();
-    void setNeighborGroundTriangleIndices(std::vector<int> indices);
+    void setNeighborGroundTriangleIndices(const std::vector<int>& indices);
+    const std::vector<int>& getNeighborGroundTriangleIndices();
 
     void setNavigationEnabled(bool value);
     bool isNavigationEnabled();
 
     void setPathStartTriIndex(int index);
+    int getPathStartTriIndex();
     void setPathTargetTriIndex(int index);
     int getPathTargetTriIndex();
     void setPathTargetInstanceId(int instanceId);
 
-    void setPathToTarget(std::vector<int> indices);
-    std::vector<int> getPathToTarget();
+    void setPathToTarget(const std::vector<int>& indices);
+    const std::vector<int>& getPathToTarget();
 
   private:
     std::shared_ptr<AssimpModel> mAssimpModel = nullptr;
 
     InstanceSettings mInstanceSettings{};
+    InstanceRuntimeData mRuntimeData{};
 
     glm::mat4 mLocalTranslationMatrix = glm::mat4(1.0f);
     glm::mat4 mLocalRotationMatrix = glm::mat4(1.0f);
@@ -4,7 +4,7 @@
 #include "Tools.h"
 
 bool AssimpMesh::processMesh(aiMesh* mesh, const aiScene* scene, std::string assetDirectory,
-    std::unordered_map<std::string, std::shared_ptr<Texture>>& textures) {
+    std::unordered_map<std::string, std::shared_ptr<Texture>>& textures, bool loadTextures) {
   mMeshName = mesh->mName.C_Str();
 
   mTriangleCount = mesh->mNumFaces;
@@ -52,6 +52,11 @@ bool AssimpMesh::processMesh(aiMesh* mesh, const aiScene* scene, std::string ass
             mMesh.textures.insert({texType, texName});
             texturesFound = true;;
 
+            /* the caller loads the textures later */
+            if (!loadTextures) {
+              continue;
+            }
+
             /* skip already loaded textures */
             if (textures.count(texName) > 0) {
               Logger::log(1, "%s: texture '%s' already loaded, skipping\n", __FUNCTION__, texName.c_str());
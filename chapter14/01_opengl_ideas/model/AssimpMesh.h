@@ -12,8 +12,9 @@
 
 class AssimpMesh {
   public:
+    /* without loadTextures only the texture names are stored, no GL context is needed then */
     bool processMesh(aiMesh* mesh, const aiScene* scene, std::string assetDirectory,
-      std::unordered_map<std::string, std::shared_ptr<Texture>>& textures);
+      std::unordered_map<std::string, std::shared_ptr<Texture>>& textures, bool loadTextures = true);
 
     std::string getMeshName();
     unsigned int getTriangleCount();
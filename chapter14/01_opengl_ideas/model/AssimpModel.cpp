@@ -2,6 +2,8 @@
 #include <chrono>
 #include <cmath>
 #include <filesystem>
+#include <set>
+#include <unordered_set>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -11,15 +13,275 @@
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <assimp/DefaultIOSystem.h>
 
 #include "AssimpModel.h"
 #include "Tools.h"
+#include "Timer.h"
 #include "Logger.h"
 
-bool AssimpModel::loadModel(std::string modelFilename, unsigned int extraImportFlags) {
+namespace {
+  /* glTF and other formats keep the data in more than one file, the model cache must know all of them */
+  class RecordingIOSystem : public Assimp::DefaultIOSystem {
+    public:
+      Assimp::IOStream* Open(const char* fileName, const char* mode) override {
+        Assimp::IOStream* stream = Assimp::DefaultIOSystem::Open(fileName, mode);
+        if (stream) {
+          mOpenedFiles.insert(std::filesystem::path(fileName).lexically_normal().generic_string());
+        }
+        return stream;
+      }
+
+      /* relative to the directory of the model file, like the texture names */
+      std::vector<std::string> getOpenedFiles(std::string modelFileName) {
+        std::filesystem::path modelDirectory = std::filesystem::path(modelFileName).lexically_normal().parent_path();
+
+        std::vector<std::string> openedFiles{};
+        for (const auto& fileName : mOpenedFiles) {
+          std::filesystem::path relativePath = std::filesystem::path(fileName).lexically_relative(modelDirectory);
+          openedFiles.emplace_back(relativePath.empty() ? fileName : relativePath.generic_string());
+        }
+        return openedFiles;
+      }
+
+    private:
+      std::set<std::string> mOpenedFiles{};
+  };
+}
+
+bool AssimpModel::loadModel(std::string modelFilename, TextureManager& textureManager, unsigned int extraImportFlags) {
+  if (!prepareModel(modelFilename, extraImportFlags)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < mTexturesToLoad.size(); ++i) {
+    if (!decodeTexture(i, textureManager)) {
+      return false;
+    }
+  }
+
+  return createGLObjects(textureManager);
+}
+
+bool AssimpModel::prepareModel(std::string modelFilename, unsigned int extraImportFlags) {
   Logger::log(1, "%s: loading model from file '%s'\n", __FUNCTION__, modelFilename.c_str());
 
+  Timer loadTimer{};
+  loadTimer.start();
+
+  /* the textures are stored directly or relative to the model file */
+  std::string assetDirectory = modelFilename.substr(0, modelFilename.find_last_of('/'));
+
+  /* the processed model is stored next to the model file, Assimp is only needed if the model file has changed */
+  std::string cacheFileName = ModelDataCache::getCacheFileName(modelFilename);
+
+  mLoadData = ModelCacheData{};
+  if (ModelDataCache::load(cacheFileName, modelFilename, extraImportFlags, mLoadData)) {
+    restoreModelData(mLoadData);
+    Logger::log(1, "%s: restored model '%s' from cache in %.2f ms (Assimp import took %.2f ms)\n", __FUNCTION__,
+      modelFilename.c_str(), loadTimer.stop(), mLoadData.importTime);
+  } else {
+    /* a rejected cache file may have filled some of the lists */
+    mLoadData = ModelCacheData{};
+    if (!importModel(modelFilename, extraImportFlags, assetDirectory, mLoadData)) {
+      return false;
+    }
+    mLoadData.importTime = loadTimer.stop();
+    Logger::log(1, "%s: imported model '%s' with Assimp in %.2f ms\n", __FUNCTION__, modelFilename.c_str(),
+      mLoadData.importTime);
+
+    mLoadData.sourceKey = ModelDataCache::createKey(modelFilename, mLoadData.sourceFiles, extraImportFlags);
+    ModelDataCache::save(cacheFileName, mLoadData);
+  }
+  mSourceKey = mLoadData.sourceKey;
+
+  /* embedded textures use the index as name */
+  mTexturesToLoad.clear();
+  for (size_t i = 0; i < mLoadData.embeddedTextures.size(); ++i) {
+    const ModelCacheTexture& cacheTexture = mLoadData.embeddedTextures.at(i);
+
+    TextureToLoad texture{};
+    texture.textureName = "*" + std::to_string(i);
+    texture.cacheKey = TextureManager::getDataKey(cacheTexture.data.data(), cacheTexture.data.size());
+    texture.embeddedIndex = static_cast<int>(i);
+    mTexturesToLoad.emplace_back(texture);
+  }
+
+  std::unordered_set<std::string> externalTextureNames{};
+  for (const auto& mesh : mModelMeshes) {
+    for (const auto& meshTexture : mesh.textures) {
+      const std::string& texName = meshTexture.second;
+      if (texName.empty() || texName.find("*") == 0 || externalTextureNames.count(texName) > 0) {
+        continue;
+      }
+      externalTextureNames.insert(texName);
+
+      TextureToLoad texture{};
+      texture.textureName = texName;
+      texture.fileName = assetDirectory + '/' + texName;
+      texture.cacheKey = TextureManager::getFileKey(texture.fileName);
+      mTexturesToLoad.emplace_back(texture);
+    }
+  }
+
+  /* the cache keeps the full lookups, the compression depends on the error setting */
+  mCompressedAnimLookupData.clear();
+  mAnimLookupStats = AnimLookupCompressionStats{};
+  if (mCompressAnimLookups && !mLoadData.animLookupData.empty()) {
+    AnimLookupCompressor::compress(mLoadData.animLookupData, mAnimLookupMaxError, mCompressedAnimLookupData,
+      mAnimLookupStats);
+  } else {
+    mAnimLookupStats.uncompressedSize = mLoadData.animLookupData.size() * sizeof(glm::vec4);
+    mAnimLookupStats.compressedSize = mAnimLookupStats.uncompressedSize;
+  }
+
+  /* the cache keeps the full vertices too, all meshes of a model use the same layout */
+  mPackedMeshVertices.clear();
+  if (mModelSettings.msPackVertices) {
+    bool canPack = std::all_of(mModelMeshes.begin(), mModelMeshes.end(),
+      [](const OGLMesh& mesh) { return VertexPacker::canPack(mesh.vertices); });
+    if (canPack) {
+      for (const auto& mesh : mModelMeshes) {
+        mPackedMeshVertices.emplace_back(VertexPacker::pack(mesh.vertices));
+      }
+    } else {
+      Logger::log(1, "%s: model '%s' has bone ids or positions out of the packed range, using unpacked vertices\n",
+        __FUNCTION__, modelFilename.c_str());
+    }
+  }
+
+  mModelSettings.msModelFilenamePath = modelFilename;
+  mModelSettings.msModelFilename = std::filesystem::path(modelFilename).filename().generic_string();
+
+  if (!mBoneList.empty()) {
+    for (const auto& bone: mBoneList) {
+      mBoneNameList.emplace_back(bone->getBoneName());
+    }
+    mModelSettings.msBoundingSphereAdjustments = std::vector(mBoneList.size(), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+  }
+
+  return true;
+}
+
+size_t AssimpModel::getNumberOfTexturesToLoad() {
+  return mTexturesToLoad.size();
+}
+
+bool AssimpModel::decodeTexture(size_t textureIndex, TextureManager& textureManager) {
+  TextureToLoad& texture = mTexturesToLoad.at(textureIndex);
+
+  /* another model has the same texture */
+  texture.decodeSkipped = textureManager.hasTexture(texture.cacheKey);
+  if (texture.decodeSkipped) {
+    return true;
+  }
+
+  /* the model uses the texture at once, a placeholder is shown until the streaming is done */
+  texture.streamed = textureManager.isStreamingEnabled();
+  if (texture.streamed) {
+    if (texture.embeddedIndex < 0 && !std::filesystem::exists(texture.fileName)) {
+      Logger::log(1, "%s error: could not find texture file '%s', skipping\n", __FUNCTION__, texture.fileName.c_str());
+      texture.streamed = false;
+    }
+    return true;
+  }
+
+  if (texture.embeddedIndex >= 0) {
+    const ModelCacheTexture& cacheTexture = mLoadData.embeddedTextures.at(texture.embeddedIndex);
+    texture.decoded = Texture::decodeTexture(cacheTexture.name, reinterpret_cast<const aiTexel*>(cacheTexture.data.data()),
+      cacheTexture.width, cacheTexture.height, texture.decodedData);
+    /* a broken embedded texture is a broken model file */
+    return texture.decoded;
+  }
+
+  texture.decoded = Texture::decodeTexture(texture.fileName, texture.decodedData);
+  if (!texture.decoded) {
+    Logger::log(1, "%s error: could not load texture file '%s', skipping\n", __FUNCTION__, texture.fileName.c_str());
+  }
+  return true;
+}
+
+bool AssimpModel::createGLObjects(TextureManager& textureManager) {
+  /* add a white texture in case there is no diffuse tex but colors */
+  std::string whiteTexName = "textures/white.png";
+  mWhiteTexture = textureManager.loadTexture(whiteTexName);
+  if (!mWhiteTexture) {
+    Logger::log(1, "%s error: could not load white default texture '%s'\n", __FUNCTION__, whiteTexName.c_str());
+    return false;
+  }
+
+  /* add a placeholder texture in case there is no diffuse tex */
+  std::string placeholderTexName = "textures/missing_tex.png";
+  mPlaceholderTexture = textureManager.loadTexture(placeholderTexName);
+  if (!mPlaceholderTexture) {
+    Logger::log(1, "%s error: could not load placeholder texture '%s'\n", __FUNCTION__, placeholderTexName.c_str());
+    return false;
+  }
+
+  for (size_t i = 0; i < mTexturesToLoad.size(); ++i) {
+    TextureToLoad& texture = mTexturesToLoad.at(i);
+
+    std::shared_ptr<Texture> newTex = textureManager.getTexture(texture.cacheKey);
+    if (!newTex) {
+      /* the shared texture was evicted after the decode was skipped */
+      if (texture.decodeSkipped && !decodeTexture(i, textureManager)) {
+        return false;
+      }
+
+      if (texture.streamed) {
+        textureDecodeFunction decodeFunction;
+        if (texture.embeddedIndex >= 0) {
+          /* copy, the load data is cleared below */
+          ModelCacheTexture cacheTexture = mLoadData.embeddedTextures.at(texture.embeddedIndex);
+          decodeFunction = [cacheTexture](TextureData& decodedData) {
+            return Texture::decodeTexture(cacheTexture.name, reinterpret_cast<const aiTexel*>(cacheTexture.data.data()),
+              cacheTexture.width, cacheTexture.height, decodedData);
+          };
+        } else {
+          std::string fileName = texture.fileName;
+          decodeFunction = [fileName](TextureData& decodedData) {
+            return Texture::decodeTexture(fileName, decodedData);
+          };
+        }
+        newTex = textureManager.streamTexture(texture.cacheKey, decodeFunction);
+      } else {
+        if (!texture.decoded) {
+          continue;
+        }
+
+        newTex = textureManager.addTexture(texture.cacheKey, texture.decodedData);
+        if (!newTex) {
+          return false;
+        }
+      }
+    }
+    mTextures.insert({texture.textureName, newTex});
+  }
+
+  createModelBuffers(mLoadData.animLookupData);
+
+  /* the CPU copies are in the GL objects now */
+  mLoadData = ModelCacheData{};
+  mCompressedAnimLookupData = std::vector<uint32_t>{};
+  mPackedMeshVertices = std::vector<std::vector<OGLPackedVertex>>{};
+  mTexturesToLoad.clear();
+
+  Logger::log(1, "%s: - model has a total of %i texture%s\n", __FUNCTION__, mTextures.size(), mTextures.size() == 1 ? "" : "s");
+  Logger::log(1, "%s: - model has a total of %i bone%s\n", __FUNCTION__, mBoneList.size(), mBoneList.size() == 1 ? "" : "s");
+  Logger::log(1, "%s: - model has a total of %i skeletal animation%s\n", __FUNCTION__, mAnimClips.size(), mAnimClips.size() == 1 ? "" : "s");
+  Logger::log(1, "%s: - model has a total of %i morph animation%s\n", __FUNCTION__, mNumAnimatedMeshes, mNumAnimatedMeshes == 1 ? "" : "s");
+
+  Logger::log(1, "%s: successfully loaded model '%s' (%s)\n", __FUNCTION__, mModelSettings.msModelFilenamePath.c_str(),
+    mModelSettings.msModelFilename.c_str());
+  return true;
+}
+
+bool AssimpModel::importModel(std::string modelFilename, unsigned int extraImportFlags, std::string assetDirectory,
+    ModelCacheData& modelData) {
   Assimp::Importer importer;
+  /* the importer owns and deletes the IO system */
+  RecordingIOSystem* ioSystem = new RecordingIOSystem();
+  importer.SetIOHandler(ioSystem);
   const aiScene *scene = importer.ReadFile(modelFilename, aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_ValidateDataStructure | extraImportFlags);
 
   if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
@@ -27,6 +289,10 @@ bool AssimpModel::loadModel(std::string modelFilename, unsigned int extraImportF
     return false;
   }
 
+  modelData.sourceFiles = ioSystem->getOpenedFiles(modelFilename);
+  Logger::log(1, "%s: import read %i file%s\n", __FUNCTION__, modelData.sourceFiles.size(),
+    modelData.sourceFiles.size() == 1 ? "" : "s");
+
   unsigned int numMeshes = scene->mNumMeshes;
   Logger::log(1, "%s: found %i mesh%s\n", __FUNCTION__, numMeshes, numMeshes == 1 ? "" : "es");
 
@@ -53,38 +319,21 @@ bool AssimpModel::loadModel(std::string modelFilename, unsigned int extraImportF
       int width = scene->mTextures[i]->mWidth;
       aiTexel* data = scene->mTextures[i]->pcData;
 
-      std::shared_ptr<Texture> newTex = std::make_shared<Texture>();
-      if (!newTex->loadTexture(texName, data, width, height)) {
-        return false;
-      }
+      /* compressed images have a height of 0 and the size in bytes as width */
+      ModelCacheTexture cacheTexture{};
+      cacheTexture.name = texName;
+      cacheTexture.width = width;
+      cacheTexture.height = height;
+      const uint8_t* textureBytes = reinterpret_cast<const uint8_t*>(data);
+      cacheTexture.data.assign(textureBytes, textureBytes + (height == 0 ? width : width * height * sizeof(aiTexel)));
+      modelData.embeddedTextures.emplace_back(cacheTexture);
 
-      std::string internalTexName = "*" + std::to_string(i);
-      Logger::log(1, "%s: - added internal texture '%s'\n", __FUNCTION__, internalTexName.c_str());
-      mTextures.insert({internalTexName, newTex});
+      Logger::log(1, "%s: - found internal texture '*%i'\n", __FUNCTION__, i);
     }
 
     Logger::log(1, "%s: scene has %i embedded textures\n", __FUNCTION__, numTextures);
   }
 
-  /* add a white texture in case there is no diffuse tex but colors */
-  mWhiteTexture = std::make_shared<Texture>();
-  std::string whiteTexName = "textures/white.png";
-  if (!mWhiteTexture->loadTexture(whiteTexName)) {
-    Logger::log(1, "%s error: could not load white default texture '%s'\n", __FUNCTION__, whiteTexName.c_str());
-    return false;
-  }
-
-  /* add a placeholder texture in case there is no diffuse tex */
-  mPlaceholderTexture = std::make_shared<Texture>();
-  std::string placeholderTexName = "textures/missing_tex.png";
-  if (!mPlaceholderTexture->loadTexture(placeholderTexName)) {
-    Logger::log(1, "%s error: could not load placeholder texture '%s'\n", __FUNCTION__, placeholderTexName.c_str());
-    return false;
-  }
-
-  /* the textures are stored directly or relative to the model file */
-  std::string assetDirectory = modelFilename.substr(0, modelFilename.find_last_of('/'));
-
   /* nodes */
   Logger::log(1, "%s: ... processing nodes...\n", __FUNCTION__);
 
@@ -127,37 +376,37 @@ bool AssimpModel::loadModel(std::string modelFilename, unsigned int extraImportF
   }
   Logger::log(1, "%s: -- bone parents --\n", __FUNCTION__);
 
-
-  /* create vertex buffers for the meshes */
-  for (const auto& mesh : mModelMeshes) {
-    VertexIndexBuffer buffer;
-    buffer.init();
-    buffer.uploadData(mesh.vertices, mesh.indices);
-    mVertexBuffers.emplace_back(buffer);
+  /* sort the bones by their depth, all parents of a level are in the previous levels */
+  std::vector<int32_t> boneDepths(mBoneParentIndexList.size(), 0);
+  int32_t numberOfLevels = 0;
+  for (size_t i = 0; i < mBoneParentIndexList.size(); ++i) {
+    int32_t parentBone = mBoneParentIndexList.at(i);
+    while (parentBone >= 0) {
+      ++boneDepths.at(i);
+      parentBone = mBoneParentIndexList.at(parentBone);
+    }
+    numberOfLevels = std::max(numberOfLevels, boneDepths.at(i) + 1);
   }
 
-  /* create a SSBOs containing all vertices for all morph animation of this mesh */
-  for (const auto& mesh : mModelMeshes) {
-    if (mesh.morphMeshes.empty()) {
-      continue;
-    }
-    OGLMorphMesh animMesh;
-    animMesh.morphVertices.resize(mesh.vertices.size() * mNumAnimatedMeshes);
+  /* number of levels, start offset of every level plus the end offset, bone ids */
+  mBoneLevelData.clear();
+  mBoneLevelData.emplace_back(numberOfLevels);
+  int32_t levelStart = 0;
+  for (int32_t level = 0; level < numberOfLevels; ++level) {
+    mBoneLevelData.emplace_back(levelStart);
+    levelStart += std::count(boneDepths.begin(), boneDepths.end(), level);
+  }
+  mBoneLevelData.emplace_back(levelStart);
 
-    for (unsigned int i = 0; i < mNumAnimatedMeshes; ++i) {
-      unsigned int vertexOffset = mesh.vertices.size() * i;
-      std::copy(mesh.morphMeshes[i].morphVertices.begin(), mesh.morphMeshes[i].morphVertices.end(),
-        animMesh.morphVertices.begin() + vertexOffset);
-      mAnimatedMeshVertexSize = mesh.vertices.size();
+  for (int32_t level = 0; level < numberOfLevels; ++level) {
+    for (size_t i = 0; i < boneDepths.size(); ++i) {
+      if (boneDepths.at(i) == level) {
+        mBoneLevelData.emplace_back(i);
+      }
     }
-
-    mAnimMeshVerticesBuffer.uploadSsboData(animMesh.morphVertices);
-    Logger::log(1, "%s: model has %i morphs, SSBO has %i vertices\n", __FUNCTION__, mNumAnimatedMeshes, mAnimatedMeshVertexSize);
   }
+  Logger::log(1, "%s: bone hierarchy has %i levels\n", __FUNCTION__, numberOfLevels);
 
-  mShaderBoneMatrixOffsetBuffer.uploadSsboData(mBoneOffsetMatricesList);
-  mShaderInverseBoneMatrixOffsetBuffer.uploadSsboData(mInverseBoneOffsetMatricesList);
-  mShaderBoneParentBuffer.uploadSsboData(mBoneParentIndexList);
 
   /* animations */
   unsigned int numAnims = scene->mNumAnimations;
@@ -209,7 +458,7 @@ bool AssimpModel::loadModel(std::string modelFilename, unsigned int extraImportF
   }
 
   if (!mAnimClips.empty()) {
-    std::vector<glm::vec4> animLookupData{};
+    std::vector<glm::vec4>& animLookupData = modelData.animLookupData;
 
     /* store inverse scaling factor in first element of lookup row */
     const int LOOKUP_SIZE = 1023 + 1;
@@ -223,8 +472,8 @@ bool AssimpModel::loadModel(std::string modelFilename, unsigned int extraImportF
     std::vector<glm::vec4> emptyScaleVector(LOOKUP_SIZE, glm::vec4(1.0f));
     emptyScaleVector.at(0) = glm::vec4(0.0f);
 
-    /* init all transform values with defaults  */
-    for (int i = 0; i < mBoneList.size() * mAnimClips.at(0)->getNumChannels(); ++i) {
+    /* init all transform values with defaults, one row set per bone in every clip */
+    for (size_t i = 0; i < mAnimClips.size() * mBoneList.size(); ++i) {
       animLookupData.insert(animLookupData.end(), emptyTranslateVector.begin(), emptyTranslateVector.end());
       animLookupData.insert(animLookupData.end(), emptyRotateVector.begin(), emptyRotateVector.end());
       animLookupData.insert(animLookupData.end(), emptyScaleVector.begin(), emptyScaleVector.end());
@@ -255,29 +504,144 @@ bool AssimpModel::loadModel(std::string modelFilename, unsigned int extraImportF
     }
 
     Logger::log(1, "%s: generated %i elements of lookup data (%i bytes)\n", __FUNCTION__, animLookupData.size(), animLookupData.size() * sizeof(glm::vec4));
-    mAnimLookupBuffer.uploadSsboData(animLookupData);
   }
 
-  mModelSettings.msModelFilenamePath = modelFilename;
-  mModelSettings.msModelFilename = std::filesystem::path(modelFilename).filename().generic_string();
-
   /* get root transformation matrix from model's root node */
   mRootTransformMatrix = Tools::convertAiToGLM(rootNode->mTransformation);
 
-  if (!mBoneList.empty()) {
-    for (const auto& bone: mBoneList) {
-      mBoneNameList.emplace_back(bone->getBoneName());
+  storeModelData(modelData);
+  return true;
+}
+
+void AssimpModel::storeModelData(ModelCacheData& modelData) {
+  modelData.triangleCount = mTriangleCount;
+  modelData.vertexCount = mVertexCount;
+  modelData.numAnimatedMeshes = mNumAnimatedMeshes;
+  modelData.maxClipDuration = mMaxClipDuration;
+  modelData.rootTransformMatrix = mRootTransformMatrix;
+  modelData.meshes = mModelMeshes;
+
+  /* parents are added before their children, store the parent as index */
+  std::unordered_map<AssimpNode*, int32_t> nodeIndices{};
+  for (const auto& node : mNodeList) {
+    std::shared_ptr<AssimpNode> parentNode = node->getParentNode();
+    modelData.nodeParentIndices.emplace_back(parentNode ? nodeIndices.at(parentNode.get()) : -1);
+    modelData.nodeNames.emplace_back(node->getNodeName());
+    nodeIndices.insert({node.get(), static_cast<int32_t>(nodeIndices.size())});
+  }
+
+  for (const auto& bone : mBoneList) {
+    modelData.boneNames.emplace_back(bone->getBoneName());
+    modelData.boneIds.emplace_back(bone->getBoneId());
+    modelData.boneOffsetMatrices.emplace_back(bone->getOffsetMatrix());
+  }
+  modelData.boneParentIndices = mBoneParentIndexList;
+  modelData.boneLevelData = mBoneLevelData;
+
+  for (const auto& clip : mAnimClips) {
+    modelData.clipNames.emplace_back(clip->getClipName());
+    modelData.clipDurations.emplace_back(clip->getClipDuration());
+    modelData.clipTicksPerSecond.emplace_back(clip->getClipTicksPerSecond());
+  }
+}
+
+void AssimpModel::restoreModelData(const ModelCacheData& modelData) {
+  mTriangleCount = modelData.triangleCount;
+  mVertexCount = modelData.vertexCount;
+  mNumAnimatedMeshes = modelData.numAnimatedMeshes;
+  mMaxClipDuration = modelData.maxClipDuration;
+  mRootTransformMatrix = modelData.rootTransformMatrix;
+  mModelMeshes = modelData.meshes;
+
+  std::vector<std::shared_ptr<AssimpNode>> nodes{};
+  for (size_t i = 0; i < modelData.nodeNames.size(); ++i) {
+    std::shared_ptr<AssimpNode> node = nullptr;
+    if (i == 0) {
+      node = AssimpNode::createNode(modelData.nodeNames.at(i));
+      mRootNode = node;
+    } else {
+      node = nodes.at(modelData.nodeParentIndices.at(i))->addChild(modelData.nodeNames.at(i));
     }
-    mModelSettings.msBoundingSphereAdjustments = std::vector(mBoneList.size(), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+    nodes.emplace_back(node);
+    mNodeMap.insert({modelData.nodeNames.at(i), node});
+    mNodeList.emplace_back(node);
   }
 
-  Logger::log(1, "%s: - model has a total of %i texture%s\n", __FUNCTION__, mTextures.size(), mTextures.size() == 1 ? "" : "s");
-  Logger::log(1, "%s: - model has a total of %i bone%s\n", __FUNCTION__, mBoneList.size(), mBoneList.size() == 1 ? "" : "s");
-  Logger::log(1, "%s: - model has a total of %i skeletal animation%s\n", __FUNCTION__, numAnims, numAnims == 1 ? "" : "s");
-  Logger::log(1, "%s: - model has a total of %i morph animation%s\n", __FUNCTION__, mNumAnimatedMeshes, mNumAnimatedMeshes == 1 ? "" : "s");
+  for (size_t i = 0; i < modelData.boneNames.size(); ++i) {
+    mBoneList.emplace_back(std::make_shared<AssimpBone>(modelData.boneIds.at(i), modelData.boneNames.at(i),
+      modelData.boneOffsetMatrices.at(i)));
+    mBoneOffsetMatricesList.emplace_back(modelData.boneOffsetMatrices.at(i));
+    mInverseBoneOffsetMatricesList.emplace_back(glm::inverse(modelData.boneOffsetMatrices.at(i)));
+  }
+  mBoneParentIndexList = modelData.boneParentIndices;
+  mBoneLevelData = modelData.boneLevelData;
+
+  /* the channels are only needed to create the lookup data */
+  for (size_t i = 0; i < modelData.clipNames.size(); ++i) {
+    std::shared_ptr<AssimpAnimClip> animClip = std::make_shared<AssimpAnimClip>();
+    animClip->setClipName(modelData.clipNames.at(i));
+    animClip->setClipDuration(modelData.clipDurations.at(i));
+    animClip->setClipTicksPerSecond(modelData.clipTicksPerSecond.at(i));
+    mAnimClips.emplace_back(animClip);
+  }
+}
 
-  Logger::log(1, "%s: successfully loaded model '%s' (%s)\n", __FUNCTION__, modelFilename.c_str(), mModelSettings.msModelFilename.c_str());
-  return true;
+void AssimpModel::createModelBuffers(const std::vector<glm::vec4>& animLookupData) {
+  /* create vertex buffers for the meshes */
+  mHasPackedVertices = !mPackedMeshVertices.empty();
+  mVertexBufferSize = 0;
+  for (unsigned int i = 0; i < mModelMeshes.size(); ++i) {
+    const OGLMesh& mesh = mModelMeshes.at(i);
+    VertexIndexBuffer buffer;
+    buffer.init(mHasPackedVertices);
+    if (mHasPackedVertices) {
+      buffer.uploadData(mPackedMeshVertices.at(i), mesh.indices);
+      mVertexBufferSize += mesh.vertices.size() * sizeof(OGLPackedVertex);
+    } else {
+      buffer.uploadData(mesh.vertices, mesh.indices);
+      mVertexBufferSize += mesh.vertices.size() * sizeof(OGLVertex);
+    }
+    mVertexBuffers.emplace_back(buffer);
+  }
+
+  /* indirect draw command templates, the culling shader fills in the instance count */
+  for (const auto& mesh : mModelMeshes) {
+    DrawElementsIndirectCommand command{};
+    command.count = mesh.indices.size();
+    mDrawCommands.emplace_back(command);
+  }
+
+  /* create a SSBOs containing all vertices for all morph animation of this mesh */
+  for (const auto& mesh : mModelMeshes) {
+    if (mesh.morphMeshes.empty()) {
+      continue;
+    }
+    OGLMorphMesh animMesh;
+    animMesh.morphVertices.resize(mesh.vertices.size() * mNumAnimatedMeshes);
+
+    for (unsigned int i = 0; i < mNumAnimatedMeshes; ++i) {
+      unsigned int vertexOffset = mesh.vertices.size() * i;
+      std::copy(mesh.morphMeshes[i].morphVertices.begin(), mesh.morphMeshes[i].morphVertices.end(),
+        animMesh.morphVertices.begin() + vertexOffset);
+      mAnimatedMeshVertexSize = mesh.vertices.size();
+    }
+
+    mAnimMeshVerticesBuffer.uploadSsboData(animMesh.morphVertices);
+    Logger::log(1, "%s: model has %i morphs, SSBO has %i vertices\n", __FUNCTION__, mNumAnimatedMeshes, mAnimatedMeshVertexSize);
+  }
+
+  mShaderBoneMatrixOffsetBuffer.uploadSsboData(mBoneOffsetMatricesList);
+  mShaderInverseBoneMatrixOffsetBuffer.uploadSsboData(mInverseBoneOffsetMatricesList);
+  mShaderBoneParentBuffer.uploadSsboData(mBoneParentIndexList);
+  mShaderBoneLevelBuffer.uploadSsboData(mBoneLevelData);
+
+  mHasCompressedAnimLookups = !mCompressedAnimLookupData.empty();
+  if (mHasCompressedAnimLookups) {
+    mAnimLookupBuffer.uploadSsboData(mCompressedAnimLookupData);
+  } else if (!animLookupData.empty()) {
+    mAnimLookupBuffer.uploadSsboData(animLookupData);
+  }
 }
 
 void AssimpModel::processNode(std::shared_ptr<AssimpNode> node, aiNode* aNode, const aiScene* scene, std::string assetDirectory) {
@@ -291,7 +655,7 @@ void AssimpModel::processNode(std::shared_ptr<AssimpNode> node, aiNode* aNode, c
       aiMesh* modelMesh = scene->mMeshes[aNode->mMeshes[i]];
 
       AssimpMesh mesh;
-      mesh.processMesh(modelMesh, scene, assetDirectory, mTextures);
+      mesh.processMesh(modelMesh, scene, assetDirectory, mTextures, false);
       OGLMesh vertexMesh = mesh.getMesh();
       mNumAnimatedMeshes += vertexMesh.morphMeshes.size();
 
@@ -396,6 +760,48 @@ void AssimpModel::drawInstancedMorphAnims(int instanceCount) {
 }
 
 void AssimpModel::drawInstanced(OGLMesh& mesh, unsigned int meshIndex, int instanceCount) {
+  std::shared_ptr<Texture> diffuseTex = bindMeshTexture(mesh);
+  mVertexBuffers.at(meshIndex).bindAndDrawIndirectInstanced(GL_TRIANGLES, mesh.indices.size(), instanceCount);
+  unbindMeshTexture(mesh, diffuseTex);
+}
+
+void AssimpModel::drawInstancedIndirect() {
+  for (unsigned int i = 0; i < mModelMeshes.size(); ++i) {
+    OGLMesh& mesh = mModelMeshes.at(i);
+    drawInstancedIndirect(mesh, i);
+  }
+}
+
+void AssimpModel::drawInstancedIndirectNoMorphAnims() {
+  for (unsigned int i = 0; i < mModelMeshes.size(); ++i) {
+    /* skip meshes with morph animations */
+    if (!mModelMeshes.at(i).morphMeshes.empty()) {
+      continue;
+    }
+    OGLMesh& mesh = mModelMeshes.at(i);
+    drawInstancedIndirect(mesh, i);
+  }
+}
+
+void AssimpModel::drawInstancedIndirectMorphAnims() {
+  for (unsigned int i = 0; i < mModelMeshes.size(); ++i) {
+    /* draw only meshes with morph animations */
+    if (mModelMeshes.at(i).morphMeshes.empty()) {
+      continue;
+    }
+    OGLMesh& mesh = mModelMeshes.at(i);
+    drawInstancedIndirect(mesh, i);
+  }
+}
+
+void AssimpModel::drawInstancedIndirect(OGLMesh& mesh, unsigned int meshIndex) {
+  std::shared_ptr<Texture> diffuseTex = bindMeshTexture(mesh);
+  /* one command per mesh */
+  mVertexBuffers.at(meshIndex).bindAndDrawIndirectCommand(GL_TRIANGLES, meshIndex * sizeof(DrawElementsIndirectCommand));
+  unbindMeshTexture(mesh, diffuseTex);
+}
+
+std::shared_ptr<Texture> AssimpModel::bindMeshTexture(OGLMesh& mesh) {
   // find diffuse texture by name
   std::shared_ptr<Texture> diffuseTex = nullptr;
   auto diffuseTexName = mesh.textures.find(aiTextureType_DIFFUSE);
@@ -417,8 +823,10 @@ void AssimpModel::drawInstanced(OGLMesh& mesh, unsigned int meshIndex, int insta
     }
   }
 
-  mVertexBuffers.at(meshIndex).bindAndDrawIndirectInstanced(GL_TRIANGLES, mesh.indices.size(), instanceCount);
+  return diffuseTex;
+}
 
+void AssimpModel::unbindMeshTexture(OGLMesh& mesh, std::shared_ptr<Texture> diffuseTex) {
   if (diffuseTex) {
     diffuseTex->unbind();
   } else {
@@ -430,6 +838,10 @@ void AssimpModel::drawInstanced(OGLMesh& mesh, unsigned int meshIndex, int insta
   }
 }
 
+const std::vector<DrawElementsIndirectCommand>& AssimpModel::getDrawCommands() {
+  return mDrawCommands;
+}
+
 unsigned int AssimpModel::getTriangleCount() {
   return mTriangleCount;
 }
@@ -439,18 +851,10 @@ void AssimpModel::cleanup() {
     buffer.cleanup();
   }
 
-  for (auto& tex : mTextures) {
-    tex.second->cleanup();
-  }
-
-  /* empty for null model */
-  if (mPlaceholderTexture) {
-    mPlaceholderTexture->cleanup();
-  }
-
-  if (mWhiteTexture) {
-    mWhiteTexture->cleanup();
-  }
+  /* the textures are shared, the texture manager deletes them if no model uses them anymore */
+  mTextures.clear();
+  mPlaceholderTexture.reset();
+  mWhiteTexture.reset();
 }
 
 std::string AssimpModel::getModelFileName() {
@@ -493,10 +897,43 @@ void AssimpModel::bindBoneParentBuffer(int bindingPoint) {
   mShaderBoneParentBuffer.bind(bindingPoint);
 }
 
+void AssimpModel::bindBoneLevelBuffer(int bindingPoint) {
+  mShaderBoneLevelBuffer.bind(bindingPoint);
+}
+
 void AssimpModel::bindAnimLookupBuffer(int bindingPoint) {
   mAnimLookupBuffer.bind(bindingPoint);
 }
 
+void AssimpModel::setAnimLookupCompression(bool enable, float maxError) {
+  mCompressAnimLookups = enable;
+  mAnimLookupMaxError = maxError;
+}
+
+bool AssimpModel::hasCompressedAnimLookups() {
+  return mHasCompressedAnimLookups;
+}
+
+AnimLookupCompressionStats AssimpModel::getAnimLookupStats() {
+  return mAnimLookupStats;
+}
+
+void AssimpModel::setPackedVertices(bool enable) {
+  mModelSettings.msPackVertices = enable;
+}
+
+bool AssimpModel::hasPackedVertices() {
+  return mHasPackedVertices;
+}
+
+size_t AssimpModel::getVertexBufferSize() {
+  return mVertexBufferSize;
+}
+
+uint64_t AssimpModel::getSourceKey() {
+  return mSourceKey;
+}
+
 std::vector<int32_t> AssimpModel::getBoneParentIndexList() {
   return mBoneParentIndexList;
 }
@@ -505,7 +942,7 @@ void AssimpModel::setModelSettings(ModelSettings settings) {
   mModelSettings = settings;
 }
 
-ModelSettings AssimpModel::getModelSettings() {
+const ModelSettings& AssimpModel::getModelSettings() {
   return mModelSettings;
 }
 
@@ -517,7 +954,7 @@ void AssimpModel::setAABBLookup(std::vector<std::vector<AABB>> lookupData) {
   mAabbLookups = lookupData;
 }
 
-AABB AssimpModel::getAABB(InstanceSettings instSettings) {
+AABB AssimpModel::getAABB(const InstanceSettings& instSettings) {
   if (hasAnimations()) {
     return getAnimatedAABB(instSettings);
   } else {
@@ -525,7 +962,7 @@ AABB AssimpModel::getAABB(InstanceSettings instSettings) {
   }
 }
 
-AABB AssimpModel::getAnimatedAABB(InstanceSettings instSettings) {
+AABB AssimpModel::getAnimatedAABB(const InstanceSettings& instSettings) {
   const int LOOKUP_SIZE = 1023;
 
   float timeScaleFactor = mMaxClipDuration / static_cast<float>(LOOKUP_SIZE);
@@ -601,7 +1038,7 @@ AABB AssimpModel::getAnimatedAABB(InstanceSettings instSettings) {
   return translatedAabb;
 }
 
-AABB AssimpModel::getNonAnimatedAABB(InstanceSettings instSettings) {
+AABB AssimpModel::getNonAnimatedAABB(const InstanceSettings& instSettings) {
   glm::mat4 localScaleMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(instSettings.isScale));
 
   glm::mat4 localSwapAxisMatrix;
@@ -9,6 +9,9 @@
 #include <glm/glm.hpp>
 
 #include "Texture.h"
+#include "TextureManager.h"
+#include "AnimLookupCompressor.h"
+#include "VertexPacker.h"
 #include "AssimpMesh.h"
 #include "AssimpNode.h"
 #include "AssimpAnimClip.h"
@@ -17,22 +20,39 @@
 #include "ModelSettings.h"
 #include "InstanceSettings.h"
 #include "AABB.h"
+#include "ModelDataCache.h"
 
 #include "OGLRenderData.h"
 
 class AssimpModel {
   public:
-    bool loadModel(std::string modelFilename, unsigned int extraImportFlags = 0);
+    bool loadModel(std::string modelFilename, TextureManager& textureManager, unsigned int extraImportFlags = 0);
+
+    /* split loading, prepareModel() and decodeTexture() need no GL context and may run on other threads */
+    bool prepareModel(std::string modelFilename, unsigned int extraImportFlags = 0);
+    size_t getNumberOfTexturesToLoad();
+    /* different textures may be decoded in parallel */
+    bool decodeTexture(size_t textureIndex, TextureManager& textureManager);
+    /* textures and buffers, must run on the GL thread */
+    bool createGLObjects(TextureManager& textureManager);
     glm::mat4 getRootTranformationMatrix();
 
     void draw();
     void drawInstanced(int instanceCount);
     void drawInstancedNoMorphAnims(int instanceCount);
     void drawInstancedMorphAnims(int instanceCount);
+
+    /* instance counts come from the GL_DRAW_INDIRECT_BUFFER, one command per mesh */
+    void drawInstancedIndirect();
+    void drawInstancedIndirectNoMorphAnims();
+    void drawInstancedIndirectMorphAnims();
+    const std::vector<DrawElementsIndirectCommand>& getDrawCommands();
     unsigned int getTriangleCount();
 
     std::string getModelFileName();
     std::string getModelFileNamePath();
+    /* hash of all files of the model and the import flags, for caches of data derived from the model */
+    uint64_t getSourceKey();
 
     bool hasAnimations();
     const std::vector<std::shared_ptr<AssimpAnimClip>>& getAnimClips();
@@ -46,17 +66,30 @@ class AssimpModel {
 
     void bindBoneMatrixOffsetBuffer(int bindingPoint);
     void bindBoneParentBuffer(int bindingPoint);
+    void bindBoneLevelBuffer(int bindingPoint);
     void bindAnimLookupBuffer(int bindingPoint);
 
+    /* call before prepareModel(), the lookups are compressed while the model is prepared */
+    void setAnimLookupCompression(bool enable, float maxError);
+    /* the transform shader needs the matching decode path */
+    bool hasCompressedAnimLookups();
+    AnimLookupCompressionStats getAnimLookupStats();
+
+    /* call before prepareModel(), stored in the model settings, models with more than 256 bones keep the unpacked vertices */
+    void setPackedVertices(bool enable);
+    /* the vertex shaders need the matching attribute decode */
+    bool hasPackedVertices();
+    size_t getVertexBufferSize();
+
     std::vector<int32_t> getBoneParentIndexList();
 
     void setModelSettings(ModelSettings settings);
-    ModelSettings getModelSettings();
+    const ModelSettings& getModelSettings();
 
     void setAABBLookup(std::vector<std::vector<AABB>> lookupData);
-    AABB getAABB(InstanceSettings instSettings);
-    AABB getAnimatedAABB(InstanceSettings instSettings);
-    AABB getNonAnimatedAABB(InstanceSettings instSettings);
+    AABB getAABB(const InstanceSettings& instSettings);
+    AABB getAnimatedAABB(const InstanceSettings& instSettings);
+    AABB getNonAnimatedAABB(const InstanceSettings& instSettings);
 
     bool hasAnimMeshes();
     unsigned int getAnimMeshVertexSize();
@@ -75,9 +108,19 @@ class AssimpModel {
     void cleanup();
 
 private:
+    /* full Assimp import, fills the cache data too */
+    bool importModel(std::string modelFilename, unsigned int extraImportFlags, std::string assetDirectory,
+      ModelCacheData& modelData);
+    void storeModelData(ModelCacheData& modelData);
+    void restoreModelData(const ModelCacheData& modelData);
+    void createModelBuffers(const std::vector<glm::vec4>& animLookupData);
+
     void processNode(std::shared_ptr<AssimpNode> node, aiNode* aNode, const aiScene* scene, std::string assetDirectory);
     void createNodeList(std::shared_ptr<AssimpNode> node, std::shared_ptr<AssimpNode> newNode, std::vector<std::shared_ptr<AssimpNode>> &list);
     void drawInstanced(OGLMesh& mesh, unsigned int meshIndex, int instanceCount);
+    void drawInstancedIndirect(OGLMesh& mesh, unsigned int meshIndex);
+    std::shared_ptr<Texture> bindMeshTexture(OGLMesh& mesh);
+    void unbindMeshTexture(OGLMesh& mesh, std::shared_ptr<Texture> diffuseTex);
 
     unsigned int mTriangleCount = 0;
     unsigned int mVertexCount = 0;
@@ -101,13 +144,46 @@ private:
 
     std::vector<OGLMesh> mModelMeshes{};
     std::vector<VertexIndexBuffer> mVertexBuffers{};
+    std::vector<DrawElementsIndirectCommand> mDrawCommands{};
 
     ShaderStorageBuffer mShaderBoneParentBuffer{};
     std::vector<int32_t> mBoneParentIndexList{};
+    ShaderStorageBuffer mShaderBoneLevelBuffer{};
+    std::vector<int32_t> mBoneLevelData{};
     ShaderStorageBuffer mShaderBoneMatrixOffsetBuffer{};
     ShaderStorageBuffer mShaderInverseBoneMatrixOffsetBuffer{};
     ShaderStorageBuffer mAnimLookupBuffer{};
 
+    bool mCompressAnimLookups = false;
+    float mAnimLookupMaxError = 0.001f;
+    bool mHasCompressedAnimLookups = false;
+    AnimLookupCompressionStats mAnimLookupStats{};
+
+    bool mHasPackedVertices = false;
+    size_t mVertexBufferSize = 0;
+
+    uint64_t mSourceKey = 0;
+
+    struct TextureToLoad {
+      std::string textureName;
+      std::string fileName;
+      std::string cacheKey;
+      /* index into the embedded textures, -1 for files */
+      int embeddedIndex = -1;
+      bool decoded = false;
+      /* the texture manager had the texture already */
+      bool decodeSkipped = false;
+      /* the texture manager decodes and uploads the texture in the background */
+      bool streamed = false;
+      TextureData decodedData{};
+    };
+
+    /* CPU side data between prepareModel() and createGLObjects() */
+    ModelCacheData mLoadData{};
+    std::vector<uint32_t> mCompressedAnimLookupData{};
+    std::vector<std::vector<OGLPackedVertex>> mPackedMeshVertices{};
+    std::vector<TextureToLoad> mTexturesToLoad{};
+
     // map textures to external or internal texture names
     std::unordered_map<std::string, std::shared_ptr<Texture>> mTextures{};
     std::shared_ptr<Texture> mPlaceholderTexture = nullptr;
@@ -0,0 +1,16 @@
+/* per-frame collision and navigation state of an instance, never saved or restored by undo/redo */
+#pragma once
+
+#include <vector>
+
+struct InstanceRuntimeData {
+  bool irdInstanceOnGround = false;
+  /* indices into the level triangle BVH */
+  std::vector<int> irdCollidingTriangles{};
+  int irdCurrentGroundTriangleIndex = -1;
+  std::vector<int> irdNeighborGroundTriangles{};
+
+  int irdPathStartTriangleIndex = -1;
+  int irdPathTargetTriangleIndex = -1;
+  std::vector<int> irdPathToTarget{};
+};
@@ -8,8 +8,6 @@
 
 #include "Enums.h"
 
-struct MeshTriangle;
-
 struct InstanceSettings {
   std::string isModelFile;
 
@@ -43,16 +41,8 @@ struct InstanceSettings {
   faceAnimation isFaceAnimType = faceAnimation::none;
   float isFaceAnimWeight = 0.0f;
 
-  bool isInstanceOnGround = false;
-  std::vector<MeshTriangle> isCollidingTriangles{};
-  int isCurrentGroundTriangleIndex = -1;
-  std::vector<int> isNeighborGroundTriangles{};
-
   bool isNavigationEnabled = false;
   int isPathTargetInstance = -1;
-  int isPathStartTriangleIndex = -1;
-  int isPathTargetTriangleIndex = -1;
-  std::vector<int> isPathToTarget{};
 };
 
 /* temporary struct to catch the camera names from the save file */
@@ -24,6 +24,14 @@ struct ActionAnimation {
   float aaClipSpeed = 1.0f;
 };
 
+/* instances farther away than the distance get new bone matrices only every n-th frame */
+struct AnimationLodTier {
+  float altMinDistance = 0.0f;
+  int altUpdateInterval = 1;
+  /* only the bones up to msReducedSkeletonDepth are animated, deeper bones keep their last pose */
+  bool altReducedSkeleton = false;
+};
+
 struct ModelSettings {
   std::string msModelFilenamePath;
   std::string msModelFilename;
@@ -43,7 +51,15 @@ struct ModelSettings {
   std::array<std::pair<int, int>, 2> msFootIKChainPair{};
   std::array<std::vector<int>, 2> msFootIKChainNodes{};
 
+  /* first tier is used for the near instances, the distance of it is ignored */
+  bool msUseAnimationLod = false;
+  std::array<AnimationLodTier, 3> msAnimationLodTiers{{ { 0.0f, 1, false }, { 30.0f, 2, false }, { 60.0f, 4, true } }};
+  int msReducedSkeletonDepth = 4;
+
   bool msUseAsNavigationTarget = false;
 
+  /* half float positions, octahedral normals and byte bone data, applied when the model is loaded */
+  bool msPackVertices = false;
+
   bool msPreviewMode = false;
 };
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+
+#include "InstanceGrid.h"
+#include "Logger.h"
+
+void InstanceGrid::setCellSize(float cellSize) {
+  if (cellSize <= 0.0f) {
+    Logger::log(1, "%s error: invalid cell size %f\n", __FUNCTION__, cellSize);
+    return;
+  }
+
+  if (cellSize == mCellSize) {
+    return;
+  }
+
+  mCellSize = cellSize;
+  clear();
+}
+
+float InstanceGrid::getCellSize() {
+  return mCellSize;
+}
+
+int64_t InstanceGrid::getCellKey(int cellX, int cellZ) {
+  return (static_cast<int64_t>(cellX) << 32) | static_cast<uint32_t>(cellZ);
+}
+
+glm::ivec2 InstanceGrid::getCell(glm::vec3 pos) {
+  return glm::ivec2(static_cast<int>(std::floor(pos.x / mCellSize)), static_cast<int>(std::floor(pos.z / mCellSize)));
+}
+
+void InstanceGrid::addToCells(int instanceId, const GridEntry& entry) {
+  for (int x = entry.minCell.x; x <= entry.maxCell.x; ++x) {
+    for (int z = entry.minCell.y; z <= entry.maxCell.y; ++z) {
+      mCells[getCellKey(x, z)].emplace_back(instanceId);
+    }
+  }
+}
+
+void InstanceGrid::removeFromCells(int instanceId, const GridEntry& entry) {
+  for (int x = entry.minCell.x; x <= entry.maxCell.x; ++x) {
+    for (int z = entry.minCell.y; z <= entry.maxCell.y; ++z) {
+      auto cellIter = mCells.find(getCellKey(x, z));
+      if (cellIter == mCells.end()) {
+        continue;
+      }
+
+      /* order inside a cell does not matter */
+      std::vector<int>& cellInstances = cellIter->second;
+      auto instanceIter = std::find(cellInstances.begin(), cellInstances.end(), instanceId);
+      if (instanceIter != cellInstances.end()) {
+        *instanceIter = cellInstances.back();
+        cellInstances.pop_back();
+      }
+    }
+  }
+}
+
+void InstanceGrid::update(int instanceId, const BoundingBox3D& box) {
+  if (instanceId < 0) {
+    return;
+  }
+
+  if (instanceId >= static_cast<int>(mEntries.size())) {
+    mEntries.resize(instanceId + 1);
+  }
+
+  GridEntry& entry = mEntries.at(instanceId);
+  entry.minPos = box.getFrontTopLeft();
+  entry.maxPos = box.getFrontTopLeft() + box.getSize();
+
+  glm::ivec2 minCell = getCell(entry.minPos);
+  glm::ivec2 maxCell = getCell(entry.maxPos);
+  if (entry.inGrid && minCell == entry.minCell && maxCell == entry.maxCell) {
+    return;
+  }
+
+  if (entry.inGrid) {
+    removeFromCells(instanceId, entry);
+  }
+
+  entry.minCell = minCell;
+  entry.maxCell = maxCell;
+  entry.inGrid = true;
+  addToCells(instanceId, entry);
+
+  mNumberOfRebucketedInstances++;
+}
+
+void InstanceGrid::remove(int instanceId) {
+  if (instanceId < 0 || instanceId >= static_cast<int>(mEntries.size())) {
+    return;
+  }
+
+  GridEntry& entry = mEntries.at(instanceId);
+  if (!entry.inGrid) {
+    return;
+  }
+
+  removeFromCells(instanceId, entry);
+  entry.inGrid = false;
+}
+
+void InstanceGrid::clear() {
+  mEntries.clear();
+  mCells.clear();
+}
+
+void InstanceGrid::query(const BoundingBox3D& box, std::vector<int>& instanceIds) {
+  glm::vec3 queryMin = box.getFrontTopLeft();
+  glm::vec3 queryMax = queryMin + box.getSize();
+  glm::ivec2 minCell = getCell(queryMin);
+  glm::ivec2 maxCell = getCell(queryMax);
+
+  /* instances spanning several cells are reported once */
+  mQueryStamp++;
+
+  for (int x = minCell.x; x <= maxCell.x; ++x) {
+    for (int z = minCell.y; z <= maxCell.y; ++z) {
+      auto cellIter = mCells.find(getCellKey(x, z));
+      if (cellIter == mCells.end()) {
+        continue;
+      }
+
+      for (const auto instanceId : cellIter->second) {
+        GridEntry& entry = mEntries[instanceId];
+        if (entry.queryStamp == mQueryStamp) {
+          continue;
+        }
+        entry.queryStamp = mQueryStamp;
+
+        /* same test as BoundingBox3D::intersects() */
+        if (entry.minPos.x >= queryMax.x || queryMin.x >= entry.maxPos.x ||
+            entry.minPos.y >= queryMax.y || queryMin.y >= entry.maxPos.y ||
+            entry.minPos.z >= queryMax.z || queryMin.z >= entry.maxPos.z) {
+          continue;
+        }
+        instanceIds.emplace_back(instanceId);
+      }
+    }
+  }
+}
+
+void InstanceGrid::findAllIntersections(std::vector<std::pair<int, int>>& instancePairs) {
+  instancePairs.clear();
+
+  for (const auto& cell : mCells) {
+    const std::vector<int>& cellInstances = cell.second;
+    if (cellInstances.size() < 2) {
+      continue;
+    }
+
+    int cellX = static_cast<int>(cell.first >> 32);
+    int cellZ = static_cast<int32_t>(cell.first & 0xffffffff);
+
+    for (size_t i = 0; i < cellInstances.size(); ++i) {
+      const GridEntry& first = mEntries[cellInstances[i]];
+      for (size_t j = i + 1; j < cellInstances.size(); ++j) {
+        const GridEntry& second = mEntries[cellInstances[j]];
+
+        /* a pair sharing several cells is only tested in the first shared cell */
+        if (std::max(first.minCell.x, second.minCell.x) != cellX ||
+            std::max(first.minCell.y, second.minCell.y) != cellZ) {
+          continue;
+        }
+
+        mNumberOfPairTests++;
+        if (first.minPos.x >= second.maxPos.x || second.minPos.x >= first.maxPos.x ||
+            first.minPos.y >= second.maxPos.y || second.minPos.y >= first.maxPos.y ||
+            first.minPos.z >= second.maxPos.z || second.minPos.z >= first.maxPos.z) {
+          continue;
+        }
+
+        instancePairs.emplace_back(std::minmax(cellInstances[i], cellInstances[j]));
+      }
+    }
+  }
+
+  /* the cell order of the hash map is random, keep the event order stable */
+  std::sort(instancePairs.begin(), instancePairs.end());
+}
+
+void InstanceGrid::resetCounters() {
+  mNumberOfRebucketedInstances = 0;
+  mNumberOfPairTests = 0;
+}
+
+int InstanceGrid::getNumberOfRebucketedInstances() {
+  return mNumberOfRebucketedInstances;
+}
+
+int InstanceGrid::getNumberOfPairTests() {
+  return mNumberOfPairTests;
+}
@@ -0,0 +1,60 @@
+/* hashed uniform grid on the XZ plane for the instance broadphase, updated incrementally */
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "BoundingBox3D.h"
+
+class InstanceGrid {
+  public:
+    /* a new cell size removes all instances */
+    void setCellSize(float cellSize);
+    float getCellSize();
+
+    /* adds the instance or moves it, the cells are only touched if the box crossed a cell border */
+    void update(int instanceId, const BoundingBox3D& box);
+    void remove(int instanceId);
+    void clear();
+
+    /* appends every instance id once */
+    void query(const BoundingBox3D& box, std::vector<int>& instanceIds);
+    /* every overlapping pair once as (smaller id, larger id), sorted */
+    void findAllIntersections(std::vector<std::pair<int, int>>& instancePairs);
+
+    void resetCounters();
+    int getNumberOfRebucketedInstances();
+    int getNumberOfPairTests();
+
+  private:
+    struct GridEntry {
+      glm::vec3 minPos = glm::vec3(0.0f);
+      glm::vec3 maxPos = glm::vec3(0.0f);
+      /* cell range on X and Z, both inclusive */
+      glm::ivec2 minCell = glm::ivec2(0);
+      glm::ivec2 maxCell = glm::ivec2(0);
+      bool inGrid = false;
+      unsigned int queryStamp = 0;
+    };
+
+    int64_t getCellKey(int cellX, int cellZ);
+    glm::ivec2 getCell(glm::vec3 pos);
+
+    void addToCells(int instanceId, const GridEntry& entry);
+    void removeFromCells(int instanceId, const GridEntry& entry);
+
+    float mCellSize = 4.0f;
+
+    /* indexed by the instance id, the ids are dense */
+    std::vector<GridEntry> mEntries{};
+    /* empty cells are kept, the vectors keep their capacity */
+    std::unordered_map<int64_t, std::vector<int>> mCells{};
+
+    unsigned int mQueryStamp = 0;
+
+    int mNumberOfRebucketedInstances = 0;
+    int mNumberOfPairTests = 0;
+};
@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include "InstanceSweepAndPrune.h"
+
+void InstanceSweepAndPrune::update(int instanceId, const BoundingBox3D& box) {
+  if (instanceId < 0) {
+    return;
+  }
+
+  if (instanceId >= static_cast<int>(mEntries.size())) {
+    mEntries.resize(instanceId + 1);
+  }
+
+  SweepEntry& entry = mEntries.at(instanceId);
+  entry.minPos = box.getFrontTopLeft();
+  entry.maxPos = box.getFrontTopLeft() + box.getSize();
+
+  /* new endpoints are appended and moved to their place by the next sort */
+  if (!entry.inList) {
+    entry.inList = true;
+
+    SweepEndpoint endpoint{};
+    endpoint.instanceId = instanceId;
+    endpoint.isMax = false;
+    mEndpointsX.emplace_back(endpoint);
+    mEndpointsZ.emplace_back(endpoint);
+    endpoint.isMax = true;
+    mEndpointsX.emplace_back(endpoint);
+    mEndpointsZ.emplace_back(endpoint);
+  }
+}
+
+void InstanceSweepAndPrune::clear() {
+  mEntries.clear();
+  mEndpointsX.clear();
+  mEndpointsZ.clear();
+  mOverlappingPairs.clear();
+}
+
+bool InstanceSweepAndPrune::isBefore(const SweepEndpoint& first, const SweepEndpoint& second) {
+  /* boxes only touching do not intersect (see BoundingBox3D::intersects()), put the max endpoint first */
+  return first.value < second.value || (first.value == second.value && first.isMax && !second.isMax);
+}
+
+bool InstanceSweepAndPrune::overlapsXZ(int firstId, int secondId) {
+  const SweepEntry& first = mEntries[firstId];
+  const SweepEntry& second = mEntries[secondId];
+
+  mNumberOfPairTests++;
+  return first.minPos.x < second.maxPos.x && second.minPos.x < first.maxPos.x &&
+         first.minPos.z < second.maxPos.z && second.minPos.z < first.maxPos.z;
+}
+
+uint64_t InstanceSweepAndPrune::getPairKey(int firstId, int secondId) {
+  auto [smallerId, largerId] = std::minmax(firstId, secondId);
+  return (static_cast<uint64_t>(smallerId) << 32) | static_cast<uint32_t>(largerId);
+}
+
+void InstanceSweepAndPrune::sortAxis(std::vector<SweepEndpoint>& endpoints, int axis) {
+  for (auto& endpoint : endpoints) {
+    const SweepEntry& entry = mEntries[endpoint.instanceId];
+    endpoint.value = endpoint.isMax ? entry.maxPos[axis] : entry.minPos[axis];
+  }
+
+  /* the instances move only a bit per frame, the insertion sort does only a few swaps */
+  for (size_t i = 1; i < endpoints.size(); ++i) {
+    SweepEndpoint current = endpoints[i];
+    size_t j = i;
+    while (j > 0 && isBefore(current, endpoints[j - 1])) {
+      const SweepEndpoint& passed = endpoints[j - 1];
+      mNumberOfEndpointSwaps++;
+
+      if (current.instanceId == passed.instanceId) {
+        /* inverted box, nothing to report */
+      } else if (!current.isMax && passed.isMax) {
+        /* start passed an end, the boxes may overlap now */
+        if (overlapsXZ(current.instanceId, passed.instanceId)) {
+          mOverlappingPairs.insert(getPairKey(current.instanceId, passed.instanceId));
+        }
+      } else if (current.isMax && !passed.isMax) {
+        /* end passed a start, the boxes are separated on this axis */
+        mOverlappingPairs.erase(getPairKey(current.instanceId, passed.instanceId));
+      }
+
+      endpoints[j] = passed;
+      --j;
+    }
+    endpoints[j] = current;
+  }
+}
+
+void InstanceSweepAndPrune::findAllIntersections(std::vector<std::pair<int, int>>& instancePairs) {
+  instancePairs.clear();
+
+  sortAxis(mEndpointsX, 0);
+  sortAxis(mEndpointsZ, 2);
+
+  for (const auto pairKey : mOverlappingPairs) {
+    int firstId = static_cast<int>(pairKey >> 32);
+    int secondId = static_cast<int>(pairKey & 0xffffffff);
+    const SweepEntry& first = mEntries[firstId];
+    const SweepEntry& second = mEntries[secondId];
+
+    mNumberOfPairTests++;
+    if (first.minPos.y >= second.maxPos.y || second.minPos.y >= first.maxPos.y) {
+      continue;
+    }
+    instancePairs.emplace_back(firstId, secondId);
+  }
+
+  /* the order of the hash set is random, keep the event order stable */
+  std::sort(instancePairs.begin(), instancePairs.end());
+}
+
+void InstanceSweepAndPrune::resetCounters() {
+  mNumberOfEndpointSwaps = 0;
+  mNumberOfPairTests = 0;
+}
+
+int InstanceSweepAndPrune::getNumberOfEndpointSwaps() {
+  return mNumberOfEndpointSwaps;
+}
+
+int InstanceSweepAndPrune::getNumberOfPairTests() {
+  return mNumberOfPairTests;
+}
@@ -0,0 +1,54 @@
+/* persistent sweep and prune broadphase, the endpoint lists on X and Z stay sorted between the frames */
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include <utility>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "BoundingBox3D.h"
+
+class InstanceSweepAndPrune {
+  public:
+    /* only stores the box, the lists are sorted in findAllIntersections() */
+    void update(int instanceId, const BoundingBox3D& box);
+    void clear();
+
+    /* every overlapping pair once as (smaller id, larger id), sorted */
+    void findAllIntersections(std::vector<std::pair<int, int>>& instancePairs);
+
+    void resetCounters();
+    int getNumberOfEndpointSwaps();
+    int getNumberOfPairTests();
+
+  private:
+    struct SweepEntry {
+      glm::vec3 minPos = glm::vec3(0.0f);
+      glm::vec3 maxPos = glm::vec3(0.0f);
+      bool inList = false;
+    };
+
+    struct SweepEndpoint {
+      float value = 0.0f;
+      int instanceId = -1;
+      bool isMax = false;
+    };
+
+    bool isBefore(const SweepEndpoint& first, const SweepEndpoint& second);
+    bool overlapsXZ(int firstId, int secondId);
+    uint64_t getPairKey(int firstId, int secondId);
+
+    void sortAxis(std::vector<SweepEndpoint>& endpoints, int axis);
+
+    /* indexed by the instance id, the ids are dense */
+    std::vector<SweepEntry> mEntries{};
+    std::vector<SweepEndpoint> mEndpointsX{};
+    std::vector<SweepEndpoint> mEndpointsZ{};
+
+    /* pairs overlapping on X and Z, the Y test is done on output */
+    std::unordered_set<uint64_t> mOverlappingPairs{};
+
+    int mNumberOfEndpointSwaps = 0;
+    int mNumberOfPairTests = 0;
+};
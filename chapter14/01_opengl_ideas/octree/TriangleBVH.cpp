@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+
+#include "TriangleBVH.h"
+#include "Logger.h"
+
+namespace {
+  float getSurfaceArea(glm::vec3 minPos, glm::vec3 maxPos) {
+    glm::vec3 extent = maxPos - minPos;
+    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+  }
+}
+
+void TriangleBVH::clear() {
+  mNodes.clear();
+  mTriIndices.clear();
+  mTriangles.clear();
+  mTriMinPos.clear();
+  mTriMaxPos.clear();
+  mTriVertex0.clear();
+  mTriEdge1.clear();
+  mTriEdge2.clear();
+  mTriNormalY.clear();
+  mTriCentroids.clear();
+}
+
+void TriangleBVH::createTriangleStore() {
+  size_t numberOfTriangles = mTriangles.size();
+  mTriMinPos.resize(numberOfTriangles);
+  mTriMaxPos.resize(numberOfTriangles);
+  mTriVertex0.resize(numberOfTriangles);
+  mTriEdge1.resize(numberOfTriangles);
+  mTriEdge2.resize(numberOfTriangles);
+  mTriNormalY.resize(numberOfTriangles);
+
+  for (size_t i = 0; i < numberOfTriangles; ++i) {
+    const MeshTriangle& tri = mTriangles.at(i);
+    if (tri.index != static_cast<int>(i)) {
+      Logger::log(1, "%s error: triangle %i is stored at position %i\n", __FUNCTION__, tri.index, i);
+    }
+
+    /* the triangle box has a small offset to catch planar triangles, use it for the queries too */
+    mTriMinPos.at(i) = tri.boundingBox.getFrontTopLeft();
+    mTriMaxPos.at(i) = tri.boundingBox.getFrontTopLeft() + tri.boundingBox.getSize();
+
+    mTriVertex0.at(i) = tri.points.at(0);
+    mTriEdge1.at(i) = tri.points.at(1) - tri.points.at(0);
+    mTriEdge2.at(i) = tri.points.at(2) - tri.points.at(0);
+    mTriNormalY.at(i) = tri.normal.y;
+  }
+}
+
+void TriangleBVH::build(const std::vector<MeshTriangle>& triangles, int maxLeafTriangles) {
+  clear();
+
+  mTriangles = triangles;
+  createTriangleStore();
+
+  int numberOfTriangles = mTriangles.size();
+  if (numberOfTriangles == 0) {
+    return;
+  }
+
+  mTriCentroids.resize(numberOfTriangles);
+  for (int i = 0; i < numberOfTriangles; ++i) {
+    const MeshTriangle& tri = mTriangles.at(i);
+    mTriCentroids.at(i) = (tri.points.at(0) + tri.points.at(1) + tri.points.at(2)) / 3.0f;
+  }
+
+  mTriIndices.resize(numberOfTriangles);
+  std::iota(mTriIndices.begin(), mTriIndices.end(), 0);
+
+  /* a binary tree with n leafs has 2n - 1 nodes, the references stay valid during the build */
+  mNodes.reserve(numberOfTriangles * 2);
+  mNodes.emplace_back();
+  mNodes.at(0).leftOrFirst = 0;
+  mNodes.at(0).triangleCount = numberOfTriangles;
+  updateNodeBounds(0);
+
+  subdivide(0, 0, std::max(1, maxLeafTriangles));
+
+  mNodes.shrink_to_fit();
+  mTriCentroids.clear();
+  mTriCentroids.shrink_to_fit();
+
+  Logger::log(1, "%s: BVH has %i nodes for %i triangles\n", __FUNCTION__, mNodes.size(), numberOfTriangles);
+}
+
+bool TriangleBVH::setLayout(const std::vector<MeshTriangle>& triangles, const std::vector<TriangleBVHNode>& nodes,
+    const std::vector<int>& triIndices) {
+  clear();
+
+  int numberOfNodes = nodes.size();
+  int numberOfTriIndices = triIndices.size();
+  /* children always follow their parent, a single pass in node order finds the depth of every node */
+  std::vector<int> nodeDepths(numberOfNodes, 0);
+  for (int i = 0; i < numberOfNodes; ++i) {
+    const TriangleBVHNode& node = nodes.at(i);
+    bool validNode = node.triangleCount > 0 ?
+      node.leftOrFirst >= 0 && node.leftOrFirst + node.triangleCount <= numberOfTriIndices :
+      node.leftOrFirst > i && node.leftOrFirst + 1 < numberOfNodes;
+    if (!validNode) {
+      Logger::log(1, "%s error: invalid BVH node layout\n", __FUNCTION__);
+      return false;
+    }
+
+    if (node.triangleCount > 0) {
+      continue;
+    }
+
+    /* the traversal stack holds at most one entry per level plus one */
+    int childDepth = nodeDepths.at(i) + 1;
+    if (childDepth > MAX_TREE_DEPTH) {
+      Logger::log(1, "%s error: BVH is deeper than %i levels\n", __FUNCTION__, MAX_TREE_DEPTH);
+      return false;
+    }
+    nodeDepths.at(node.leftOrFirst) = std::max(nodeDepths.at(node.leftOrFirst), childDepth);
+    nodeDepths.at(node.leftOrFirst + 1) = std::max(nodeDepths.at(node.leftOrFirst + 1), childDepth);
+  }
+
+  for (const auto triIndex : triIndices) {
+    if (triIndex < 0 || triIndex >= static_cast<int>(triangles.size())) {
+      Logger::log(1, "%s error: invalid BVH triangle index %i\n", __FUNCTION__, triIndex);
+      return false;
+    }
+  }
+
+  mTriangles = triangles;
+  createTriangleStore();
+  mNodes = nodes;
+  mTriIndices = triIndices;
+  return true;
+}
+
+void TriangleBVH::updateNodeBounds(int nodeIndex) {
+  TriangleBVHNode& node = mNodes.at(nodeIndex);
+  node.minPos = glm::vec3(std::numeric_limits<float>::max());
+  node.maxPos = glm::vec3(std::numeric_limits<float>::lowest());
+
+  for (int i = node.leftOrFirst; i < node.leftOrFirst + node.triangleCount; ++i) {
+    int triIndex = mTriIndices[i];
+    node.minPos = glm::min(node.minPos, mTriMinPos[triIndex]);
+    node.maxPos = glm::max(node.maxPos, mTriMaxPos[triIndex]);
+  }
+}
+
+float TriangleBVH::findBestSplit(const TriangleBVHNode& node, int& splitAxis, int& splitBin, float& centroidMin, float& binScale) {
+  struct Bin {
+    glm::vec3 minPos = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 maxPos = glm::vec3(std::numeric_limits<float>::lowest());
+    int triangleCount = 0;
+  };
+
+  float bestCost = std::numeric_limits<float>::max();
+
+  /* bins are placed between the centroids, the node bounds are too large for that */
+  glm::vec3 minCentroid = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 maxCentroid = glm::vec3(std::numeric_limits<float>::lowest());
+  for (int i = node.leftOrFirst; i < node.leftOrFirst + node.triangleCount; ++i) {
+    minCentroid = glm::min(minCentroid, mTriCentroids[mTriIndices[i]]);
+    maxCentroid = glm::max(maxCentroid, mTriCentroids[mTriIndices[i]]);
+  }
+
+  for (int axis = 0; axis < 3; ++axis) {
+    float axisMin = minCentroid[axis];
+    float axisMax = maxCentroid[axis];
+    if (axisMin == axisMax) {
+      continue;
+    }
+
+    Bin bins[NUMBER_OF_BINS];
+    float scale = NUMBER_OF_BINS / (axisMax - axisMin);
+    for (int i = node.leftOrFirst; i < node.leftOrFirst + node.triangleCount; ++i) {
+      int triIndex = mTriIndices[i];
+      int binIndex = std::min(NUMBER_OF_BINS - 1, static_cast<int>((mTriCentroids[triIndex][axis] - axisMin) * scale));
+      bins[binIndex].triangleCount++;
+      bins[binIndex].minPos = glm::min(bins[binIndex].minPos, mTriMinPos[triIndex]);
+      bins[binIndex].maxPos = glm::max(bins[binIndex].maxPos, mTriMaxPos[triIndex]);
+    }
+
+    /* sweep from both sides to get the area and count left and right of every plane */
+    float leftArea[NUMBER_OF_BINS - 1];
+    float rightArea[NUMBER_OF_BINS - 1];
+    int leftCount[NUMBER_OF_BINS - 1];
+    int rightCount[NUMBER_OF_BINS - 1];
+
+    glm::vec3 leftMin = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 leftMax = glm::vec3(std::numeric_limits<float>::lowest());
+    glm::vec3 rightMin = leftMin;
+    glm::vec3 rightMax = leftMax;
+    int leftSum = 0;
+    int rightSum = 0;
+    for (int i = 0; i < NUMBER_OF_BINS - 1; ++i) {
+      leftSum += bins[i].triangleCount;
+      leftCount[i] = leftSum;
+      leftMin = glm::min(leftMin, bins[i].minPos);
+      leftMax = glm::max(leftMax, bins[i].maxPos);
+      leftArea[i] = leftSum > 0 ? getSurfaceArea(leftMin, leftMax) : 0.0f;
+
+      int rightBin = NUMBER_OF_BINS - 1 - i;
+      rightSum += bins[rightBin].triangleCount;
+      rightCount[rightBin - 1] = rightSum;
+      rightMin = glm::min(rightMin, bins[rightBin].minPos);
+      rightMax = glm::max(rightMax, bins[rightBin].maxPos);
+      rightArea[rightBin - 1] = rightSum > 0 ? getSurfaceArea(rightMin, rightMax) : 0.0f;
+    }
+
+    for (int i = 0; i < NUMBER_OF_BINS - 1; ++i) {
+      if (leftCount[i] == 0 || rightCount[i] == 0) {
+        continue;
+      }
+
+      float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+      if (cost < bestCost) {
+        bestCost = cost;
+        splitAxis = axis;
+        splitBin = i;
+        centroidMin = axisMin;
+        binScale = scale;
+      }
+    }
+  }
+
+  return bestCost;
+}
+
+void TriangleBVH::subdivide(int nodeIndex, int depth, int maxLeafTriangles) {
+  TriangleBVHNode& node = mNodes.at(nodeIndex);
+  if (node.triangleCount <= maxLeafTriangles || depth >= MAX_TREE_DEPTH) {
+    return;
+  }
+
+  int splitAxis = 0;
+  int splitBin = 0;
+  float centroidMin = 0.0f;
+  float binScale = 0.0f;
+  float splitCost = findBestSplit(node, splitAxis, splitBin, centroidMin, binScale);
+
+  /* all centroids are on the same spot, no plane can separate them */
+  if (splitCost == std::numeric_limits<float>::max()) {
+    return;
+  }
+
+  /* same bin calculation as in findBestSplit(), a different rounding would move triangles to the other side */
+  int* first = mTriIndices.data() + node.leftOrFirst;
+  int* last = first + node.triangleCount;
+  int* middle = std::partition(first, last, [&](int triIndex) {
+    int binIndex = std::min(NUMBER_OF_BINS - 1, static_cast<int>((mTriCentroids[triIndex][splitAxis] - centroidMin) * binScale));
+    return binIndex <= splitBin;
+  });
+
+  int leftCount = middle - first;
+  if (leftCount == 0 || leftCount == node.triangleCount) {
+    return;
+  }
+
+  int leftIndex = mNodes.size();
+  mNodes.emplace_back();
+  mNodes.emplace_back();
+
+  TriangleBVHNode& leftNode = mNodes.at(leftIndex);
+  leftNode.leftOrFirst = node.leftOrFirst;
+  leftNode.triangleCount = leftCount;
+
+  TriangleBVHNode& rightNode = mNodes.at(leftIndex + 1);
+  rightNode.leftOrFirst = node.leftOrFirst + leftCount;
+  rightNode.triangleCount = node.triangleCount - leftCount;
+
+  node.leftOrFirst = leftIndex;
+  node.triangleCount = 0;
+
+  updateNodeBounds(leftIndex);
+  updateNodeBounds(leftIndex + 1);
+
+  subdivide(leftIndex, depth + 1, maxLeafTriangles);
+  subdivide(leftIndex + 1, depth + 1, maxLeafTriangles);
+}
+
+size_t TriangleBVH::query(const BoundingBox3D& box, std::vector<int>& triIndices) const {
+  size_t numberOfIndices = triIndices.size();
+  if (mNodes.empty()) {
+    return 0;
+  }
+
+  glm::vec3 queryMin = box.getFrontTopLeft();
+  glm::vec3 queryMax = queryMin + box.getSize();
+
+  int nodeStack[MAX_STACK_SIZE];
+  int stackSize = 0;
+  nodeStack[stackSize++] = 0;
+
+  while (stackSize > 0) {
+    const TriangleBVHNode& node = mNodes[nodeStack[--stackSize]];
+    if (node.minPos.x > queryMax.x || queryMin.x > node.maxPos.x ||
+        node.minPos.y > queryMax.y || queryMin.y > node.maxPos.y ||
+        node.minPos.z > queryMax.z || queryMin.z > node.maxPos.z) {
+      continue;
+    }
+
+    if (node.triangleCount == 0) {
+      nodeStack[stackSize++] = node.leftOrFirst;
+      nodeStack[stackSize++] = node.leftOrFirst + 1;
+      continue;
+    }
+
+    for (int i = node.leftOrFirst; i < node.leftOrFirst + node.triangleCount; ++i) {
+      int triIndex = mTriIndices[i];
+      const glm::vec3& triMin = mTriMinPos[triIndex];
+      const glm::vec3& triMax = mTriMaxPos[triIndex];
+
+      /* same test as BoundingBox3D::intersects() */
+      if (triMin.x >= queryMax.x || queryMin.x >= triMax.x ||
+          triMin.y >= queryMax.y || queryMin.y >= triMax.y ||
+          triMin.z >= queryMax.z || queryMin.z >= triMax.z) {
+        continue;
+      }
+      triIndices.emplace_back(triIndex);
+    }
+  }
+
+  return triIndices.size() - numberOfIndices;
+}
+
+bool TriangleBVH::rayCast(glm::vec3 origin, glm::vec3 direction, TriangleBVHRayHit& hit, float minNormalY) const {
+  constexpr float epsilon = std::numeric_limits<float>::epsilon();
+
+  hit.triIndex = -1;
+  if (mNodes.empty()) {
+    return false;
+  }
+
+  /* division by zero gives infinity, the slab test works with that */
+  glm::vec3 inverseDirection = 1.0f / direction;
+  float closestDistance = 1.0f;
+
+  int nodeStack[MAX_STACK_SIZE];
+  int stackSize = 0;
+  nodeStack[stackSize++] = 0;
+
+  while (stackSize > 0) {
+    const TriangleBVHNode& node = mNodes[nodeStack[--stackSize]];
+
+    glm::vec3 slabMin = (node.minPos - origin) * inverseDirection;
+    glm::vec3 slabMax = (node.maxPos - origin) * inverseDirection;
+    glm::vec3 slabNear = glm::min(slabMin, slabMax);
+    glm::vec3 slabFar = glm::max(slabMin, slabMax);
+    float nearDistance = std::max(std::max(slabNear.x, slabNear.y), std::max(slabNear.z, 0.0f));
+    float farDistance = std::min(std::min(slabFar.x, slabFar.y), std::min(slabFar.z, closestDistance));
+    /* also rejects the NaN of a zero direction component in a slab border */
+    if (!(nearDistance <= farDistance)) {
+      continue;
+    }
+
+    if (node.triangleCount == 0) {
+      nodeStack[stackSize++] = node.leftOrFirst;
+      nodeStack[stackSize++] = node.leftOrFirst + 1;
+      continue;
+    }
+
+    for (int i = node.leftOrFirst; i < node.leftOrFirst + node.triangleCount; ++i) {
+      int triIndex = mTriIndices[i];
+      if (mTriNormalY[triIndex] < minNormalY) {
+        continue;
+      }
+
+      /* same Moeller-Trumbore test as Tools::rayTriangleIntersection() */
+      const glm::vec3& edge1 = mTriEdge1[triIndex];
+      const glm::vec3& edge2 = mTriEdge2[triIndex];
+      glm::vec3 rayCrossEdge2 = glm::cross(direction, edge2);
+      float inPlaneDeterminant = glm::dot(edge1, rayCrossEdge2);
+      if (std::fabs(inPlaneDeterminant) < epsilon) {
+        continue;
+      }
+
+      float inverseInPlaneDeterminant = 1.0f / inPlaneDeterminant;
+      glm::vec3 rayOriginDistFromPoint0 = origin - mTriVertex0[triIndex];
+      float barycentricU = inverseInPlaneDeterminant * glm::dot(rayOriginDistFromPoint0, rayCrossEdge2);
+      if (barycentricU < 0.0f || barycentricU > 1.0f) {
+        continue;
+      }
+
+      glm::vec3 rayOriginDistCrossEdge1 = glm::cross(rayOriginDistFromPoint0, edge1);
+      float barycentricV = inverseInPlaneDeterminant * glm::dot(direction, rayOriginDistCrossEdge1);
+      if (barycentricV < 0.0f || barycentricU + barycentricV > 1.0f) {
+        continue;
+      }
+
+      float distance = inverseInPlaneDeterminant * glm::dot(edge2, rayOriginDistCrossEdge1);
+      if (distance > epsilon && distance <= closestDistance) {
+        closestDistance = distance;
+        hit.triIndex = triIndex;
+      }
+    }
+  }
+
+  if (hit.triIndex == -1) {
+    return false;
+  }
+
+  hit.distance = closestDistance;
+  hit.position = origin + direction * closestDistance;
+  return true;
+}
+
+const MeshTriangle& TriangleBVH::getTriangle(int triIndex) const {
+  return mTriangles[triIndex];
+}
+
+const std::vector<MeshTriangle>& TriangleBVH::getTriangles() const {
+  return mTriangles;
+}
+
+size_t TriangleBVH::getNumberOfTriangles() const {
+  return mTriangles.size();
+}
+
+const std::vector<TriangleBVHNode>& TriangleBVH::getNodes() const {
+  return mNodes;
+}
+
+const std::vector<int>& TriangleBVH::getTriangleIndices() const {
+  return mTriIndices;
+}
+
+std::vector<BoundingBox3D> TriangleBVH::getLeafBoxes() const {
+  std::vector<BoundingBox3D> leafBoxes{};
+  for (const auto& node : mNodes) {
+    if (node.triangleCount > 0) {
+      leafBoxes.emplace_back(node.minPos, node.maxPos - node.minPos);
+    }
+  }
+  return leafBoxes;
+}
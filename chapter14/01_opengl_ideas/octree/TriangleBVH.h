@@ -0,0 +1,76 @@
+/* flat bounding volume hierarchy of the level triangles, built with a binned surface area heuristic */
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "OGLRenderData.h"
+#include "BoundingBox3D.h"
+
+/* 32 bytes, two nodes share a cache line */
+struct TriangleBVHNode {
+  glm::vec3 minPos{};
+  /* first slot in the triangle index list for leafs, left child for inner nodes (the right child follows directly) */
+  int leftOrFirst = 0;
+  glm::vec3 maxPos{};
+  /* zero for inner nodes */
+  int triangleCount = 0;
+};
+
+struct TriangleBVHRayHit {
+  int triIndex = -1;
+  /* hit position is origin + direction * distance */
+  float distance = 0.0f;
+  glm::vec3 position{};
+};
+
+class TriangleBVH {
+  public:
+    /* the triangle index must be the position in the list */
+    void build(const std::vector<MeshTriangle>& triangles, int maxLeafTriangles);
+    /* restores a saved tree, i.e. from the level data cache */
+    bool setLayout(const std::vector<MeshTriangle>& triangles, const std::vector<TriangleBVHNode>& nodes,
+      const std::vector<int>& triIndices);
+    void clear();
+
+    /* appends the indices of all triangles intersecting the box, no allocation if the buffer has enough capacity */
+    size_t query(const BoundingBox3D& box, std::vector<int>& triIndices) const;
+    /* closest hit up to origin + direction, triangles with a normal Y below minNormalY are ignored */
+    bool rayCast(glm::vec3 origin, glm::vec3 direction, TriangleBVHRayHit& hit, float minNormalY = -1.0f) const;
+
+    const MeshTriangle& getTriangle(int triIndex) const;
+    const std::vector<MeshTriangle>& getTriangles() const;
+    size_t getNumberOfTriangles() const;
+
+    const std::vector<TriangleBVHNode>& getNodes() const;
+    const std::vector<int>& getTriangleIndices() const;
+    std::vector<BoundingBox3D> getLeafBoxes() const;
+
+  private:
+    /* the traversal stack is a fixed array, the build never goes deeper */
+    static const int MAX_TREE_DEPTH = 62;
+    static const int MAX_STACK_SIZE = 64;
+    static const int NUMBER_OF_BINS = 16;
+
+    void createTriangleStore();
+    void updateNodeBounds(int nodeIndex);
+    void subdivide(int nodeIndex, int depth, int maxLeafTriangles);
+    float findBestSplit(const TriangleBVHNode& node, int& splitAxis, int& splitBin, float& centroidMin, float& binScale);
+
+    std::vector<TriangleBVHNode> mNodes{};
+    /* leaf ranges point into this list */
+    std::vector<int> mTriIndices{};
+
+    /* full triangle data for the callers */
+    std::vector<MeshTriangle> mTriangles{};
+
+    /* SoA copies of the data the traversal touches */
+    std::vector<glm::vec3> mTriMinPos{};
+    std::vector<glm::vec3> mTriMaxPos{};
+    std::vector<glm::vec3> mTriVertex0{};
+    std::vector<glm::vec3> mTriEdge1{};
+    std::vector<glm::vec3> mTriEdge2{};
+    std::vector<float> mTriNormalY{};
+    /* only used during the build */
+    std::vector<glm::vec3> mTriCentroids{};
+};
@@ -66,8 +66,6 @@ using octreeQueryBBoxCallback = std::function<std::set<int>(BoundingBox3D)>;
 using octreeFindAllIntersectionsCallback = std::function<std::set<std::pair<int, int>>()>;
 using octreeGetBoxesCallback = std::function<std::vector<BoundingBox3D>()>;
 using worldGetBoundariesCallback = std::function<std::shared_ptr<BoundingBox3D>()>;
-using triangleOctreeGetMeshesCallback = std::function<std::vector<MeshTriangle>(BoundingBox3D)>;
-using triangleOctreeChangeCallback = std::function<void(void)>;
 
 using fireNodeOutputCallback = std::function<void(int)>;
 using editNodeGraphCallback = std::function<void(std::string)>;
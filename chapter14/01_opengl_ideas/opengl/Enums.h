@@ -105,6 +105,11 @@ enum class collisionChecks : uint8_t {
   boundingSpheres
 };
 
+enum class collisionBroadphase : uint8_t {
+  grid = 0,
+  sweepAndPrune
+};
+
 enum class collisionDebugDraw : uint8_t {
   none = 0,
   colliding,
@@ -172,6 +177,7 @@ enum class nodeEvent : uint8_t {
   interaction,
   instanceToLevelCollision,
   navTargetReached,
+  instanceToInstanceCollisionEnd,
   NUM
 };
 
@@ -0,0 +1,58 @@
+#include "GpuTimer.h"
+#include "Logger.h"
+
+void GpuTimer::start() {
+  if (mRunning) {
+    Logger::log(1, "%s error: timer already running\n", __FUNCTION__);
+    return;
+  }
+
+  std::vector<GLuint>& queries = mQueries.at(mCurrentFrame);
+  size_t& usedQueries = mUsedQueries.at(mCurrentFrame);
+
+  /* query pool grows with the number of start/stop pairs per frame */
+  if (usedQueries == queries.size()) {
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    queries.emplace_back(query);
+  }
+
+  glBeginQuery(GL_TIME_ELAPSED, queries.at(usedQueries));
+  mRunning = true;
+}
+
+void GpuTimer::stop() {
+  if (!mRunning) {
+    Logger::log(1, "%s error: timer not running\n", __FUNCTION__);
+    return;
+  }
+
+  glEndQuery(GL_TIME_ELAPSED);
+  ++mUsedQueries.at(mCurrentFrame);
+  mRunning = false;
+}
+
+float GpuTimer::nextFrame() {
+  mCurrentFrame = (mCurrentFrame + 1) % QUERY_FRAMES;
+
+  /* the queries of this section have been issued QUERY_FRAMES frames ago */
+  GLuint64 elapsedNanoSeconds = 0;
+  for (size_t i = 0; i < mUsedQueries.at(mCurrentFrame); ++i) {
+    GLuint64 queryResult = 0;
+    glGetQueryObjectui64v(mQueries.at(mCurrentFrame).at(i), GL_QUERY_RESULT, &queryResult);
+    elapsedNanoSeconds += queryResult;
+  }
+  mUsedQueries.at(mCurrentFrame) = 0;
+
+  return elapsedNanoSeconds / 1'000'000.0f;
+}
+
+void GpuTimer::cleanup() {
+  for (auto& queries : mQueries) {
+    if (!queries.empty()) {
+      glDeleteQueries(queries.size(), queries.data());
+    }
+    queries.clear();
+  }
+  mUsedQueries.fill(0);
+}
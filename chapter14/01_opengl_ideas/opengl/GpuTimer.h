@@ -0,0 +1,26 @@
+/* GPU timer, collects the results a few frames later to avoid waiting for the GPU */
+#pragma once
+
+#include <array>
+#include <vector>
+#include <glad/glad.h>
+
+class GpuTimer {
+  public:
+    /* start and stop may be called multiple times per frame, timer queries can't be nested */
+    void start();
+    void stop();
+
+    /* returns the summed time of the oldest frame in milliseconds and reuses its queries */
+    float nextFrame();
+
+    void cleanup();
+
+  private:
+    static const int QUERY_FRAMES = 3;
+
+    std::array<std::vector<GLuint>, QUERY_FRAMES> mQueries{};
+    std::array<size_t, QUERY_FRAMES> mUsedQueries{};
+    int mCurrentFrame = 0;
+    bool mRunning = false;
+};
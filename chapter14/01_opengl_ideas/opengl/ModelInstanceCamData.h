@@ -36,7 +36,8 @@ struct ModelInstanceCamData {
   std::unordered_map<moveDirection, std::string> micMoveDirectionMap{};
   std::unordered_map<moveState, std::string> micMoveStateMap{};
 
-  std::set<std::pair<int, int>> micInstanceCollisions{};
+  /* every colliding pair once, sorted */
+  std::vector<std::pair<int, int>> micInstanceCollisions{};
 
   std::map<std::string, std::shared_ptr<SingleInstanceBehavior>> micBehaviorData{};
   std::unordered_map<nodeEvent, std::string> micNodeUpdateMap{};
@@ -104,7 +105,6 @@ struct ModelInstanceCamData {
   levelAddCallback micLevelAddCallbackFunction;
   levelDeleteCallback micLevelDeleteCallbackFunction;
   levelGenerateLevelDataCallback micLevelGenerateLevelDataCallbackFunction;
-  triangleOctreeChangeCallback micTriangleOctreeChangeCallbackFunction;
 
   ikIterationsCallback micIkIterationsCallbackFunction;
 
@@ -11,6 +11,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_precision.hpp>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -39,6 +40,16 @@ struct OGLVertex {
   glm::vec4 boneWeight = glm::vec4(0.0f);
 };
 
+/* 32 instead of 80 bytes, the attributes are decoded by the *_packed.vert shaders */
+struct OGLPackedVertex {
+  glm::u16vec4 position = glm::u16vec4(0); // half floats, last value unused
+  glm::vec2 uv = glm::vec2(0.0f);
+  glm::i16vec2 normal = glm::i16vec2(0); // octahedral encoding, snorm
+  glm::u8vec4 color = glm::u8vec4(255); // unorm
+  glm::u8vec4 boneNumber = glm::u8vec4(0);
+  glm::u8vec4 boneWeight = glm::u8vec4(0); // unorm
+};
+
 struct OGLMesh {
   std::vector<OGLVertex> vertices{};
   std::vector<uint32_t> indices{};
@@ -95,6 +106,38 @@ struct TRSMatrixData{
   glm::vec4 scale{};
 };
 
+/* same layout as glDrawElementsIndirect() expects */
+struct DrawElementsIndirectCommand {
+  uint32_t count = 0;
+  uint32_t instanceCount = 0;
+  uint32_t firstIndex = 0;
+  int32_t baseVertex = 0;
+  uint32_t baseInstance = 0;
+};
+
+/* frustum planes are stored as normal and distance, std430 layout */
+struct CullingParameters {
+  std::array<glm::vec4, 6> frustumPlanes{};
+  int numberOfInstances = 0;
+  int numberOfDrawCommands = 0;
+};
+
+/* per instance input of the feet IK compute shader, ground triangles are stored in a separate buffer */
+struct IKInstanceData {
+  int triangleOffset = 0;
+  int triangleCount = 0;
+  float instanceHeight = 0.0f;
+  float worldPosY = 0.0f;
+};
+
+/* sphere ranges of both instances of a broadphase pair, input of the sphere collision compute shader */
+struct SpherePair {
+  uint32_t firstOffset = 0;
+  uint32_t firstCount = 0;
+  uint32_t secondOffset = 0;
+  uint32_t secondCount = 0;
+};
+
 struct TimeOfDayLightParameters {
   float timeStamp;
   float lightAngleEW;
@@ -113,9 +156,20 @@ struct OGLRenderData {
   unsigned int rdTriangleCount = 0;
   unsigned int rdLevelTriangleCount = 0;
   unsigned int rdMatricesSize = 0;
+  /* per-frame instance data written to the SSBO ring buffers */
+  unsigned int rdInstanceDataUploadSize = 0;
+
+  /* textures of the texture manager, a cache hit is a texture shared instead of loaded again */
+  size_t rdNumberOfTextures = 0;
+  size_t rdTextureMemorySize = 0;
+  size_t rdTextureCacheHits = 0;
+  /* streamed textures still decoding or with missing mip levels */
+  size_t rdNumberOfPendingTextureUploads = 0;
 
   float rdFrameTime = 0.0f;
   float rdMatrixGenerateTime = 0.0f;
+  /* GPU time of the bone matrix compute shaders, a few frames old */
+  float rdBoneMatrixGpuTime = 0.0f;
   float rdUploadToVBOTime = 0.0f;
   float rdUploadToUBOTime = 0.0f;
   float rdDownloadFromUBOTime = 0.0f;
@@ -130,6 +184,46 @@ struct OGLRenderData {
   float rdIKTime = 0.0f;
   float rdLevelGroundNeighborUpdateTime = 0.0f;
   float rdPathFindingTime = 0.0f;
+  float rdInstanceUpdateTime = 0.0f;
+  float rdCullingTime = 0.0f;
+
+  /* includes the main thread */
+  int rdNumberOfWorkerThreads = 1;
+  int rdMaxNumberOfWorkerThreads = 1;
+
+  /* decode textures in the background and show a placeholder, upload at most the budget (in KB) per frame */
+  bool rdEnableTextureStreaming = true;
+  int rdTextureStreamingBudget = 2048;
+
+  /* keyframe reduced and quantized animation lookups for models loaded afterwards,
+   * the max error is in radians for rotations and relative to the largest translation for translations */
+  bool rdCompressAnimLookups = false;
+  float rdAnimLookupMaxError = 0.001f;
+
+  /* half float positions, octahedral normals and byte bone data, default for models added afterwards */
+  bool rdPackModelVertices = false;
+
+  /* config loading in the background, jobs are counted since the load started */
+  bool rdAssetLoadingActive = false;
+  size_t rdNumberOfAssetLoadJobs = 0;
+  size_t rdNumberOfFinishedAssetLoadJobs = 0;
+  /* the UI shows the load error dialog */
+  bool rdConfigLoadFailed = false;
+
+  /* bone matrices level by level with cached parent matrices, or walk up to the root for every bone */
+  bool rdUseLevelOrderBoneMatrices = true;
+
+  /* draw only instances inside the view frustum, indirect draw with GPU compacted instance lists */
+  bool rdEnableInstanceCulling = true;
+
+  /* use the per-model animation LOD tiers, skipped instances keep the bone matrices of their last update */
+  bool rdEnableAnimationLod = true;
+  unsigned int rdNumberOfBoneUpdates = 0;
+  unsigned int rdNumberOfAnimatedInstances = 0;
+
+  /* heap allocations of the last frame, all threads */
+  size_t rdFrameAllocations = 0;
+  size_t rdWorldUpdateAllocations = 0;
 
   int rdMoveForward = 0;
   int rdMoveRight = 0;
@@ -157,6 +251,16 @@ struct OGLRenderData {
 
   collisionChecks rdCheckCollisions = collisionChecks::none;
   size_t rdNumberOfCollisions = 0;
+  collisionBroadphase rdCollisionBroadphase = collisionBroadphase::grid;
+  float rdInstanceGridCellSize = 4.0f;
+  int rdNumberOfRebucketedInstances = 0;
+  int rdNumberOfEndpointSwaps = 0;
+  int rdNumberOfInstancePairTests = 0;
+  int rdNumberOfSpherePairTests = 0;
+  /* fire the instance collision events only when a contact begins or ends */
+  bool rdCollisionEventsOnContactChange = false;
+  int rdNumberOfContactBegins = 0;
+  int rdNumberOfContactEnds = 0;
 
   collisionDebugDraw rdDrawCollisionAABBs = collisionDebugDraw::none;
   collisionDebugDraw rdDrawBoundingSpheres = collisionDebugDraw::none;
@@ -176,12 +280,11 @@ struct OGLRenderData {
   int rdOctreeThreshold = 10;
   int rdOctreeMaxDepth = 5;
 
-  int rdLevelOctreeThreshold = 10;
-  int rdLevelOctreeMaxDepth = 5;
+  int rdLevelBVHMaxLeafTriangles = 4;
 
   bool rdDrawLevelAABB = false;
   bool rdDrawLevelWireframe = false;
-  bool rdDrawLevelOctree = false;
+  bool rdDrawLevelBVH = false;
   bool rdDrawLevelCollisionTriangles = false;
 
   bool rdDrawLevelWireframeMiniMap = false;
@@ -189,6 +292,11 @@ struct OGLRenderData {
 
   float rdMaxLevelGroundSlopeAngle = 0.0f;
   float rdMaxStairstepHeight = 1.0f;
+
+  /* restore the level BVH and the nav graph from disk if levels and parameters are unchanged */
+  bool rdEnableLevelDataCache = true;
+  /* restore the animation AABB lookups of the models from a file next to the model */
+  bool rdEnableAABBLookupCache = true;
   glm::vec3 rdLevelCollisionAABBExtension = glm::vec3(0.0f, 1.0f, 0.0f);
 
   int rdNumberOfCollidingTriangles = 0;
@@ -197,11 +305,33 @@ struct OGLRenderData {
   bool rdEnableSimpleGravity = false;
 
   bool rdEnableFeetIK = false;
+  bool rdEnableGpuFeetIK = true;
   int rdNumberOfIkIteratons = 10;
   bool rdDrawIKDebugLines = false;
 
   bool rdEnableNavigation = false;
 
+  /* search paths on the path service threads, instances keep their old path until the new one arrives */
+  bool rdEnableAsyncPathFinding = true;
+  /* time to apply path results per frame, at least one result is always applied */
+  float rdPathResultBudget = 0.5f;
+  size_t rdNumberOfPendingPathRequests = 0;
+  size_t rdNumberOfAppliedPathResults = 0;
+
+  /* search the cluster graph first, then only the triangles inside the clusters of the route */
+  bool rdUseHierarchicalPathFinding = true;
+  /* edge length of the XZ grid cells used as clusters, changing it rebuilds the nav graph */
+  float rdNavClusterSize = 16.0f;
+  size_t rdNumberOfPathQueries = 0;
+  size_t rdPathNodesExpanded = 0;
+  /* average of the last frame with at least one query */
+  float rdPathNodesPerQuery = 0.0f;
+
+  /* instances read the next triangle from a distance field per target instead of searching their own path */
+  bool rdUseFlowFields = false;
+  size_t rdNumberOfFlowFields = 0;
+  size_t rdNumberOfFlowFieldRebuilds = 0;
+
   bool rdDrawNeighborTriangles = false;
   bool rdDrawGroundTriangles = false;
   bool rdDrawInstancePaths = false;
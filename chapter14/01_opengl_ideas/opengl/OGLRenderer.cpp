@@ -5,8 +5,11 @@
 
 #include <ctime>
 #include <cstdlib>
+#include <cstdio>
 #include <algorithm>
+#include <iterator>
 #include <filesystem>
+#include <unordered_set>
 #include <set>
 
 #include "OGLRenderer.h"
@@ -18,9 +21,14 @@
 
 OGLRenderer::OGLRenderer(GLFWwindow *window) {
   mRenderData.rdWindow = window;
+  mGLLoadFunction = (GLADloadproc)glfwGetProcAddress;
 }
 
-bool OGLRenderer::init(unsigned int width, unsigned int height) {
+OGLRenderer::OGLRenderer(GLADloadproc glLoadFunction) {
+  mGLLoadFunction = glLoadFunction;
+}
+
+bool OGLRenderer::init(unsigned int width, unsigned int height, std::string configFileName) {
   /* randomize rand() and randomization for std::shuffle in navigation */
   std::srand(static_cast<int>(time(nullptr)));
   unsigned int seed = mRandomDevice();
@@ -39,7 +47,7 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
   mRenderData.rdHeight = height;
 
   /* initialize GLAD */
-  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+  if (!gladLoadGLLoader(mGLLoadFunction)) {
     Logger::log(1, "%s error: failed to initialize GLAD\n", __FUNCTION__);
     return false;
   }
@@ -62,7 +70,7 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
 
   mLineVertexBuffer.init();
   mLevelAABBVertexBuffer.init();
-  mLevelOctreeVertexBuffer.init();
+  mLevelBVHVertexBuffer.init();
   mLevelWireframeVertexBuffer.init();
   mIKLinesVertexBuffer.init();
   mSkyboxBuffer.init();
@@ -131,6 +139,53 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
     return false;
   }
 
+  /* packed vertex variants, the fragment shaders are the same */
+  if (!mAssimpPackedShader.loadShaders("shader/assimp_packed.vert", "shader/assimp.frag")) {
+    Logger::log(1, "%s: Assimp packed vertex shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+
+  if (!mAssimpSkinningPackedShader.loadShaders("shader/assimp_skinning_packed.vert", "shader/assimp_skinning.frag")) {
+    Logger::log(1, "%s: Assimp GPU skinning packed vertex shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpSkinningPackedShader.getUniformLocation("aModelStride")) {
+    Logger::log(1, "%s: could not find symbol 'aModelStride' in GPU skinning packed vertex shader\n", __FUNCTION__);
+    return false;
+  }
+
+  if (!mAssimpSkinningMorphPackedShader.loadShaders("shader/assimp_skinning_morph_packed.vert", "shader/assimp_skinning_morph.frag")) {
+    Logger::log(1, "%s: Assimp GPU skinning with morph anims packed vertex shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpSkinningMorphPackedShader.getUniformLocation("aModelStride")) {
+    Logger::log(1, "%s: could not find symbol 'aModelStride' in GPU skinning with morph anims packed vertex shader\n", __FUNCTION__);
+    return false;
+  }
+
+  if (!mAssimpSelectionPackedShader.loadShaders("shader/assimp_selection_packed.vert", "shader/assimp_selection.frag")) {
+    Logger::log(1, "%s: Assimp selection packed vertex shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+
+  if (!mAssimpSkinningSelectionPackedShader.loadShaders("shader/assimp_skinning_selection_packed.vert", "shader/assimp_skinning_selection.frag")) {
+    Logger::log(1, "%s: Assimp GPU skinning selection packed vertex shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpSkinningSelectionPackedShader.getUniformLocation("aModelStride")) {
+    Logger::log(1, "%s: could not find symbol 'aModelStride' in GPU skinning selection packed vertex shader\n", __FUNCTION__);
+    return false;
+  }
+
+  if (!mAssimpSkinningMorphSelectionPackedShader.loadShaders("shader/assimp_skinning_morph_selection_packed.vert", "shader/assimp_skinning_morph_selection.frag")) {
+    Logger::log(1, "%s: Assimp GPU skinning with morph anims and selection packed vertex shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpSkinningMorphSelectionPackedShader.getUniformLocation("aModelStride")) {
+    Logger::log(1, "%s: could not find symbol 'aModelStride' in GPU skinning with morph anims and selection packed vertex shader\n", __FUNCTION__);
+    return false;
+  }
+
   if (!mAssimpLevelShader.loadShaders("shader/assimp_level.vert", "shader/assimp_level.frag")) {
     Logger::log(1, "%s: Assimp Level shader loading failed\n", __FUNCTION__);
     return false;
@@ -149,14 +204,66 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
     Logger::log(1, "%s: Assimp GPU node transform with head move compute shader loading failed\n", __FUNCTION__);
     return false;
   }
+  if (!mAssimpTransformComputeShader.getUniformLocation("aReducedSkeletonDepth")) {
+    Logger::log(1, "%s: could not find symbol 'aReducedSkeletonDepth' in GPU node transform compute shader\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpTransformHeadMoveComputeShader.getUniformLocation("aReducedSkeletonDepth")) {
+    Logger::log(1, "%s: could not find symbol 'aReducedSkeletonDepth' in GPU node transform with head move compute shader\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpTransformCompressedComputeShader.loadComputeShader("shader/assimp_instance_transform_compressed.comp")) {
+    Logger::log(1, "%s: Assimp GPU node transform with compressed lookups compute shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpTransformHeadMoveCompressedComputeShader.loadComputeShader("shader/assimp_instance_headmove_transform_compressed.comp")) {
+    Logger::log(1, "%s: Assimp GPU node transform with head move and compressed lookups compute shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpTransformCompressedComputeShader.getUniformLocation("aReducedSkeletonDepth")) {
+    Logger::log(1, "%s: could not find symbol 'aReducedSkeletonDepth' in GPU node transform with compressed lookups compute shader\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpTransformHeadMoveCompressedComputeShader.getUniformLocation("aReducedSkeletonDepth")) {
+    Logger::log(1, "%s: could not find symbol 'aReducedSkeletonDepth' in GPU node transform with head move and compressed lookups compute shader\n", __FUNCTION__);
+    return false;
+  }
   if (!mAssimpMatrixComputeShader.loadComputeShader("shader/assimp_instance_matrix_mult.comp")) {
     Logger::log(1, "%s: Assimp GPU matrix compute shader loading failed\n", __FUNCTION__);
     return false;
   }
+  if (!mAssimpMatrixLevelComputeShader.loadComputeShader("shader/assimp_instance_matrix_mult_levels.comp")) {
+    Logger::log(1, "%s: Assimp GPU level order matrix compute shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpMatrixLevelComputeShader.getUniformLocation("aNumberOfBones")) {
+    Logger::log(1, "%s: could not find symbol 'aNumberOfBones' in GPU level order matrix compute shader\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpInstanceCullingShader.loadComputeShader("shader/assimp_instance_culling.comp")) {
+    Logger::log(1, "%s: Assimp GPU instance culling compute shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpFeetIKComputeShader.loadComputeShader("shader/assimp_instance_feet_ik.comp")) {
+    Logger::log(1, "%s: Assimp GPU feet IK compute shader loading failed\n", __FUNCTION__);
+    return false;
+  }
   if (!mAssimpBoundingBoxComputeShader.loadComputeShader("shader/assimp_instance_bounding_spheres.comp")) {
     Logger::log(1, "%s: Assimp GPU bounding spheres matrix compute shader loading failed\n", __FUNCTION__);
     return false;
   }
+  if (!mAssimpAABBLookupComputeShader.loadComputeShader("shader/assimp_instance_aabb_lookup.comp")) {
+    Logger::log(1, "%s: Assimp GPU AABB lookup compute shader loading failed\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpAABBLookupComputeShader.getUniformLocation("aNumberOfBones")) {
+    Logger::log(1, "%s: could not find symbol 'aNumberOfBones' in GPU AABB lookup compute shader\n", __FUNCTION__);
+    return false;
+  }
+  if (!mAssimpSphereCollisionComputeShader.loadComputeShader("shader/assimp_instance_sphere_collisions.comp")) {
+    Logger::log(1, "%s: Assimp GPU sphere collision compute shader loading failed\n", __FUNCTION__);
+    return false;
+  }
 
   if (!mSkyboxShader.loadShaders("shader/skybox.vert", "shader/skybox.frag")) {
     Logger::log(1, "%s: skybox shader loading failed\n", __FUNCTION__);
@@ -191,15 +298,28 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
 
   /* SSBO init  */
   mShaderBoneMatrixBuffer.init(256);
-  mShaderModelRootMatrixBuffer.init(256);
   mShaderTRSMatrixBuffer.init(256);
-  mPerInstanceAnimDataBuffer.init(256);
-  mSelectedInstanceBuffer.init(256);
   mEmptyBoneOffsetBuffer.init(256);
   mEmptyWorldPositionBuffer.init(256);
   mBoundingSphereBuffer.init(256);
   mBoundingSphereAdjustmentBuffer.init(256);
-  mFaceAnimPerInstanceDataBuffer.init(256);
+  mCollisionSphereBuffer.init(256);
+  mSpherePairBuffer.init(256);
+  mCollidingPairBuffer.init(256);
+  mIKChainDataBuffer.init(256);
+  mIKInstanceDataBuffer.init(256);
+  mIKGroundTriangleBuffer.init(256);
+  mCullingParameterBuffer.init(256);
+  mVisibleInstanceBuffer.init(256);
+  mDrawCommandBuffer.init(256);
+
+  /* per-frame instance data is written directly into mapped memory, sections grow on demand */
+  mShaderModelRootMatrixBuffer.initRingBuffer(64 * 1024);
+  mPerInstanceAnimDataBuffer.initRingBuffer(64 * 1024);
+  mSelectedInstanceBuffer.initRingBuffer(64 * 1024);
+  mFaceAnimPerInstanceDataBuffer.initRingBuffer(64 * 1024);
+  mCullingAABBBuffer.initRingBuffer(64 * 1024);
+  mBoneUpdateInstanceBuffer.initRingBuffer(64 * 1024);
   Logger::log(1, "%s: SSBOs initialized\n", __FUNCTION__);
 
   mWorldBoundaries = std::make_shared<BoundingBox3D>(mRenderData.rdDefaultWorldStartPos, mRenderData.rdDefaultWorldSize);
@@ -208,11 +328,12 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
   initOctree(mRenderData.rdOctreeThreshold, mRenderData.rdOctreeMaxDepth);
   Logger::log(1, "%s: octree initialized\n", __FUNCTION__);
 
-  initTriangleOctree(mRenderData.rdLevelOctreeThreshold, mRenderData.rdLevelOctreeMaxDepth);
-  Logger::log(1, "%s: triangle octree initialized\n", __FUNCTION__);
+  mTriangleBVH = std::make_shared<TriangleBVH>();
+  Logger::log(1, "%s: triangle BVH initialized\n", __FUNCTION__);
 
-  mModelInstCamData.micOctreeFindAllIntersectionsCallbackFunction = [this]() { return mOctree->findAllIntersections(); };
-  mModelInstCamData.micOctreeGetBoxesCallbackFunction = [this]() { return mOctree->getTreeBoxes(); };
+  /* the octree is only filled for the minimap and the debug callbacks */
+  mModelInstCamData.micOctreeFindAllIntersectionsCallbackFunction = [this]() { updateOctree(); return mOctree->findAllIntersections(); };
+  mModelInstCamData.micOctreeGetBoxesCallbackFunction = [this]() { updateOctree(); return mOctree->getTreeBoxes(); };
   mModelInstCamData.micWorldGetBoundariesCallbackFunction = [this]() { return getWorldBoundaries(); };
 
   /* register instance/model callbacks */
@@ -243,7 +364,7 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
   mModelInstCamData.micCameraNameCheckCallbackFunction = [this](std::string cameraName) { return checkCameraNameUsed(cameraName); };
 
   mModelInstCamData.micInstanceGetPositionsCallbackFunction = [this]() { return getPositionOfAllInstances(); };
-  mModelInstCamData.micOctreeQueryBBoxCallbackFunction = [this](BoundingBox3D box) { return mOctree->query(box); };
+  mModelInstCamData.micOctreeQueryBBoxCallbackFunction = [this](BoundingBox3D box) { updateOctree(); return mOctree->query(box); };
 
   mModelInstCamData.micEditNodeGraphCallbackFunction = [this](std::string graphName) { editGraph(graphName); };
   mModelInstCamData.micCreateEmptyNodeGraphCallbackFunction= [this]() { return createEmptyGraph(); };
@@ -308,6 +429,7 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
   mModelInstCamData.micNodeUpdateMap[nodeEvent::interaction] = "Interaction";
   mModelInstCamData.micNodeUpdateMap[nodeEvent::instanceToLevelCollision] = "Inst to Level collision";
   mModelInstCamData.micNodeUpdateMap[nodeEvent::navTargetReached] = "Nav Target Reached";
+  mModelInstCamData.micNodeUpdateMap[nodeEvent::instanceToInstanceCollisionEnd] = "Inst to Inst collision end";
 
   mModelInstCamData.micFaceAnimationNameMap[faceAnimation::none] = "None";
   mModelInstCamData.micFaceAnimationNameMap[faceAnimation::angry] = "Angry";
@@ -345,7 +467,7 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
   mLineMesh = std::make_shared<OGLLineMesh>();
   mAABBMesh = std::make_shared<OGLLineMesh>();
   mLevelAABBMesh = std::make_shared<OGLLineMesh>();
-  mLevelOctreeMesh = std::make_shared<OGLLineMesh>();
+  mLevelBVHMesh = std::make_shared<OGLLineMesh>();
   mLevelWireframeMesh = std::make_shared<OGLLineMesh>();
   mLevelCollidingTriangleMesh = std::make_shared<OGLLineMesh>();
   mIKFootPointMesh = std::make_shared<OGLLineMesh>();
@@ -373,20 +495,52 @@ bool OGLRenderer::init(unsigned int width, unsigned int height) {
   mGraphEditor = std::make_shared<GraphEditor>();
   Logger::log(1, "%s: graph editor initialized\n", __FUNCTION__);
 
-  /* try to load the default configuration file */
-  if (loadConfigFile(mDefaultConfigFileName)) {
-    Logger::log(1, "%s: loaded default config file '%s'\n", __FUNCTION__, mDefaultConfigFileName.c_str());
+  /* use all cores for the per-instance updates by default */
+  mRenderData.rdMaxNumberOfWorkerThreads = std::max(1u, std::thread::hardware_concurrency());
+  mRenderData.rdNumberOfWorkerThreads = mRenderData.rdMaxNumberOfWorkerThreads;
+  mJobSystem.init(mRenderData.rdNumberOfWorkerThreads);
+  Logger::log(1, "%s: job system initialized\n", __FUNCTION__);
+
+  /* path searches run beside the job system, keep most cores for the frame */
+  mPathService.init(std::max(1, mRenderData.rdMaxNumberOfWorkerThreads / 4));
+  Logger::log(1, "%s: path service initialized\n", __FUNCTION__);
+
+  /* try to load the requested or the default configuration file */
+  if (configFileName.empty()) {
+    configFileName = mDefaultConfigFileName;
+  }
+
+  /* the asset loader runs beside the job system and the render thread */
+  mAssetLoader.init(std::max(1, mRenderData.rdMaxNumberOfWorkerThreads - 1));
+  Logger::log(1, "%s: asset loader initialized\n", __FUNCTION__);
+
+  /* the streaming only decodes, the uploads are limited by the frame budget */
+  if (mTextureManager.init(std::max(1, mRenderData.rdMaxNumberOfWorkerThreads / 4))) {
+    Logger::log(1, "%s: texture streaming initialized\n", __FUNCTION__);
+  } else {
+    Logger::log(1, "%s error: could not init texture streaming, loading textures synchronously\n", __FUNCTION__);
+  }
+  mTextureManager.setStreamingEnabled(mRenderData.rdEnableTextureStreaming);
+
+  /* no window to show the progress yet, wait for the models here */
+  if (loadConfigFile(configFileName) && finishConfigLoading()) {
+    Logger::log(1, "%s: loaded config file '%s'\n", __FUNCTION__, configFileName.c_str());
   } else {
-    Logger::log(1, "%s: could not load default config file '%s'\n", __FUNCTION__, mDefaultConfigFileName.c_str());
+    Logger::log(1, "%s: could not load config file '%s'\n", __FUNCTION__, configFileName.c_str());
     /* clear everything and add null model/instance/settings container */
     createEmptyConfig();
   }
 
-  mUserInterface.init(mRenderData);
-  Logger::log(1, "%s: user interface initialized\n", __FUNCTION__);
+  if (mRenderData.rdWindow) {
+    mUserInterface.init(mRenderData);
+    Logger::log(1, "%s: user interface initialized\n", __FUNCTION__);
+  } else {
+    Logger::log(1, "%s: running headless, no user interface\n", __FUNCTION__);
+  }
 
   Logger::log(1, "%s: all done, starting application\n", __FUNCTION__);
   mFrameTimer.start();
+  mFrameAllocationCounter.start();
   mApplicationRunning = true;
 
   return true;
@@ -397,14 +551,23 @@ ModelInstanceCamData& OGLRenderer::getModInstCamData() {
 }
 
 bool OGLRenderer::loadConfigFile(std::string configFileName) {
-  YamlParser parser;
-  if (!parser.loadYamlFile(configFileName)) {
+  /* a second config would mix up the models of both */
+  if (mConfigLoadPending) {
+    Logger::log(1, "%s error: still loading config file '%s'\n", __FUNCTION__, mPendingConfigParser->getFileName().c_str());
     return false;
   }
 
-  std::string yamlFileVersion = parser.getFileVersion();
+  Timer configLoadTimer{};
+  configLoadTimer.start();
+
+  std::shared_ptr<YamlParser> parser = std::make_shared<YamlParser>();
+  if (!parser->loadYamlFile(configFileName)) {
+    return false;
+  }
+
+  std::string yamlFileVersion = parser->getFileVersion();
   if (yamlFileVersion.empty()) {
-    Logger::log(1, "%s error: could not check file version of YAML config file '%s'\n", __FUNCTION__, parser.getFileName().c_str());
+    Logger::log(1, "%s error: could not check file version of YAML config file '%s'\n", __FUNCTION__, parser->getFileName().c_str());
     return false;
   }
 
@@ -416,9 +579,9 @@ bool OGLRenderer::loadConfigFile(std::string configFileName) {
 
 
   /* load level data */
-  std::vector<LevelSettings> savedLevelSettings = parser.getLevelConfigs();
+  std::vector<LevelSettings> savedLevelSettings = parser->getLevelConfigs();
   if (savedLevelSettings.empty()) {
-    Logger::log(1, "%s warning: no level in file '%s', skipping\n", __FUNCTION__, parser.getFileName().c_str());
+    Logger::log(1, "%s warning: no level in file '%s', skipping\n", __FUNCTION__, parser->getFileName().c_str());
   } else {
     for (auto& levelSetting : savedLevelSettings) {
       /* skip level data generation here, will be done after all levels are loaded */
@@ -435,15 +598,15 @@ bool OGLRenderer::loadConfigFile(std::string configFileName) {
     }
 
     /* restore level settings before generating the level data  */
-    mRenderData.rdEnableSimpleGravity = parser.getGravityEnabled();
-    mRenderData.rdMaxLevelGroundSlopeAngle = parser.getMaxGroundSlopeAngle();
-    mRenderData.rdMaxStairstepHeight = parser.getMaxStairStepHeight();
+    mRenderData.rdEnableSimpleGravity = parser->getGravityEnabled();
+    mRenderData.rdMaxLevelGroundSlopeAngle = parser->getMaxGroundSlopeAngle();
+    mRenderData.rdMaxStairstepHeight = parser->getMaxStairStepHeight();
 
     /* regenerate vertex data */
     generateLevelVertexData();
 
     /* restore selected level num */
-    int selectedLevel = parser.getSelectedLevelNum();
+    int selectedLevel = parser->getSelectedLevelNum();
     if (selectedLevel < mModelInstCamData.micLevels.size()) {
       mModelInstCamData.micSelectedLevel = selectedLevel;
     } else {
@@ -452,16 +615,146 @@ bool OGLRenderer::loadConfigFile(std::string configFileName) {
   }
 
   /* get models */
-  std::vector<ModelSettings> savedModelSettings = parser.getModelConfigs();
+  std::vector<ModelSettings> savedModelSettings = parser->getModelConfigs();
   if (savedModelSettings.empty()) {
-    Logger::log(1, "%s error: no model files in file '%s'\n", __FUNCTION__, parser.getFileName().c_str());
+    Logger::log(1, "%s error: no model files in file '%s'\n", __FUNCTION__, parser->getFileName().c_str());
     return false;
   }
 
-  for (auto& modSetting : savedModelSettings) {
-    if (!addModel(modSetting.msModelFilenamePath, false, false)) {
+  std::unordered_set<std::string> modelFileNames{};
+  for (const auto& modSetting : savedModelSettings) {
+    if (!modelFileNames.insert(modSetting.msModelFilenamePath).second) {
+      Logger::log(1, "%s error: model '%s' is used twice in file '%s'\n", __FUNCTION__,
+        modSetting.msModelFilenamePath.c_str(), parser->getFileName().c_str());
+      return false;
+    }
+  }
+
+  /* the file I/O, the import and the texture decoding run on the asset loader threads,
+   * the GL objects are created in draw() after all jobs are done */
+  mAssetLoader.resetCounters();
+  for (const auto& modSetting : savedModelSettings) {
+    std::string modelFileName = modSetting.msModelFilenamePath;
+    std::shared_ptr<AssimpModel> model = std::make_shared<AssimpModel>();
+    model->setAnimLookupCompression(mRenderData.rdCompressAnimLookups, mRenderData.rdAnimLookupMaxError);
+    model->setPackedVertices(modSetting.msPackVertices);
+    mPendingConfigModels.emplace_back(model);
+
+    mAssetLoader.addJob([this, model, modelFileName]() {
+      if (!model->prepareModel(modelFileName)) {
+        Logger::log(1, "%s error: could not load model file '%s'\n", __FUNCTION__, modelFileName.c_str());
+        return false;
+      }
+
+      /* one job per texture, large textures of a model are decoded in parallel */
+      for (size_t i = 0; i < model->getNumberOfTexturesToLoad(); ++i) {
+        mAssetLoader.addJob([this, model, i]() { return model->decodeTexture(i, mTextureManager); });
+      }
+      return true;
+    });
+  }
+
+  mPendingConfigParser = parser;
+  mConfigLoadPending = true;
+  mConfigLoadTime = configLoadTimer.stop();
+  mConfigLoadTimer.start();
+
+  mRenderData.rdAssetLoadingActive = true;
+  mRenderData.rdNumberOfAssetLoadJobs = mAssetLoader.getNumberOfJobs();
+  mRenderData.rdNumberOfFinishedAssetLoadJobs = 0;
+
+  Logger::log(1, "%s: loading %i models of config file '%s' in the background\n", __FUNCTION__,
+    savedModelSettings.size(), parser->getFileName().c_str());
+  return true;
+}
+
+void OGLRenderer::updateConfigLoading() {
+  mRenderData.rdNumberOfAssetLoadJobs = mAssetLoader.getNumberOfJobs();
+  mRenderData.rdNumberOfFinishedAssetLoadJobs = mAssetLoader.getNumberOfFinishedJobs();
+
+  if (!mAssetLoader.isIdle()) {
+    return;
+  }
+
+  if (!finishConfigLoading()) {
+    mRenderData.rdConfigLoadFailed = true;
+  }
+}
+
+bool OGLRenderer::finishConfigLoading() {
+  /* returns at once if all jobs are done */
+  mAssetLoader.waitForJobs();
+
+  std::shared_ptr<YamlParser> parser = mPendingConfigParser;
+  std::vector<std::shared_ptr<AssimpModel>> models = mPendingConfigModels;
+  mPendingConfigParser.reset();
+  mPendingConfigModels.clear();
+  mConfigLoadPending = false;
+  mRenderData.rdAssetLoadingActive = false;
+
+  float assetLoadTime = mConfigLoadTimer.stop();
+
+  if (mAssetLoader.getNumberOfFailedJobs() > 0) {
+    Logger::log(1, "%s error: %i of %i asset jobs for config file '%s' failed\n", __FUNCTION__,
+      mAssetLoader.getNumberOfFailedJobs(), mAssetLoader.getNumberOfJobs(), parser->getFileName().c_str());
+    createEmptyConfig();
+    return false;
+  }
+
+  Timer glObjectTimer{};
+  glObjectTimer.start();
+
+  /* keep the order of the config file */
+  for (const auto& model : models) {
+    if (!model->createGLObjects(mTextureManager)) {
+      Logger::log(1, "%s error: could not create GL objects for model '%s'\n", __FUNCTION__,
+        model->getModelFileNamePath().c_str());
+      model->cleanup();
+      createEmptyConfig();
       return false;
     }
+
+    mModelInstCamData.micModelList.emplace_back(model);
+
+    /* create AABBs for the model */
+    createAABBLookup(model);
+  }
+
+  if (!restoreConfigSettings(*parser)) {
+    createEmptyConfig();
+    return false;
+  }
+
+  float glObjectTime = glObjectTimer.stop();
+
+  Logger::log(1, "%s: loaded config file '%s' with %i models in %.2f ms (levels %.2f ms, asset jobs %.2f ms, GL objects and settings %.2f ms)\n",
+    __FUNCTION__, parser->getFileName().c_str(), models.size(), mConfigLoadTime + assetLoadTime + glObjectTime,
+    mConfigLoadTime, assetLoadTime, glObjectTime);
+  return true;
+}
+
+void OGLRenderer::cancelConfigLoading() {
+  if (!mConfigLoadPending) {
+    return;
+  }
+
+  /* the running jobs use the models, let them finish */
+  mAssetLoader.waitForJobs();
+
+  Logger::log(1, "%s: canceled loading of config file '%s'\n", __FUNCTION__, mPendingConfigParser->getFileName().c_str());
+
+  mPendingConfigParser.reset();
+  mPendingConfigModels.clear();
+  mConfigLoadPending = false;
+  mConfigLoadTimer.stop();
+  mRenderData.rdAssetLoadingActive = false;
+}
+
+bool OGLRenderer::restoreConfigSettings(YamlParser& parser) {
+  std::string yamlFileVersion = parser.getFileVersion();
+
+  std::vector<ModelSettings> savedModelSettings = parser.getModelConfigs();
+  for (auto& modSetting : savedModelSettings) {
     std::shared_ptr<AssimpModel> model = getModel(modSetting.msModelFilenamePath);
     if (!model) {
       return false;
@@ -651,6 +944,7 @@ bool OGLRenderer::saveConfigFile(std::string configFileName) {
 }
 
 void OGLRenderer::createEmptyConfig() {
+  cancelConfigLoading();
   removeAllModelsAndInstances();
   mUserInterface.resetPositionWindowOctreeView();
   loadDefaultFreeCam();
@@ -788,6 +1082,9 @@ void OGLRenderer::removeAllModelsAndInstances() {
   /* kill undo and redo stacks too */
   clearUndoRedoStacks();
 
+  /* no undo step can bring the deleted models back now */
+  deletePendingModels();
+
   /* reset collision settings */
   resetCollisionData();
 
@@ -795,11 +1092,24 @@ void OGLRenderer::removeAllModelsAndInstances() {
   updateLevelTriangleCount();
 }
 
+void OGLRenderer::deletePendingModels() {
+  for (const auto& model : mModelInstCamData.micPendingDeleteAssimpModels) {
+    model->cleanup();
+  }
+  mModelInstCamData.micPendingDeleteAssimpModels.clear();
+
+  mTextureManager.evictUnusedTextures();
+}
+
 void OGLRenderer::resetCollisionData() {
   mModelInstCamData.micInstanceCollisions.clear();
+  mPreviousInstanceCollisions.clear();
+  mInstanceSweepAndPrune.clear();
 
   mRenderData.rdNumberOfCollisions = 0;
   mRenderData.rdCheckCollisions = collisionChecks::none;
+  mRenderData.rdCollisionBroadphase = collisionBroadphase::grid;
+  mRenderData.rdCollisionEventsOnContactChange = false;
   mRenderData.rdDrawCollisionAABBs = collisionDebugDraw::none;
   mRenderData.rdDrawBoundingSpheres = collisionDebugDraw::none;
 }
@@ -839,6 +1149,37 @@ std::shared_ptr<AssimpModel> OGLRenderer::getModel(std::string modelFileName) {
   return nullptr;
 }
 
+Shader& OGLRenderer::getTransformComputeShader(std::shared_ptr<AssimpModel> model, bool withHeadMovement) {
+  /* the compressed lookups have their own decode path */
+  if (model->hasCompressedAnimLookups()) {
+    return withHeadMovement ? mAssimpTransformHeadMoveCompressedComputeShader : mAssimpTransformCompressedComputeShader;
+  }
+  return withHeadMovement ? mAssimpTransformHeadMoveComputeShader : mAssimpTransformComputeShader;
+}
+
+Shader& OGLRenderer::getModelShader(std::shared_ptr<AssimpModel> model, bool skinned, bool withMorphAnims) {
+  bool selection = mMousePick && mRenderData.rdApplicationMode == appMode::edit;
+
+  /* the packed vertices have their own attribute decode */
+  if (model->hasPackedVertices()) {
+    if (!skinned) {
+      return selection ? mAssimpSelectionPackedShader : mAssimpPackedShader;
+    }
+    if (withMorphAnims) {
+      return selection ? mAssimpSkinningMorphSelectionPackedShader : mAssimpSkinningMorphPackedShader;
+    }
+    return selection ? mAssimpSkinningSelectionPackedShader : mAssimpSkinningPackedShader;
+  }
+
+  if (!skinned) {
+    return selection ? mAssimpSelectionShader : mAssimpShader;
+  }
+  if (withMorphAnims) {
+    return selection ? mAssimpSkinningMorphSelectionShader : mAssimpSkinningMorphShader;
+  }
+  return selection ? mAssimpSkinningSelectionShader : mAssimpSkinningShader;
+}
+
 bool OGLRenderer::addModel(std::string modelFileName, bool addInitialInstance, bool withUndo) {
   if (hasModel(modelFileName)) {
     Logger::log(1, "%s warning: model '%s' already existed, skipping\n", __FUNCTION__, modelFileName.c_str());
@@ -846,7 +1187,9 @@ bool OGLRenderer::addModel(std::string modelFileName, bool addInitialInstance, b
   }
 
   std::shared_ptr<AssimpModel> model = std::make_shared<AssimpModel>();
-  if (!model->loadModel(modelFileName)) {
+  model->setAnimLookupCompression(mRenderData.rdCompressAnimLookups, mRenderData.rdAnimLookupMaxError);
+  model->setPackedVertices(mRenderData.rdPackModelVertices);
+  if (!model->loadModel(modelFileName, mTextureManager)) {
     Logger::log(1, "%s error: could not load model file '%s'\n", __FUNCTION__, modelFileName.c_str());
     return false;
   }
@@ -1174,14 +1517,28 @@ void OGLRenderer::initOctree(int thresholdPerBox, int maxDepth) {
   mOctree->mInstanceGetBoundingBoxCallbackFunction = [this](int instanceId) {
     return mModelInstCamData.micAssimpInstances.at(instanceId)->getBoundingBox();
   };
+  mOctreeDirty = true;
 }
 
-std::shared_ptr<BoundingBox3D> OGLRenderer::getWorldBoundaries() {
-  return mWorldBoundaries;
+void OGLRenderer::updateOctree() {
+  if (!mOctreeDirty) {
+    return;
+  }
+
+  mOctree->clear();
+  /* skip null instance */
+  for (size_t i = 1; i < mModelInstCamData.micAssimpInstances.size(); ++i) {
+    mOctree->add(mModelInstCamData.micAssimpInstances.at(i)->getInstanceIndexPosition());
+  }
+  mOctreeDirty = false;
+}
+
+PathFinder& OGLRenderer::getPathFinder() {
+  return mPathFinder;
 }
 
-void OGLRenderer::initTriangleOctree(int thresholdPerBox, int maxDepth) {
-  mTriangleOctree = std::make_shared<TriangleOctree>(mWorldBoundaries, thresholdPerBox, maxDepth);
+std::shared_ptr<BoundingBox3D> OGLRenderer::getWorldBoundaries() {
+  return mWorldBoundaries;
 }
 
 void OGLRenderer::addBehavior(std::shared_ptr<AssimpInstance> instance, std::shared_ptr<SingleInstanceBehavior> behavior) {
@@ -1238,7 +1595,7 @@ void OGLRenderer::delModelBehavior(std::string modelName) {
 
 void OGLRenderer::updateInstanceSettings(std::shared_ptr<AssimpInstance> instance, graphNodeType nodeType,
     instanceUpdateType updateType, nodeCallbackVariant data, bool extraSetting) {
-  InstanceSettings settings = instance->getInstanceSettings();
+  const InstanceSettings& settings = instance->getInstanceSettings();
   moveDirection dir = settings.isMoveDirection;
   moveState state = settings.isMoveState;
 
@@ -1321,7 +1678,7 @@ void OGLRenderer::updateInstanceSettings(std::shared_ptr<AssimpInstance> instanc
 }
 
 void OGLRenderer::addBehaviorEvent(std::shared_ptr<AssimpInstance> instance, nodeEvent event) {
-  InstanceSettings instSettings = instance->getInstanceSettings();
+  const InstanceSettings& instSettings = instance->getInstanceSettings();
   /* add event only if instance has a node tree template to react */
   if (!instSettings.isNodeTreeName.empty()) {
     mBehaviorManager->addEvent(instance, event);
@@ -1430,15 +1787,120 @@ void OGLRenderer::addNullLevel() {
 
 void OGLRenderer::generateLevelVertexData() {
   generateLevelAABB();
-  generateLevelOctree();
+
+  /* BVH and nav graph are restored from the cache if no level and no parameter has changed */
+  if (!loadLevelDataCache()) {
+    generateLevelBVH();
+    mPathFinder.generateGroundTriangles(mRenderData, mTriangleBVH);
+
+    /* sliders rebuild the level data every frame, save only after the data stayed the same for a while */
+    mLevelDataCacheSavePending = mRenderData.rdEnableLevelDataCache && mTriangleBVH->getNumberOfTriangles() > 0;
+    mLevelDataCacheSaveTime = std::chrono::steady_clock::now() + LEVEL_DATA_CACHE_SAVE_DELAY;
+  }
+
+  generateLevelBVHMesh();
   generateLevelWireframe();
   generateGroundTriangleData();
 
   updateLevelTriangleCount();
 }
 
+uint64_t OGLRenderer::getLevelDataCacheKey() {
+  uint64_t key = LevelDataCache::FNV_OFFSET_BASIS;
+
+  for (const auto& level : mModelInstCamData.micLevels) {
+    if (level->getTriangleCount() == 0) {
+      continue;
+    }
+
+    /* hash every level file only once, big levels take a while */
+    std::string levelFileName = level->getLevelFileNamePath();
+    auto fileHashIter = mLevelFileHashes.find(levelFileName);
+    if (fileHashIter == mLevelFileHashes.end()) {
+      fileHashIter = mLevelFileHashes.emplace(levelFileName, LevelDataCache::hashFile(levelFileName)).first;
+    }
+    key = LevelDataCache::hashData(&fileHashIter->second, sizeof(uint64_t), key);
+
+    glm::mat4 transformMat = level->getWorldTransformMatrix();
+    glm::mat4 normalMat = level->getNormalTransformMatrix();
+    key = LevelDataCache::hashData(&transformMat, sizeof(transformMat), key);
+    key = LevelDataCache::hashData(&normalMat, sizeof(normalMat), key);
+  }
+
+  key = LevelDataCache::hashData(&mRenderData.rdLevelBVHMaxLeafTriangles, sizeof(int), key);
+  key = LevelDataCache::hashData(&mRenderData.rdMaxLevelGroundSlopeAngle, sizeof(float), key);
+  key = LevelDataCache::hashData(&mRenderData.rdMaxStairstepHeight, sizeof(float), key);
+
+  return key;
+}
+
+std::string OGLRenderer::getLevelDataCacheFileName() {
+  /* one file per set of levels, changed data overwrites the old file */
+  uint64_t nameHash = LevelDataCache::FNV_OFFSET_BASIS;
+  for (const auto& level : mModelInstCamData.micLevels) {
+    if (level->getTriangleCount() == 0) {
+      continue;
+    }
+    std::string levelFileName = level->getLevelFileNamePath();
+    nameHash = LevelDataCache::hashData(levelFileName.data(), levelFileName.size(), nameHash);
+  }
+
+  char hashString[17];
+  std::snprintf(hashString, sizeof(hashString), "%016llx", static_cast<unsigned long long>(nameHash));
+  return mLevelDataCacheDirectory + "level_" + hashString + ".lvc";
+}
+
+bool OGLRenderer::loadLevelDataCache() {
+  mLevelDataCacheSavePending = false;
+
+  if (!mRenderData.rdEnableLevelDataCache) {
+    return false;
+  }
+
+  /* nothing to restore for the null level only */
+  bool hasLevelTriangles = false;
+  for (const auto& level : mModelInstCamData.micLevels) {
+    hasLevelTriangles |= level->getTriangleCount() > 0;
+  }
+  if (!hasLevelTriangles) {
+    return false;
+  }
+
+  Timer loadTimer{};
+  loadTimer.start();
+
+  std::string cacheFileName = getLevelDataCacheFileName();
+  std::vector<MeshTriangle> levelTriangles{};
+  std::vector<TriangleBVHNode> bvhNodes{};
+  std::vector<int> bvhTriIndices{};
+  std::shared_ptr<NavGraph> navGraph = std::make_shared<NavGraph>();
+  if (!LevelDataCache::load(cacheFileName, getLevelDataCacheKey(), levelTriangles, bvhNodes, bvhTriIndices, *navGraph) ||
+      !mTriangleBVH->setLayout(levelTriangles, bvhNodes, bvhTriIndices)) {
+    mTriangleBVH->clear();
+    return false;
+  }
+
+  mPathFinder.setNavGraph(mRenderData, navGraph);
+
+  Logger::log(1, "%s: level data restored from '%s' in %f ms\n", __FUNCTION__, cacheFileName.c_str(), loadTimer.stop());
+  return true;
+}
+
+void OGLRenderer::saveLevelDataCache() {
+  mLevelDataCacheSavePending = false;
+
+  std::shared_ptr<const NavGraph> navGraph = mPathFinder.getNavGraph();
+  LevelDataCache::save(getLevelDataCacheFileName(), getLevelDataCacheKey(), mTriangleBVH->getTriangles(),
+    mTriangleBVH->getNodes(), mTriangleBVH->getTriangleIndices(), *navGraph);
+}
+
 void OGLRenderer::generateGroundTriangleData() {
-  mPathFinder.generateGroundTriangles(mRenderData, mTriangleOctree, *getWorldBoundaries());
+  mPathService.setNavGraph(mPathFinder.getNavGraph());
+
+  /* pending requests are gone with the old graph, force a new search */
+  for (const auto& instance : mModelInstCamData.micAssimpInstances) {
+    instance->setPathStartTriIndex(-1);
+  }
 
   mUploadToVBOTimer.start();
   mGroundMeshVertexBuffer.uploadData(*mPathFinder.getGroundLevelMesh());
@@ -1467,7 +1929,6 @@ void OGLRenderer::generateLevelAABB() {
   mRenderData.rdWorldStartPos = mWorldBoundaries->getFrontTopLeft();
   mRenderData.rdWorldSize = mWorldBoundaries->getSize();
   initOctree(mRenderData.rdOctreeThreshold, mRenderData.rdOctreeMaxDepth);
-  initTriangleOctree(mRenderData.rdLevelOctreeThreshold, mRenderData.rdLevelOctreeMaxDepth);
 
   glm::vec4 levelAABBColor = glm::vec4(0.0f, 1.0f, 0.5, 1.0f);
   mLevelAABBMesh = mAllLevelAABB.getAABBLines(levelAABBColor);
@@ -1477,15 +1938,15 @@ void OGLRenderer::generateLevelAABB() {
   mRenderData.rdUploadToVBOTime += mUploadToVBOTimer.stop();
 }
 
-void OGLRenderer::generateLevelOctree() {
-  mTriangleOctree->clear();
+void OGLRenderer::generateLevelBVH() {
+  std::vector<MeshTriangle> levelTriangles{};
 
   int index = 0;
   for (const auto& level : mModelInstCamData.micLevels) {
     if (level->getTriangleCount() == 0) {
       continue;
     }
-    Logger::log(1, "%s: generating octree data for level '%s'\n", __FUNCTION__, level->getLevelFileName().c_str());
+    Logger::log(1, "%s: generating BVH data for level '%s'\n", __FUNCTION__, level->getLevelFileName().c_str());
     std::vector<OGLMesh> levelMeshes = level->getLevelMeshes();
     glm::mat4 transformMat = level->getWorldTransformMatrix();
     glm::mat3 normalMat = level->getNormalTransformMatrix();
@@ -1520,26 +1981,33 @@ void OGLRenderer::generateLevelOctree() {
         tri.normal = glm::normalize(normalMat * glm::vec3(mesh.vertices.at(mesh.indices.at(i)).normal));
 
         tri.index = index++;
-        mTriangleOctree->add(tri);
+        levelTriangles.emplace_back(tri);
       }
     }
   }
 
-  mLevelOctreeMesh->vertices.clear();
+  Timer buildTimer{};
+  buildTimer.start();
+  mTriangleBVH->build(levelTriangles, mRenderData.rdLevelBVHMaxLeafTriangles);
+  Logger::log(1, "%s: BVH for %i triangles built in %f ms\n", __FUNCTION__, levelTriangles.size(), buildTimer.stop());
+}
+
+void OGLRenderer::generateLevelBVHMesh() {
+  mLevelBVHMesh->vertices.clear();
 
-  glm::vec4 octreeColor = glm::vec4(1.0f, 1.0f, 1.0, 1.0f);
-  const std::vector<BoundingBox3D> treeBoxes = mTriangleOctree->getTreeBoxes();
+  glm::vec4 bvhColor = glm::vec4(1.0f, 1.0f, 1.0, 1.0f);
+  const std::vector<BoundingBox3D> treeBoxes = mTriangleBVH->getLeafBoxes();
   for (const auto& box : treeBoxes) {
     AABB boxAABB{};
     boxAABB.create(box.getFrontTopLeft());
     boxAABB.addPoint(box.getFrontTopLeft() + box.getSize());
 
-    std::shared_ptr<OGLLineMesh> instanceLines = boxAABB.getAABBLines(octreeColor);
-    mLevelOctreeMesh->vertices.insert(mLevelOctreeMesh->vertices.end(), instanceLines->vertices.begin(), instanceLines->vertices.end());
+    std::shared_ptr<OGLLineMesh> instanceLines = boxAABB.getAABBLines(bvhColor);
+    mLevelBVHMesh->vertices.insert(mLevelBVHMesh->vertices.end(), instanceLines->vertices.begin(), instanceLines->vertices.end());
   }
 
   mUploadToVBOTimer.start();
-  mLevelOctreeVertexBuffer.uploadData(*mLevelOctreeMesh);
+  mLevelBVHVertexBuffer.uploadData(*mLevelBVHMesh);
   mRenderData.rdUploadToVBOTime += mUploadToVBOTimer.stop();
 }
 
@@ -1636,7 +2104,7 @@ std::vector<int> OGLRenderer::getNavTargets() {
     }
     std::string modelName = model->getModelFileName();
     for (auto& instance : mModelInstCamData.micAssimpInstancesPerModel[modelName]) {
-      InstanceSettings settings = instance->getInstanceSettings();
+      const InstanceSettings& settings = instance->getInstanceSettings();
       targets.emplace_back(settings.isInstanceIndexPosition);
     }
   }
@@ -1672,11 +2140,12 @@ void OGLRenderer::assignInstanceIndices() {
       modelType.second.at(i)->setInstanceSettings(instSettings);
     }
   }
-  mOctree->clear();
-  /* skip null instance */
-  for (size_t i = 1; i < mModelInstCamData.micAssimpInstances.size(); ++i) {
-    mOctree->add(mModelInstCamData.micAssimpInstances.at(i)->getInstanceIndexPosition());
-  }
+  /* the ids have changed, the next world update fills the broadphase again */
+  mInstanceGrid.clear();
+  mInstanceSweepAndPrune.clear();
+  mPreviousInstanceCollisions.clear();
+  mSphereCollisionInstances.clear();
+  mOctreeDirty = true;
 }
 
 void OGLRenderer::cloneCamera() {
@@ -2299,133 +2768,200 @@ void OGLRenderer::createAABBLookup(std::shared_ptr<AssimpModel> model) {
   /* we use a single instance per clip */
   size_t numberOfClips = model->getAnimClips().size();
 
-  mPerInstanceAnimData.resize(numberOfClips);
-
   auto boneList =  model->getBoneList();
   size_t numberOfBones = boneList.size();
 
   /* we need valid model with triangles and animations */
-  if (numberOfClips > 0 && numberOfBones > 0 &&
-      model->getTriangleCount() > 0) {
-
-    Logger::log(1, "%s: playing animations for model %s\n", __FUNCTION__, model->getModelFileName().c_str());
+  if (numberOfClips == 0 || numberOfBones == 0 || model->getTriangleCount() == 0) {
+    return;
+  }
 
-    /* we MUST set the bone offsets to identity matrices to get the skeleton data */
-    std::vector<glm::mat4> emptyBoneOffsets(numberOfBones, glm::mat4(1.0f));
-    mEmptyBoneOffsetBuffer.uploadSsboData(emptyBoneOffsets);
+  /* the lookups depend only on the model files, the model cache key covers all of them (e.g. the .bin of a glTF) */
+  std::string cacheFileName = AABBLookupCache::getCacheFileName(model->getModelFileNamePath());
+  uint64_t cacheKey = 0;
+  if (mRenderData.rdEnableAABBLookupCache) {
+    cacheKey = model->getSourceKey();
+    cacheKey = LevelDataCache::hashData(&numberOfBones, sizeof(numberOfBones), cacheKey);
 
     std::vector<std::vector<AABB>> aabbLookups;
-    aabbLookups.resize(numberOfClips);
+    if (AABBLookupCache::load(cacheFileName, cacheKey, numberOfClips, LOOKUP_SIZE, aabbLookups)) {
+      model->setAABBLookup(aabbLookups);
+      return;
+    }
+  }
 
-    std::vector<glm::mat4> boneMatrix;
+  Logger::log(1, "%s: playing animations for model %s\n", __FUNCTION__, model->getModelFileName().c_str());
 
-    size_t numberOfBones = model->getBoneList().size();
-    size_t trsMatrixSize = numberOfBones * numberOfClips * 3 * sizeof(glm::vec4);
-    size_t bufferMatrixSize = numberOfBones * numberOfClips * sizeof(glm::mat4);
-    mShaderBoneMatrixBuffer.checkForResize(bufferMatrixSize);
-    mShaderTRSMatrixBuffer.checkForResize(trsMatrixSize);
-    mPerInstanceAnimDataBuffer.checkForResize(numberOfClips);
+  /* every clip and every timestamp is a separate instance: instance = lookup * numberOfClips + clip */
+  size_t numberOfInstances = numberOfClips * LOOKUP_SIZE;
 
-    /* some models have a scaling set here... */
-    glm::mat4 rootTransformMat = glm::transpose(model->getRootTranformationMatrix());
+  /* limit the size of the temporary buffers, a single batch for most models */
+  const size_t MAX_BATCH_BUFFER_SIZE = 128 * 1024 * 1024;
+  size_t bytesPerInstance = numberOfBones * (3 * sizeof(glm::vec4) + sizeof(glm::mat4));
+  size_t instancesPerBatch = std::clamp<size_t>(MAX_BATCH_BUFFER_SIZE / bytesPerInstance, 1, numberOfInstances);
 
-    /* our axis aligned bounding box */
-    AABB aabb;
+  /* we MUST set the bone offsets to identity matrices to get the skeleton data */
+  std::vector<glm::mat4> emptyBoneOffsets(numberOfBones, glm::mat4(1.0f));
+  mEmptyBoneOffsetBuffer.uploadSsboData(emptyBoneOffsets);
 
-    /* play all animation steps */
-    float timeScaleFactor = model->getMaxClipDuration() / static_cast<float>(LOOKUP_SIZE);
-    for (int lookups = 0; lookups < LOOKUP_SIZE; ++lookups) {
-      for (size_t i = 0; i < numberOfClips; ++i) {
+  /* some models have a scaling set here... */
+  std::vector<glm::mat4> rootTransformMat = { glm::transpose(model->getRootTranformationMatrix()) };
 
-        PerInstanceAnimData animData{};
-        animData.firstAnimClipNum = i;
-        animData.secondAnimClipNum = 0;
-        animData.firstClipReplayTimestamp = lookups * timeScaleFactor;
-        animData.secondClipReplayTimestamp = 0.0f;
-        animData.blendFactor = 0.0f;
+  /* temporary buffers, the shared ones would keep their size for the whole run */
+  ShaderStorageBuffer animDataBuffer{};
+  ShaderStorageBuffer trsMatrixBuffer{};
+  ShaderStorageBuffer boneMatrixBuffer{};
+  ShaderStorageBuffer aabbBuffer{};
+  animDataBuffer.init(instancesPerBatch * sizeof(PerInstanceAnimData));
+  trsMatrixBuffer.init(instancesPerBatch * numberOfBones * 3 * sizeof(glm::vec4));
+  boneMatrixBuffer.init(instancesPerBatch * numberOfBones * sizeof(glm::mat4));
+  aabbBuffer.init(instancesPerBatch * 2 * sizeof(glm::vec4));
 
-        mPerInstanceAnimData.at(i) = animData;
-      }
+  std::vector<std::vector<AABB>> aabbLookups;
+  aabbLookups.resize(numberOfClips);
+  for (auto& clipLookups : aabbLookups) {
+    clipLookups.resize(LOOKUP_SIZE);
+  }
+
+  float timeScaleFactor = model->getMaxClipDuration() / static_cast<float>(LOOKUP_SIZE);
+  for (size_t batchStart = 0; batchStart < numberOfInstances; batchStart += instancesPerBatch) {
+    size_t batchSize = std::min(instancesPerBatch, numberOfInstances - batchStart);
+
+    mPerInstanceAnimData.resize(batchSize);
+    for (size_t i = 0; i < batchSize; ++i) {
+      size_t instance = batchStart + i;
+
+      PerInstanceAnimData animData{};
+      animData.firstAnimClipNum = instance % numberOfClips;
+      animData.secondAnimClipNum = 0;
+      animData.firstClipReplayTimestamp = (instance / numberOfClips) * timeScaleFactor;
+      animData.secondClipReplayTimestamp = 0.0f;
+      animData.blendFactor = 0.0f;
+
+      mPerInstanceAnimData.at(i) = animData;
+    }
 
-      /* do a single iteration of all clips in parallel */
-      mAssimpTransformComputeShader.use();
+    uploadAllBoneUpdateInstances(batchSize);
 
-      mUploadToUBOTimer.start();
-      model->bindAnimLookupBuffer(0);
-      mPerInstanceAnimDataBuffer.uploadSsboData(mPerInstanceAnimData, 1);
-      mShaderTRSMatrixBuffer.bind(2);
-      mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+    /* all clips and timestamps of the batch in parallel */
+    getTransformComputeShader(model, false).use();
+
+    mUploadToUBOTimer.start();
+    model->bindAnimLookupBuffer(0);
+    animDataBuffer.uploadSsboData(mPerInstanceAnimData, 1);
+    trsMatrixBuffer.bind(2);
+    mBoneUpdateInstanceBuffer.bind(3);
+    model->bindBoneParentBuffer(4);
+    mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-      glDispatchCompute(numberOfBones, std::ceil(numberOfClips/ 32.0f), 1);
-      glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glDispatchCompute(numberOfBones, std::ceil(batchSize / 32.0f), 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+    mAssimpMatrixComputeShader.use();
 
-      mAssimpMatrixComputeShader.use();
+    mUploadToUBOTimer.start();
+    trsMatrixBuffer.bind(0);
+    model->bindBoneParentBuffer(1);
+    mEmptyBoneOffsetBuffer.bind(2);
+    boneMatrixBuffer.bind(3);
+    mBoneUpdateInstanceBuffer.bind(4);
+    mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-      mUploadToUBOTimer.start();
-      mShaderTRSMatrixBuffer.bind(0);
-      model->bindBoneParentBuffer(1);
-      mEmptyBoneOffsetBuffer.bind(2);
-      mShaderBoneMatrixBuffer.bind(3);
-      mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+    glDispatchCompute(numberOfBones, std::ceil(batchSize / 32.0f), 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
-      glDispatchCompute(numberOfBones, std::ceil(numberOfClips/ 32.0f), 1);
-      glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    /* reduce the bone positions to min and max per instance on the GPU */
+    mAssimpAABBLookupComputeShader.use();
 
-      /* extract bone matrix from SSBO */
-      mDownloadFromUBOTimer.start();
-      boneMatrix = mShaderBoneMatrixBuffer.getSsboDataMat4();
-      mRenderData.rdDownloadFromUBOTime += mDownloadFromUBOTimer.stop();
+    mUploadToUBOTimer.start();
+    mAssimpAABBLookupComputeShader.setUniformValue(static_cast<int>(numberOfBones));
+    boneMatrixBuffer.bind(0);
+    mShaderModelRootMatrixBuffer.uploadSsboData(rootTransformMat, 1);
+    mBoneUpdateInstanceBuffer.bind(2);
+    aabbBuffer.bind(3);
+    mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-      /* and loop over clips and bones */
-      for (size_t i = 0; i < numberOfClips; ++i) {
-        /* add first point */
-        glm::vec3 bonePos = (rootTransformMat * boneMatrix.at(numberOfBones * i))[3];
-        aabb.create(bonePos);
+    glDispatchCompute(std::ceil(batchSize / 32.0f), 1, 1);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
 
-        /* extend AABB for other points */
-        for (size_t j = 1; j < numberOfBones; ++j) {
-          /* Shader:  uint index = node + numberOfBones * instance; */
-          glm::vec3 bonePos = (rootTransformMat * boneMatrix.at(j + numberOfBones * i))[3];
-          aabb.addPoint(bonePos);
-        }
+    /* single readback per batch */
+    mDownloadFromUBOTimer.start();
+    std::vector<glm::vec4> aabbMinMax = aabbBuffer.getSsboDataVec4(batchSize * 2);
+    mRenderData.rdDownloadFromUBOTime += mDownloadFromUBOTimer.stop();
 
-        aabbLookups.at(i).emplace_back(aabb);
-      }
+    for (size_t i = 0; i < batchSize; ++i) {
+      size_t instance = batchStart + i;
+      aabbLookups.at(instance % numberOfClips).at(instance / numberOfClips).setExtents(
+        glm::vec3(aabbMinMax.at(i * 2)), glm::vec3(aabbMinMax.at(i * 2 + 1)));
     }
+  }
 
-    model->setAABBLookup(aabbLookups);
+  animDataBuffer.cleanup();
+  trsMatrixBuffer.cleanup();
+  boneMatrixBuffer.cleanup();
+  aabbBuffer.cleanup();
+
+  if (mRenderData.rdEnableAABBLookupCache) {
+    AABBLookupCache::save(cacheFileName, cacheKey, aabbLookups);
   }
+
+  model->setAABBLookup(aabbLookups);
 }
 
 void OGLRenderer::checkForInstanceCollisions() {
   /* get bounding box intersections */
-  mModelInstCamData.micInstanceCollisions = mOctree->findAllIntersections();
-
-  /* save bounding box collisions of non-animated instances */
-  std::set<std::pair<int, int>> nonAnimatedCollisions{};
-  for (const auto& instancePair : mModelInstCamData.micInstanceCollisions) {
-     if (!mModelInstCamData.micAssimpInstances.at(instancePair.first)->getModel()->hasAnimations() ||
-         !mModelInstCamData.micAssimpInstances.at(instancePair.second)->getModel()->hasAnimations()) {
-     nonAnimatedCollisions.insert(instancePair);
-    }
-  }
+  if (mRenderData.rdCollisionBroadphase == collisionBroadphase::sweepAndPrune) {
+    mInstanceSweepAndPrune.findAllIntersections(mModelInstCamData.micInstanceCollisions);
+  } else {
+    mInstanceGrid.findAllIntersections(mModelInstCamData.micInstanceCollisions);
+  }
 
+  mRenderData.rdNumberOfSpherePairTests = 0;
   if (mRenderData.rdCheckCollisions == collisionChecks::boundingSpheres) {
-    mBoundingSpheresPerInstance.clear();
-  /* calculate collision spheres per model */
-    std::map<std::string, std::set<int>> modelToInstanceMapping;
+    /* calculate collision spheres per model, non-animated instances keep the bounding box collision */
+    for (auto& collisionInstances : mSphereCollisionInstances) {
+      collisionInstances.second.clear();
+    }
 
     for (const auto& instancePair : mModelInstCamData.micInstanceCollisions) {
-      modelToInstanceMapping[mModelInstCamData.micAssimpInstances.at(instancePair.first)->getModel()->getModelFileName()].insert(instancePair.first);
-      modelToInstanceMapping[mModelInstCamData.micAssimpInstances.at(instancePair.second)->getModel()->getModelFileName()].insert(instancePair.second);
+      std::shared_ptr<AssimpModel> firstModel = mModelInstCamData.micAssimpInstances.at(instancePair.first)->getModel();
+      std::shared_ptr<AssimpModel> secondModel = mModelInstCamData.micAssimpInstances.at(instancePair.second)->getModel();
+      if (!firstModel->hasAnimations() || !secondModel->hasAnimations()) {
+        continue;
+      }
+
+      mSphereCollisionInstances[firstModel->getModelFileName()].emplace_back(instancePair.first);
+      mSphereCollisionInstances[secondModel->getModelFileName()].emplace_back(instancePair.second);
     }
 
-    for (const auto& collisionInstances : modelToInstanceMapping) {
+    /* an instance may collide with several others */
+    for (auto& collisionInstances : mSphereCollisionInstances) {
+      std::vector<int>& instanceIds = collisionInstances.second;
+      std::sort(instanceIds.begin(), instanceIds.end());
+      instanceIds.erase(std::unique(instanceIds.begin(), instanceIds.end()), instanceIds.end());
+    }
+
+    /* all spheres stay on the GPU, make room for the spheres of all models */
+    size_t totalNumberOfSpheres = 0;
+    for (const auto& collisionInstances : mSphereCollisionInstances) {
+      if (collisionInstances.second.empty()) {
+        continue;
+      }
+      totalNumberOfSpheres += collisionInstances.second.size() * getModel(collisionInstances.first)->getBoneList().size();
+    }
+    mCollisionSphereBuffer.checkForResize(totalNumberOfSpheres * sizeof(glm::vec4));
+
+    mSphereRangePerInstance.assign(mModelInstCamData.micAssimpInstances.size(), glm::uvec2(0));
+    size_t sphereOffset = 0;
+
+    for (const auto& collisionInstances : mSphereCollisionInstances) {
+      const std::vector<int>& instanceIds = collisionInstances.second;
+      if (instanceIds.empty()) {
+        continue;
+      }
       std::shared_ptr<AssimpModel> model = getModel(collisionInstances.first);
 
-      size_t numInstances = collisionInstances.second.size();
-      std::vector<int> instanceIds = std::vector(collisionInstances.second.begin(), collisionInstances.second.end());
+      size_t numInstances = instanceIds.size();
 
       size_t numberOfBones = model->getBoneList().size();
 
@@ -2444,7 +2980,7 @@ void OGLRenderer::checkForInstanceCollisions() {
       mBoundingSphereBuffer.checkForResize(numberOfSpheres * sizeof(glm::vec4));
 
       for (size_t i = 0; i < numInstances; ++i) {
-        InstanceSettings instSettings = mModelInstCamData.micAssimpInstances.at(instanceIds.at(i))->getInstanceSettings();
+        const InstanceSettings& instSettings = mModelInstCamData.micAssimpInstances.at(instanceIds.at(i))->getInstanceSettings();
 
         PerInstanceAnimData animData{};
         animData.firstAnimClipNum = instSettings.isFirstAnimClipNr;
@@ -2460,60 +2996,84 @@ void OGLRenderer::checkForInstanceCollisions() {
 
       runBoundingSphereComputeShaders(model, numberOfBones, numInstances);
 
-      /* read sphere SSBO per model */
-      std::vector<glm::vec4> boundingSpheres = mBoundingSphereBuffer.getSsboDataVec4(numberOfSpheres);
+      /* the sphere SSBO is reused by the next model, collect the spheres without a readback */
+      glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+      mCollisionSphereBuffer.copyFromBuffer(mBoundingSphereBuffer, 0, sphereOffset * sizeof(glm::vec4),
+        numberOfSpheres * sizeof(glm::vec4));
 
       for (size_t i = 0; i < numInstances; ++i) {
-        InstanceSettings instSettings = mModelInstCamData.micAssimpInstances.at(instanceIds.at(i))->getInstanceSettings();
+        const InstanceSettings& instSettings = mModelInstCamData.micAssimpInstances.at(instanceIds.at(i))->getInstanceSettings();
         int instanceIndex = instSettings.isInstanceIndexPosition;
-        mBoundingSpheresPerInstance[instanceIndex].resize(numberOfBones);
-
-        std::copy(boundingSpheres.begin() + i * numberOfBones, boundingSpheres.begin() + (i + 1) * numberOfBones, mBoundingSpheresPerInstance[instanceIndex].begin());
+        mSphereRangePerInstance.at(instanceIndex) = glm::uvec2(sphereOffset + i * numberOfBones, numberOfBones);
       }
+
+      sphereOffset += numberOfSpheres;
     }
 
     checkForBoundingSphereCollisions();
   }
 
-  /* add up non-animated collisions */
-  mModelInstCamData.micInstanceCollisions.merge(nonAnimatedCollisions);
-
   /* get (possibly cleaned) number of collisions */
   mRenderData.rdNumberOfCollisions = mModelInstCamData.micInstanceCollisions.size();
 
-  if (mRenderData.rdCheckCollisions != collisionChecks::none) {
-    reactToInstanceCollisions();
+  if (mRenderData.rdCheckCollisions == collisionChecks::none) {
+    /* contacts existing while the checks were disabled begin when they are enabled again */
+    mPreviousInstanceCollisions.clear();
+    mRenderData.rdNumberOfContactBegins = 0;
+    mRenderData.rdNumberOfContactEnds = 0;
+    return;
   }
+
+  /* both lists are sorted */
+  const std::vector<std::pair<int, int>>& instanceCollisions = mModelInstCamData.micInstanceCollisions;
+  mBeginInstanceCollisions.clear();
+  mEndInstanceCollisions.clear();
+  std::set_difference(instanceCollisions.begin(), instanceCollisions.end(),
+    mPreviousInstanceCollisions.begin(), mPreviousInstanceCollisions.end(), std::back_inserter(mBeginInstanceCollisions));
+  std::set_difference(mPreviousInstanceCollisions.begin(), mPreviousInstanceCollisions.end(),
+    instanceCollisions.begin(), instanceCollisions.end(), std::back_inserter(mEndInstanceCollisions));
+  mPreviousInstanceCollisions = instanceCollisions;
+
+  mRenderData.rdNumberOfContactBegins = mBeginInstanceCollisions.size();
+  mRenderData.rdNumberOfContactEnds = mEndInstanceCollisions.size();
+
+  reactToInstanceCollisions();
 }
 
 void OGLRenderer::checkForLevelCollisions() {
   mLevelCollidingTriangleMesh->vertices.clear();
 
   for (const auto& instance : mModelInstCamData.micAssimpInstances) {
-    InstanceSettings instSettings = instance->getInstanceSettings();
+    const InstanceSettings& instSettings = instance->getInstanceSettings();
     if (instSettings.isInstanceIndexPosition == 0) {
       continue;
     }
-    mRenderData.rdNumberOfCollidingTriangles += instSettings.isCollidingTriangles.size();
+    const std::vector<int>& collidingTriangles = instance->getCollidingTriangles();
+    mRenderData.rdNumberOfCollidingTriangles += collidingTriangles.size();
+
+    float minGroundNormalY = std::cos(glm::radians(mRenderData.rdMaxLevelGroundSlopeAngle));
 
+    /* find triangle we are walking on, the closest walkable triangle below the middle of the instance */
     instance->setCurrentGroundTriangleIndex(-1);
-    for (const auto& tri : instSettings.isCollidingTriangles) {
+    if (!collidingTriangles.empty()) {
+      AABB instanceAABB = instance->getModel()->getAABB(instSettings);
+      float instanceHeight = instanceAABB.getMaxPos().y - instanceAABB.getMinPos().y;
+      float instanceHalfHeight = instanceHeight / 2.0f;
+      TriangleBVHRayHit groundHit{};
+      if (mTriangleBVH->rayCast(instSettings.isWorldPosition + glm::vec3(0.0f, instanceHalfHeight, 0.0f),
+          glm::vec3(0.0f, -instanceHeight, 0.0f), groundHit, minGroundNormalY)) {
+        instance->setCurrentGroundTriangleIndex(groundHit.triIndex);
+      }
+    }
+
+    for (const auto triIndex : collidingTriangles) {
+      const MeshTriangle& tri = mTriangleBVH->getTriangle(triIndex);
       glm::vec3 vertexColor = glm::vec3(1.0f, 1.0f, 1.0f);
 
       /* check for slope */
       bool isWalkable = false;
-      if (glm::dot(tri.normal, glm::vec3(0.0f, 1.0f, 0.0f)) >= std::cos(glm::radians(mRenderData.rdMaxLevelGroundSlopeAngle))) {
+      if (tri.normal.y >= minGroundNormalY) {
         isWalkable = true;
-
-        /* find triangle we are walking on */
-        AABB instanceAABB = instance->getModel()->getAABB(instSettings);
-        float instanceHeight = instanceAABB.getMaxPos().y - instanceAABB.getMinPos().y;
-        float instanceHalfHeight = instanceHeight / 2.0f;
-        std::optional<glm::vec3> result = Tools::rayTriangleIntersection(instSettings.isWorldPosition +
-          glm::vec3(0.0f, instanceHalfHeight, 0.0f), glm::vec3(0.0f, -instanceHeight, 0.0f), tri);
-        if (result.has_value()) {
-          instance->setCurrentGroundTriangleIndex(tri.index);
-        }
       }
 
       /* stair handling */
@@ -2543,7 +3103,7 @@ void OGLRenderer::checkForLevelCollisions() {
       } else {
         vertexColor = glm::vec3(1.0f, 0.0f, 0.0f);
         /* fire wall collision event only when instance is on ground */
-        if (instSettings.isInstanceOnGround) {
+        if (instance->isInstanceOnGround()) {
           mModelInstCamData.micNodeEventCallbackFunction(instance, nodeEvent::instanceToLevelCollision);
         }
       }
@@ -2579,9 +3139,9 @@ void OGLRenderer::checkForBorderCollisions() {
       continue;
     }
 
-    std::vector<std::shared_ptr<AssimpInstance>> instances = instancesPerModel.second;
+    const std::vector<std::shared_ptr<AssimpInstance>>& instances = instancesPerModel.second;
     for (size_t i = 0; i < instances.size(); ++i) {
-      InstanceSettings instSettings = instances.at(i)->getInstanceSettings();
+      const InstanceSettings& instSettings = instances.at(i)->getInstanceSettings();
 
       /* check world borders */
       AABB instanceAABB = model->getAABB(instSettings);
@@ -2597,79 +3157,110 @@ void OGLRenderer::checkForBorderCollisions() {
 }
 
 void OGLRenderer::checkForBoundingSphereCollisions() {
-  std::set<std::pair<int, int>> sphereCollisions{};
-
-  for (const auto& instancePairs : mModelInstCamData.micInstanceCollisions) {
-    int firstId = instancePairs.first;
-    int secondId = instancePairs.second;
+  std::vector<std::pair<int, int>>& instanceCollisions = mModelInstCamData.micInstanceCollisions;
 
-    /* brute force check of sphere vs sphere */
-    bool collisionDetected = false;
+  /* keep the bounding box collisions of non-animated instances */
+  mKeepInstanceCollisions.assign(instanceCollisions.size(), false);
 
-    for (size_t first = 0; first < mBoundingSpheresPerInstance[firstId].size(); ++first) {
-      glm::vec4 firstSphereData = mBoundingSpheresPerInstance[firstId].at(first);
-      float firstRadius = firstSphereData.w;
+  mSpherePairs.clear();
+  mSpherePairCollisionIndices.clear();
+  for (size_t i = 0; i < instanceCollisions.size(); ++i) {
+    int firstId = instanceCollisions.at(i).first;
+    int secondId = instanceCollisions.at(i).second;
 
-      /* no need to check disabled spheres */
-      if (firstRadius == 0.0f) {
-        continue;
-      }
+    if (!mModelInstCamData.micAssimpInstances.at(firstId)->getModel()->hasAnimations() ||
+        !mModelInstCamData.micAssimpInstances.at(secondId)->getModel()->hasAnimations()) {
+      mKeepInstanceCollisions.at(i) = true;
+      continue;
+    }
 
-      glm::vec3 firstSpherePos = glm::vec3(firstSphereData.x, firstSphereData.y, firstSphereData.z);
+    SpherePair spherePair{};
+    spherePair.firstOffset = mSphereRangePerInstance.at(firstId).x;
+    spherePair.firstCount = mSphereRangePerInstance.at(firstId).y;
+    spherePair.secondOffset = mSphereRangePerInstance.at(secondId).x;
+    spherePair.secondCount = mSphereRangePerInstance.at(secondId).y;
+    mSpherePairs.emplace_back(spherePair);
+    mSpherePairCollisionIndices.emplace_back(i);
+  }
 
-      for (size_t second = 0; second < mBoundingSpheresPerInstance[secondId].size(); ++second) {
-        glm::vec4 secondSphereData = mBoundingSpheresPerInstance[secondId].at(second);
-        float secondRadius = secondSphereData.w;
+  mRenderData.rdNumberOfSpherePairTests = mSpherePairs.size();
 
-        /* no need to check disabled spheres */
-        if (secondRadius == 0.0f) {
-          continue;
-        }
+  if (!mSpherePairs.empty()) {
+    size_t numberOfPairs = mSpherePairs.size();
 
-        glm::vec3 secondSpherePos = glm::vec3(secondSphereData.x, secondSphereData.y, secondSphereData.z);
+    /* resize first, a resize drops the buffer contents */
+    mCollidingPairBuffer.checkForResize((numberOfPairs + 1) * sizeof(uint32_t));
+    uint32_t numberOfCollidingPairs = 0;
+    mCollidingPairBuffer.uploadSsboData(numberOfCollidingPairs);
 
-        /* check for intersections  */
-        glm::vec3 centerDistance = firstSpherePos - secondSpherePos;
-        float centerDistanceSquared = glm::dot(centerDistance, centerDistance);
+    mAssimpSphereCollisionComputeShader.use();
 
-        float sphereRadiusSum = firstRadius + secondRadius;
-        float sphereRadiusSumSquared = sphereRadiusSum * sphereRadiusSum;
+    mUploadToUBOTimer.start();
+    mCollisionSphereBuffer.bind(0);
+    mSpherePairBuffer.uploadSsboData(mSpherePairs, 1);
+    mCollidingPairBuffer.bind(2);
+    mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-        /* flag as a hit and exit immediately */
-        if (centerDistanceSquared <= sphereRadiusSumSquared) {
-          collisionDetected = true;
-          break;
-        }
-      }
+    /* one work group per pair, split into two dimensions to stay below the work group count limit */
+    size_t groupsX = std::min<size_t>(numberOfPairs, 65535);
+    size_t groupsY = (numberOfPairs + groupsX - 1) / groupsX;
+    glDispatchCompute(groupsX, groupsY, 1);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    /* read only the counter and the colliding pairs */
+    mDownloadFromUBOTimer.start();
+    numberOfCollidingPairs = mCollidingPairBuffer.getSsboDataUInt(0, 1).at(0);
+    numberOfCollidingPairs = std::min<uint32_t>(numberOfCollidingPairs, numberOfPairs);
+    mCollidingSpherePairs.clear();
+    if (numberOfCollidingPairs > 0) {
+      mCollidingPairBuffer.getSsboDataUInt(1, numberOfCollidingPairs, mCollidingSpherePairs);
+    }
+    mRenderData.rdDownloadFromUBOTime += mDownloadFromUBOTimer.stop();
 
-      if (collisionDetected) {
-        break;
+    for (const auto pairIndex : mCollidingSpherePairs) {
+      if (pairIndex < numberOfPairs) {
+        mKeepInstanceCollisions.at(mSpherePairCollisionIndices.at(pairIndex)) = true;
       }
     }
+  }
 
-    /* store collisions in set */
-    if (collisionDetected) {
-      sphereCollisions.insert({firstId, secondId});
+  /* the GPU appends in random order, compact in place to keep the pairs sorted */
+  size_t numberOfSphereCollisions = 0;
+  for (size_t i = 0; i < instanceCollisions.size(); ++i) {
+    if (mKeepInstanceCollisions.at(i)) {
+      instanceCollisions.at(numberOfSphereCollisions++) = instanceCollisions.at(i);
     }
   }
 
-  /* replace collided instance data with new ones */
-  mModelInstCamData.micInstanceCollisions.clear();
-  mModelInstCamData.micInstanceCollisions.insert(sphereCollisions.begin(), sphereCollisions.end());
+  /* remove the pairs without a sphere collision */
+  instanceCollisions.resize(numberOfSphereCollisions);
 }
 
 void OGLRenderer::reactToInstanceCollisions() {
-  std::vector<std::shared_ptr<AssimpInstance>> instances = mModelInstCamData.micAssimpInstances;
+  const std::vector<std::shared_ptr<AssimpInstance>>& instances = mModelInstCamData.micAssimpInstances;
+
+  if (mRenderData.rdCollisionEventsOnContactChange) {
+    for (const auto& instancePairs : mBeginInstanceCollisions) {
+      mModelInstCamData.micNodeEventCallbackFunction(instances.at(instancePairs.first), nodeEvent::instanceToInstanceCollision);
+      mModelInstCamData.micNodeEventCallbackFunction(instances.at(instancePairs.second), nodeEvent::instanceToInstanceCollision);
+    }
+    for (const auto& instancePairs : mEndInstanceCollisions) {
+      mModelInstCamData.micNodeEventCallbackFunction(instances.at(instancePairs.first), nodeEvent::instanceToInstanceCollisionEnd);
+      mModelInstCamData.micNodeEventCallbackFunction(instances.at(instancePairs.second), nodeEvent::instanceToInstanceCollisionEnd);
+    }
+  }
 
   for (const auto& instancePairs : mModelInstCamData.micInstanceCollisions) {
     std::shared_ptr<AssimpInstance> firstInstance = instances.at(instancePairs.first);
-    InstanceSettings firstInstSettings = firstInstance->getInstanceSettings();
+    const InstanceSettings& firstInstSettings = firstInstance->getInstanceSettings();
 
     std::shared_ptr<AssimpInstance> secondInstance = instances.at(instancePairs.second);
-    InstanceSettings secondInstSettings = secondInstance->getInstanceSettings();
+    const InstanceSettings& secondInstSettings = secondInstance->getInstanceSettings();
 
-    mModelInstCamData.micNodeEventCallbackFunction(firstInstance, nodeEvent::instanceToInstanceCollision);
-    mModelInstCamData.micNodeEventCallbackFunction(secondInstance, nodeEvent::instanceToInstanceCollision);
+    if (!mRenderData.rdCollisionEventsOnContactChange) {
+      mModelInstCamData.micNodeEventCallbackFunction(firstInstance, nodeEvent::instanceToInstanceCollision);
+      mModelInstCamData.micNodeEventCallbackFunction(secondInstance, nodeEvent::instanceToInstanceCollision);
+    }
 
     /* disable navigation if we collide with target */
     if (firstInstSettings.isNavigationEnabled && firstInstSettings.isPathTargetInstance == secondInstSettings.isInstanceIndexPosition) {
@@ -2695,17 +3286,19 @@ void OGLRenderer::findInteractionInstances() {
     return;
   }
   std::shared_ptr<AssimpInstance> currentInstance = mModelInstCamData.micAssimpInstances.at(mModelInstCamData.micSelectedInstance);
-  InstanceSettings curInstSettings = currentInstance->getInstanceSettings();
+  const InstanceSettings& curInstSettings = currentInstance->getInstanceSettings();
 
   /* query octree with a bounding box */
   glm::vec3 instancePos = curInstSettings.isWorldPosition;
   glm::vec3 querySize = glm::vec3(mRenderData.rdInteractionMaxRange);
   BoundingBox3D queryBox = BoundingBox3D(instancePos - querySize / 2.0f, querySize);
 
-  std::set<int> queriedNearInstances = mOctree->query(queryBox);
+  std::vector<int> queriedNearInstances{};
+  mInstanceGrid.query(queryBox, queriedNearInstances);
 
   /* skip ourselve */
-  queriedNearInstances.erase(curInstSettings.isInstanceIndexPosition);
+  queriedNearInstances.erase(std::remove(queriedNearInstances.begin(), queriedNearInstances.end(),
+    curInstSettings.isInstanceIndexPosition), queriedNearInstances.end());
 
   if (queriedNearInstances.empty()) {
     return;
@@ -2714,7 +3307,7 @@ void OGLRenderer::findInteractionInstances() {
   std::set<int> nearInstances{};
   for (const auto& id : queriedNearInstances) {
     std::shared_ptr<AssimpInstance> instance = mModelInstCamData.micAssimpInstances.at(id);
-    InstanceSettings instSettings = instance->getInstanceSettings();
+    const InstanceSettings& instSettings = instance->getInstanceSettings();
 
     float distance = glm::length(instSettings.isWorldPosition - curInstSettings.isWorldPosition);
     if (distance > mRenderData.rdInteractionMinRange) {
@@ -2735,7 +3328,7 @@ void OGLRenderer::findInteractionInstances() {
   std::set<int> instancesFacingToUs{};
   for (const auto& id : nearInstances) {
     std::shared_ptr<AssimpInstance> instance = mModelInstCamData.micAssimpInstances.at(id);
-    InstanceSettings instSettings = instance->getInstanceSettings();
+    const InstanceSettings& instSettings = instance->getInstanceSettings();
 
     glm::vec3 distanceVector = glm::normalize(instSettings.isWorldPosition - curInstSettings.isWorldPosition);
     float angle = glm::degrees(glm::acos(glm::dot(currentInstance->get2DRotationVector(), distanceVector)));
@@ -2757,7 +3350,7 @@ void OGLRenderer::findInteractionInstances() {
   std::vector<std::pair<float, int>> sortedDistances;
   for (const auto& id : instancesFacingToUs) {
     std::shared_ptr<AssimpInstance> instance = mModelInstCamData.micAssimpInstances.at(id);
-    InstanceSettings instSettings = instance->getInstanceSettings();
+    const InstanceSettings& instSettings = instance->getInstanceSettings();
 
     float distance = glm::length(instSettings.isWorldPosition - curInstSettings.isWorldPosition);
     sortedDistances.emplace_back(std::make_pair(distance, id));
@@ -2783,7 +3376,7 @@ void OGLRenderer::drawInteractionDebug() {
   vertex.color = aabbColor;
 
   std::shared_ptr<AssimpInstance> instance = mModelInstCamData.micAssimpInstances.at(mModelInstCamData.micSelectedInstance);
-  InstanceSettings instSettings = instance->getInstanceSettings();
+  const InstanceSettings& instSettings = instance->getInstanceSettings();
 
   if (mRenderData.rdDrawInteractionRange) {
     glm::vec3 instancePos = instSettings.isWorldPosition;
@@ -2845,7 +3438,7 @@ void OGLRenderer::drawInteractionDebug() {
 
     for (const auto id : drawFOVLines) {
       std::shared_ptr<AssimpInstance> fovInstance = mModelInstCamData.micAssimpInstances.at(id);
-      InstanceSettings fovInstSettings = fovInstance->getInstanceSettings();
+      const InstanceSettings& fovInstSettings = fovInstance->getInstanceSettings();
 
       vertex.position = fovInstSettings.isWorldPosition;
       InteractionMesh.vertices.emplace_back(vertex);
@@ -2901,7 +3494,7 @@ void OGLRenderer::drawInteractionDebug() {
   drawAABBs(instancesToDraw, aabbColor);
 }
 
-void OGLRenderer::drawAABBs(std::vector<std::shared_ptr<AssimpInstance>> instances, glm::vec4 aabbColor) {
+void OGLRenderer::drawAABBs(const std::vector<std::shared_ptr<AssimpInstance>>& instances, glm::vec4 aabbColor) {
   std::shared_ptr<OGLLineMesh> aabbLineMesh = nullptr;;
 
   mAABBMesh->vertices.clear();
@@ -2909,7 +3502,7 @@ void OGLRenderer::drawAABBs(std::vector<std::shared_ptr<AssimpInstance>> instanc
   mAABBMesh->vertices.resize(instances.size() * instanceAABB.getAABBLines(aabbColor)->vertices.size());
 
   for (size_t i = 0; i < instances.size(); ++i) {
-    InstanceSettings instSettings = instances.at(i)->getInstanceSettings();
+    const InstanceSettings& instSettings = instances.at(i)->getInstanceSettings();
 
     /* skip null instance */
     if (instSettings.isInstanceIndexPosition == 0) {
@@ -2945,18 +3538,17 @@ void OGLRenderer::resetLevelData() {
   mRenderData.rdWorldStartPos = mWorldBoundaries->getFrontTopLeft();
   mRenderData.rdWorldSize = mWorldBoundaries->getSize();
   initOctree(mRenderData.rdOctreeThreshold, mRenderData.rdOctreeMaxDepth);
-  initTriangleOctree(mRenderData.rdOctreeThreshold, mRenderData.rdOctreeMaxDepth);
+  mTriangleBVH->clear();
 
   mRenderData.rdDrawLevelAABB = false;
   mRenderData.rdDrawLevelWireframe = false;
   mRenderData.rdDrawLevelWireframeMiniMap = false;
-  mRenderData.rdDrawLevelOctree = false;
+  mRenderData.rdDrawLevelBVH = false;
   mRenderData.rdDrawLevelCollisionTriangles = false;
   mRenderData.rdEnableSimpleGravity = false;
 
   mRenderData.rdMaxLevelGroundSlopeAngle = 0.0f;
-  mRenderData.rdLevelOctreeThreshold = 10;
-  mRenderData.rdLevelOctreeMaxDepth = 5;
+  mRenderData.rdLevelBVHMaxLeafTriangles = 4;
 
   mRenderData.rdEnableFeetIK = false;
   mRenderData.rdDrawIKDebugLines = false;
@@ -3014,10 +3606,10 @@ void OGLRenderer::drawLevelWireframe() {
   }
 }
 
-void OGLRenderer::drawLevelOctree() {
-  if (!mLevelOctreeMesh->vertices.empty()) {
+void OGLRenderer::drawLevelBVH() {
+  if (!mLevelBVHMesh->vertices.empty()) {
     mLineShader.use();
-    mLevelOctreeVertexBuffer.bindAndDraw(GL_LINES, 0, mLevelOctreeMesh->vertices.size());
+    mLevelBVHVertexBuffer.bindAndDraw(GL_LINES, 0, mLevelBVHMesh->vertices.size());
   }
 }
 
@@ -3149,7 +3741,7 @@ void OGLRenderer::drawSelectedBoundingSpheres() {
     mShaderTRSMatrixBuffer.checkForResize(trsMatrixSize);
 
     mBoundingSphereBuffer.checkForResize(numberOfSpheres * sizeof(glm::vec4));
-    InstanceSettings instSettings = instance->getInstanceSettings();
+    const InstanceSettings& instSettings = instance->getInstanceSettings();
 
     PerInstanceAnimData animData{};
     animData.firstAnimClipNum = instSettings.isFirstAnimClipNr;
@@ -3210,7 +3802,7 @@ void OGLRenderer::drawCollidingBoundingSpheres() {
     mBoundingSphereBuffer.checkForResize(numberOfSpheres * sizeof(glm::vec4));
 
     for (size_t i = 0; i < instanceIds.size(); ++i) {
-      InstanceSettings instSettings = mModelInstCamData.micAssimpInstances.at(instanceIds.at(i))->getInstanceSettings();
+      const InstanceSettings& instSettings = mModelInstCamData.micAssimpInstances.at(instanceIds.at(i))->getInstanceSettings();
 
       PerInstanceAnimData animData{};
       animData.firstAnimClipNum = instSettings.isFirstAnimClipNr;
@@ -3244,7 +3836,7 @@ void OGLRenderer::drawAllBoundingSpheres() {
       continue;
     }
     std::string modelName = model->getModelFileName();
-    std::vector<std::shared_ptr<AssimpInstance>> instances = mModelInstCamData.micAssimpInstancesPerModel[modelName];
+    const std::vector<std::shared_ptr<AssimpInstance>>& instances = mModelInstCamData.micAssimpInstancesPerModel[modelName];
 
     size_t numberOfBones = model->getBoneList().size();
     size_t numInstances = instances.size();
@@ -3264,7 +3856,7 @@ void OGLRenderer::drawAllBoundingSpheres() {
     mBoundingSphereBuffer.checkForResize(numberOfSpheres * sizeof(glm::vec4));
 
     for (int i = 0; i < numInstances; ++i) {
-      InstanceSettings instSettings = instances.at(i)->getInstanceSettings();
+      const InstanceSettings& instSettings = instances.at(i)->getInstanceSettings();
 
       PerInstanceAnimData animData{};
       animData.firstAnimClipNum = instSettings.isFirstAnimClipNr;
@@ -3294,19 +3886,23 @@ void OGLRenderer::drawAllBoundingSpheres() {
 
 
 void OGLRenderer::runBoundingSphereComputeShaders(std::shared_ptr<AssimpModel> model, int numberOfBones, int numInstances) {
-  ModelSettings modSettings = model->getModelSettings();
+  const ModelSettings& modSettings = model->getModelSettings();
 
   /* we MUST set the bone offsets to identity matrices to get the skeleton data */
   std::vector<glm::mat4> emptyBoneOffsets(numberOfBones * numInstances, glm::mat4(1.0f));
   mEmptyBoneOffsetBuffer.uploadSsboData(emptyBoneOffsets);
 
+  uploadAllBoneUpdateInstances(numInstances);
+
   /* do a single iteration of all clips in parallel */
-  mAssimpTransformComputeShader.use();
+  getTransformComputeShader(model, false).use();
 
   mUploadToUBOTimer.start();
   model->bindAnimLookupBuffer(0);
   mPerInstanceAnimDataBuffer.uploadSsboData(mPerInstanceAnimData, 1);
   mShaderTRSMatrixBuffer.bind(2);
+  mBoneUpdateInstanceBuffer.bind(3);
+  model->bindBoneParentBuffer(4);
   mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
   glDispatchCompute(numberOfBones, std::ceil(numInstances/32.0f), 1);
@@ -3319,6 +3915,7 @@ void OGLRenderer::runBoundingSphereComputeShaders(std::shared_ptr<AssimpModel> m
   model->bindBoneParentBuffer(1);
   mEmptyBoneOffsetBuffer.bind(2);
   mShaderBoneMatrixBuffer.bind(3);
+  mBoneUpdateInstanceBuffer.bind(4);
   mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
   glDispatchCompute(numberOfBones, std::ceil(numInstances/32.0f), 1);
@@ -3347,6 +3944,679 @@ void OGLRenderer::drawSkybox() {
   mSkyboxTexture.unbindCubemap();
 }
 
+void OGLRenderer::updateInstanceSimulation(std::shared_ptr<AssimpInstance> instance, float deltaTime) {
+  std::shared_ptr<AssimpModel> model = instance->getModel();
+  bool animatedModel = model->hasAnimations() && !model->getBoneList().empty();
+
+  /* AABB and world position must be taken BEFORE the animation update changes the settings */
+  const InstanceSettings& instSettings = instance->getInstanceSettings();
+  AABB instanceAABB = model->getAABB(instSettings);
+  glm::vec3 instanceWorldPos = instSettings.isWorldPosition;
+
+  if (animatedModel) {
+    instance->updateAnimation(deltaTime);
+  }
+
+  /* calculate 3D boundaries */
+
+  glm::vec3 position = instanceAABB.getMinPos();
+  glm::vec3 size = glm::vec3(std::fabs(instanceAABB.getMaxPos().x - instanceAABB.getMinPos().x),
+                             std::fabs(instanceAABB.getMaxPos().y - instanceAABB.getMinPos().y),
+                             std::fabs(instanceAABB.getMaxPos().z - instanceAABB.getMinPos().z));
+
+  BoundingBox3D box{position, size};
+  instance->setBoundingBox(box);
+
+  /* gravity and ground collisions */
+
+  /* extend the AABB a bit below the feet to allow a better ground collision handling */
+  glm::vec3 instBoxPos = position - mRenderData.rdLevelCollisionAABBExtension;
+  glm::vec3 instBoxSize = size + mRenderData.rdLevelCollisionAABBExtension;
+  BoundingBox3D instanceBox{instBoxPos, instBoxSize};
+
+  /* one buffer per worker thread, keeps its capacity between the frames */
+  thread_local std::vector<int> collidingTriangles{};
+  collidingTriangles.clear();
+  mTriangleBVH->query(instanceBox, collidingTriangles);
+  instance->setCollidingTriangles(collidingTriangles);
+
+  /* set state to "instance on ground" if gravity is disabled */
+  bool instanceOnGround = true;
+  if (mRenderData.rdEnableSimpleGravity) {
+    glm::vec3 gravity = glm::vec3(0.0f, GRAVITY_CONSTANT * deltaTime, 0.0f);
+    glm::vec3 footPoint = instanceWorldPos;
+
+    instanceOnGround = false;
+    for (const auto triIndex : collidingTriangles) {
+      const MeshTriangle& tri = mTriangleBVH->getTriangle(triIndex);
+      /* check for slope */
+      bool isWalkable = false;
+      if (glm::dot(tri.normal, glm::vec3(0.0f, 1.0f, 0.0f)) >= std::cos(glm::radians(mRenderData.rdMaxLevelGroundSlopeAngle))) {
+        isWalkable = true;
+      }
+
+      if (isWalkable) {
+        std::optional<glm::vec3> result = Tools::rayTriangleIntersection(instanceWorldPos - gravity, glm::vec3(0.0f, 1.0f, 0.0f), tri);
+        if (result.has_value()) {
+          footPoint = result.value();
+          instance->setWorldPosition(footPoint);
+          instanceOnGround = true;
+        }
+      }
+    }
+  }
+  instance->setInstanceOnGround(instanceOnGround);
+  instance->applyGravity(deltaTime);
+
+  /* update instance speed and position */
+  if (animatedModel) {
+    instance->updateInstanceSpeed(deltaTime);
+  }
+  instance->updateInstancePosition(deltaTime);
+}
+
+void OGLRenderer::updateInstancePath(std::shared_ptr<AssimpInstance> instance, float deltaTime, std::vector<OGLLineVertex>& pathVertices) {
+  const InstanceSettings& instSettings = instance->getInstanceSettings();
+  int currentGroundTriIndex = instance->getCurrentGroundTriangleIndex();
+
+  int pathTargetInstance = instSettings.isPathTargetInstance;
+
+  /* invalid target, reset */
+  if (pathTargetInstance >= mModelInstCamData.micAssimpInstances.size()) {
+    pathTargetInstance = -1;
+    instance->setPathTargetInstanceId(pathTargetInstance);
+  }
+
+  int pathTargetInstanceTriIndex = -1;
+  glm::vec3 pathTargetWorldPos = glm::vec3(0.0f);
+  if (pathTargetInstance != -1) {
+    /* target instance is always valid here */
+    std::shared_ptr<AssimpInstance> targetInstance = mModelInstCamData.micAssimpInstances.at(pathTargetInstance);
+    pathTargetInstanceTriIndex = targetInstance->getCurrentGroundTriangleIndex();
+    pathTargetWorldPos = targetInstance->getWorldPosition();
+  }
+
+  if (mRenderData.rdUseFlowFields) {
+    updateInstanceFlowFieldPath(instance, pathTargetInstance, pathTargetInstanceTriIndex, pathTargetWorldPos, deltaTime, pathVertices);
+    return;
+  }
+
+  /* do a path update only if both start and end triangle indices are valid and we or target changed its triangle */
+  if ((currentGroundTriIndex > -1 && pathTargetInstanceTriIndex > -1) &&
+      (currentGroundTriIndex != instance->getPathStartTriIndex() ||
+      pathTargetInstanceTriIndex != instance->getPathTargetTriIndex())) {
+    instance->setPathStartTriIndex(currentGroundTriIndex);
+    instance->setPathTargetTriIndex(pathTargetInstanceTriIndex);
+
+    if (mRenderData.rdEnableAsyncPathFinding) {
+      /* keep walking on the old path, instances without a path are searched first */
+      int priority = instance->getPathToTarget().empty() ? 1 : 0;
+      mPathService.requestPath(instSettings.isInstanceIndexPosition, currentGroundTriIndex, pathTargetInstanceTriIndex,
+        priority, mRenderData.rdUseHierarchicalPathFinding);
+    } else {
+      /* per-thread result of the path finder, copied into the instance */
+      const std::vector<int>& pathToTarget = mPathFinder.findPath(currentGroundTriIndex, pathTargetInstanceTriIndex,
+        mRenderData.rdUseHierarchicalPathFinding);
+      ++mPathQueries;
+      mPathNodesExpanded += PathFinder::getLastNodesExpanded();
+
+      /* disable navigation if target is unreachable */
+      if (pathToTarget.empty()) {
+        instance->setNavigationEnabled(false);
+        instance->setPathTargetInstanceId(-1);
+      } else {
+        instance->setPathToTarget(pathToTarget);
+      }
+    }
+  }
+
+  const std::vector<int>& pathToTarget = instance->getPathToTarget();
+
+  /* skip first and last elements, they are the target centers of start and target triangles */
+  size_t pathStart = 1;
+  size_t pathEnd = pathToTarget.size() > 1 ? pathToTarget.size() - 1 : pathToTarget.size();
+  bool pathEmpty = pathEnd <= pathStart;
+
+  /* navigate to target */
+  if (!pathEmpty) {
+    /* navigate to next triangle, not the one we may stand on (start triangle)*/
+    int nextTarget = pathToTarget.at(pathStart);
+    glm::vec3 destPos = mPathFinder.getTriangleCenter(nextTarget);
+    instance->rotateTo(destPos, deltaTime);
+  } else {
+    /* empty path means we have only the target itself left */
+    instance->rotateTo(pathTargetWorldPos, deltaTime);
+  }
+
+  if (mRenderData.rdDrawInstancePaths && pathTargetInstance > -1) {
+    glm::vec3 pathColor = glm::vec3(0.4f, 1.0f, 0.4f);
+    glm::vec3 pathYOffset = glm::vec3(0.0f, 1.0f, 0.0f);
+
+    OGLLineVertex vert;
+    vert.color = pathColor;
+
+    vert.position = instSettings.isWorldPosition + pathYOffset;
+    pathVertices.emplace_back(vert);
+
+    if (!pathEmpty) {
+      vert.position = mPathFinder.getTriangleCenter(pathToTarget.at(pathStart)) + pathYOffset;
+      pathVertices.emplace_back(vert);
+
+      std::shared_ptr<OGLLineMesh> pathMesh =
+        mPathFinder.getAsLineMesh(std::vector<int>(pathToTarget.begin() + pathStart, pathToTarget.begin() + pathEnd),
+        pathColor, pathYOffset);
+
+      pathVertices.insert(pathVertices.end(), pathMesh->vertices.begin(), pathMesh->vertices.end());
+
+      vert.position = mPathFinder.getTriangleCenter(pathToTarget.at(pathEnd - 1)) + pathYOffset;
+      pathVertices.emplace_back(vert);
+    }
+
+    vert.position = pathTargetWorldPos + pathYOffset;
+    pathVertices.emplace_back(vert);
+  }
+}
+
+void OGLRenderer::updateInstanceFlowFieldPath(std::shared_ptr<AssimpInstance> instance, int pathTargetInstance,
+    int pathTargetTriIndex, glm::vec3 pathTargetWorldPos, float deltaTime, std::vector<OGLLineVertex>& pathVertices) {
+  if (pathTargetInstance == -1) {
+    return;
+  }
+
+  /* the map is not changed during the parallel path update */
+  auto flowFieldIter = mFlowFields.find(pathTargetInstance);
+  int currentGroundTriIndex = instance->getCurrentGroundTriangleIndex();
+  if (flowFieldIter == mFlowFields.end() || currentGroundTriIndex == -1) {
+    instance->rotateTo(pathTargetWorldPos, deltaTime);
+    return;
+  }
+  const FlowField& flowField = *flowFieldIter->second;
+
+  /* disable navigation if target is unreachable */
+  if (mPathFinder.isFlowFieldValid(flowField, pathTargetTriIndex) && !mPathFinder.isFlowFieldReachable(flowField, currentGroundTriIndex)) {
+    instance->setNavigationEnabled(false);
+    instance->setPathTargetInstanceId(-1);
+    return;
+  }
+
+  /* no next triangle means we stand on the target triangle */
+  int nextTarget = mPathFinder.getFlowFieldNextTriangle(flowField, currentGroundTriIndex);
+  if (nextTarget != -1) {
+    instance->rotateTo(mPathFinder.getTriangleCenter(nextTarget), deltaTime);
+  } else {
+    instance->rotateTo(pathTargetWorldPos, deltaTime);
+  }
+
+  if (mRenderData.rdDrawInstancePaths) {
+    glm::vec3 pathColor = glm::vec3(0.4f, 0.8f, 1.0f);
+    glm::vec3 pathYOffset = glm::vec3(0.0f, 1.0f, 0.0f);
+
+    OGLLineVertex vert;
+    vert.color = pathColor;
+    vert.position = instance->getWorldPosition() + pathYOffset;
+    pathVertices.emplace_back(vert);
+
+    /* follow the field, the step limit protects against loops in a field of an old graph */
+    size_t maxSteps = flowField.nextNavIndex.size();
+    for (size_t step = 0; nextTarget != -1 && step < maxSteps; ++step) {
+      vert.position = mPathFinder.getTriangleCenter(nextTarget) + pathYOffset;
+      pathVertices.emplace_back(vert);
+      pathVertices.emplace_back(vert);
+      nextTarget = mPathFinder.getFlowFieldNextTriangle(flowField, nextTarget);
+    }
+
+    vert.position = pathTargetWorldPos + pathYOffset;
+    pathVertices.emplace_back(vert);
+  }
+}
+
+void OGLRenderer::updateFlowFields() {
+  mRenderData.rdNumberOfFlowFieldRebuilds = 0;
+
+  /* all targets with at least one navigating instance */
+  mFlowFieldTargets.clear();
+  for (const auto& instance : mWorldUpdateAnimatedInstances) {
+    int pathTargetInstance = instance->getInstanceSettings().isPathTargetInstance;
+    if (instance->isNavigationEnabled() && pathTargetInstance > -1 &&
+        pathTargetInstance < static_cast<int>(mModelInstCamData.micAssimpInstances.size())) {
+      mFlowFieldTargets.emplace_back(pathTargetInstance);
+    }
+  }
+  std::sort(mFlowFieldTargets.begin(), mFlowFieldTargets.end());
+  mFlowFieldTargets.erase(std::unique(mFlowFieldTargets.begin(), mFlowFieldTargets.end()), mFlowFieldTargets.end());
+
+  /* drop fields nobody walks to anymore */
+  for (auto iter = mFlowFields.begin(); iter != mFlowFields.end();) {
+    if (!std::binary_search(mFlowFieldTargets.begin(), mFlowFieldTargets.end(), iter->first)) {
+      iter = mFlowFields.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  /* only a target that changed its triangle needs a new field */
+  mDirtyFlowFields.clear();
+  mDirtyFlowFieldTargetTris.clear();
+  for (const auto target : mFlowFieldTargets) {
+    int targetTriIndex = mModelInstCamData.micAssimpInstances.at(target)->getCurrentGroundTriangleIndex();
+    if (targetTriIndex == -1) {
+      continue;
+    }
+
+    std::unique_ptr<FlowField>& flowField = mFlowFields[target];
+    if (!flowField) {
+      flowField = std::make_unique<FlowField>();
+    }
+
+    if (!mPathFinder.isFlowFieldValid(*flowField, targetTriIndex)) {
+      mDirtyFlowFields.emplace_back(flowField.get());
+      mDirtyFlowFieldTargetTris.emplace_back(targetTriIndex);
+    }
+  }
+
+  /* fields are independent, build them in parallel */
+  mJobSystem.parallelFor(mDirtyFlowFields.size(), 1, [&](size_t start, size_t end) {
+    for (size_t i = start; i < end; ++i) {
+      mPathFinder.buildFlowField(*mDirtyFlowFields.at(i), mDirtyFlowFieldTargetTris.at(i));
+    }
+  });
+
+  mRenderData.rdNumberOfFlowFields = mFlowFields.size();
+  mRenderData.rdNumberOfFlowFieldRebuilds = mDirtyFlowFields.size();
+}
+
+void OGLRenderer::updateInstanceGroundNeighbors(std::shared_ptr<AssimpInstance> instance, std::vector<OGLLineVertex>& neighborVertices) {
+  int groundTri = instance->getCurrentGroundTriangleIndex();
+  if (groundTri > -1) {
+    std::vector<int> neighborIndices = mPathFinder.getGroundTriangleNeighbors(groundTri);
+    instance->setNeighborGroundTriangleIndices(neighborIndices);
+
+    std::shared_ptr<OGLLineMesh> neighborMesh =
+      mPathFinder.getAsTriangleMesh(neighborIndices, glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, 0.8f), glm::vec3(0.0f, 0.01f, 0.0f));
+    neighborVertices.insert(neighborVertices.end(), neighborMesh->vertices.begin(), neighborMesh->vertices.end());
+  }
+}
+
+void OGLRenderer::applyPathResults() {
+  mRenderData.rdNumberOfAppliedPathResults = 0;
+
+  std::chrono::time_point<std::chrono::steady_clock> startTime = std::chrono::steady_clock::now();
+  while (mPathService.getResult(mPathResult)) {
+    ++mRenderData.rdNumberOfAppliedPathResults;
+    ++mPathQueries;
+    mPathNodesExpanded += mPathResult.nodesExpanded;
+
+    /* the instance may be gone, or it started a newer request */
+    if (mPathResult.owner < static_cast<int>(mModelInstCamData.micAssimpInstances.size())) {
+      std::shared_ptr<AssimpInstance> instance = mModelInstCamData.micAssimpInstances.at(mPathResult.owner);
+      if (instance->isNavigationEnabled() &&
+          instance->getPathStartTriIndex() == mPathResult.startTriIndex &&
+          instance->getPathTargetTriIndex() == mPathResult.targetTriIndex) {
+        /* disable navigation if target is unreachable */
+        if (mPathResult.path.empty()) {
+          instance->setNavigationEnabled(false);
+          instance->setPathTargetInstanceId(-1);
+        } else {
+          instance->setPathToTarget(mPathResult.path);
+        }
+      }
+    }
+
+    float elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count() / 1000.0f;
+    if (elapsedTime >= mRenderData.rdPathResultBudget) {
+      break;
+    }
+  }
+
+  mRenderData.rdNumberOfPendingPathRequests = mPathService.getNumberOfPendingRequests();
+}
+
+void OGLRenderer::updateWorld(float deltaTime) {
+  mWorldUpdateAllocationCounter.start();
+
+  /* reset simulation timers and counters */
+  mRenderData.rdNumberOfCollisions = 0;
+  mRenderData.rdCollisionCheckTime = 0.0f;
+  mRenderData.rdBehaviorTime = 0.0f;
+  mRenderData.rdNumberOfCollidingTriangles = 0;
+  mRenderData.rdNumberOfCollidingGroundTriangles = 0;
+  mRenderData.rdLevelCollisionTime = 0.0f;
+  mRenderData.rdPathFindingTime = 0.0f;
+  mRenderData.rdLevelGroundNeighborUpdateTime = 0.0f;
+  mRenderData.rdInstanceUpdateTime = 0.0f;
+
+  /* worker count changed in UI */
+  if (static_cast<unsigned int>(mRenderData.rdNumberOfWorkerThreads) != mJobSystem.getNumberOfThreads()) {
+    mJobSystem.init(mRenderData.rdNumberOfWorkerThreads);
+  }
+
+  mPathQueries = 0;
+  mPathNodesExpanded = 0;
+
+  /* results of the last frame(s), before any instance moves */
+  if (mRenderData.rdEnableNavigation) {
+    mPathFindingTimer.start();
+    applyPathResults();
+    mRenderData.rdPathFindingTime += mPathFindingTimer.stop();
+  }
+
+  mLevelGroundNeighborsMesh->vertices.clear();
+  mInstancePathMesh->vertices.clear();
+
+  mInstanceGrid.setCellSize(mRenderData.rdInstanceGridCellSize);
+  mInstanceGrid.resetCounters();
+  mInstanceSweepAndPrune.resetCounters();
+
+  /* collect a flat list of all instances to spread them evenly across the workers */
+  mInstanceUpdateTimer.start();
+  mWorldUpdateInstances.clear();
+  mWorldUpdateAnimatedInstances.clear();
+  for (const auto& model : mModelInstCamData.micModelList) {
+    const std::vector<std::shared_ptr<AssimpInstance>>& instances = mModelInstCamData.micAssimpInstancesPerModel[model->getModelFileName()];
+    if (instances.empty() || model->getTriangleCount() == 0) {
+      continue;
+    }
+
+    mWorldUpdateInstances.insert(mWorldUpdateInstances.end(), instances.begin(), instances.end());
+
+    /* navigation and ground neighbors are only used by animated models */
+    if (model->hasAnimations() && !model->getBoneList().empty()) {
+      mWorldUpdateAnimatedInstances.insert(mWorldUpdateAnimatedInstances.end(), instances.begin(), instances.end());
+    }
+  }
+
+  /* every instance changes only its own data here */
+  mJobSystem.parallelFor(mWorldUpdateInstances.size(), WORLD_UPDATE_CHUNK_SIZE, [&](size_t start, size_t end) {
+    for (size_t i = start; i < end; ++i) {
+      updateInstanceSimulation(mWorldUpdateInstances.at(i), deltaTime);
+    }
+  });
+
+  /* merge: the grid is not thread safe, only instances crossing a cell border are moved */
+  for (const auto& instance : mWorldUpdateInstances) {
+    mInstanceGrid.update(instance->getInstanceIndexPosition(), instance->getBoundingBox());
+  }
+  mOctreeDirty = true;
+
+  /* the sorted lists are only valid if every frame is seen */
+  if (mRenderData.rdCollisionBroadphase == collisionBroadphase::sweepAndPrune) {
+    for (const auto& instance : mWorldUpdateInstances) {
+      mInstanceSweepAndPrune.update(instance->getInstanceIndexPosition(), instance->getBoundingBox());
+    }
+  } else {
+    mInstanceSweepAndPrune.clear();
+  }
+  mRenderData.rdInstanceUpdateTime += mInstanceUpdateTimer.stop();
+
+  size_t numberOfAnimatedInstances = mWorldUpdateAnimatedInstances.size();
+  mInstancePathVertices.resize(numberOfAnimatedInstances);
+  mInstanceNeighborVertices.resize(numberOfAnimatedInstances);
+
+  /* path update, reads the (final) positions of other instances */
+  if (mRenderData.rdEnableNavigation) {
+    mPathFindingTimer.start();
+    if (mRenderData.rdUseFlowFields) {
+      updateFlowFields();
+    } else {
+      mFlowFields.clear();
+      mRenderData.rdNumberOfFlowFields = 0;
+      mRenderData.rdNumberOfFlowFieldRebuilds = 0;
+    }
+
+    mJobSystem.parallelFor(numberOfAnimatedInstances, WORLD_UPDATE_CHUNK_SIZE, [&](size_t start, size_t end) {
+      for (size_t i = start; i < end; ++i) {
+        mInstancePathVertices.at(i).clear();
+        if (mWorldUpdateAnimatedInstances.at(i)->isNavigationEnabled()) {
+          updateInstancePath(mWorldUpdateAnimatedInstances.at(i), deltaTime, mInstancePathVertices.at(i));
+        }
+      }
+    });
+
+    for (const auto& pathVertices : mInstancePathVertices) {
+      mInstancePathMesh->vertices.insert(mInstancePathMesh->vertices.end(), pathVertices.begin(), pathVertices.end());
+    }
+    mRenderData.rdPathFindingTime += mPathFindingTimer.stop();
+  }
+
+  mRenderData.rdNumberOfPathQueries = mPathQueries;
+  mRenderData.rdPathNodesExpanded = mPathNodesExpanded;
+  if (mRenderData.rdNumberOfPathQueries > 0) {
+    mRenderData.rdPathNodesPerQuery = static_cast<float>(mRenderData.rdPathNodesExpanded) / mRenderData.rdNumberOfPathQueries;
+  }
+
+  /* neighbor triangles */
+  mLevelGroundNeighborUpdateTimer.start();
+  mJobSystem.parallelFor(numberOfAnimatedInstances, WORLD_UPDATE_CHUNK_SIZE, [&](size_t start, size_t end) {
+    for (size_t i = start; i < end; ++i) {
+      mInstanceNeighborVertices.at(i).clear();
+      updateInstanceGroundNeighbors(mWorldUpdateAnimatedInstances.at(i), mInstanceNeighborVertices.at(i));
+    }
+  });
+
+  for (const auto& neighborVertices : mInstanceNeighborVertices) {
+    mLevelGroundNeighborsMesh->vertices.insert(mLevelGroundNeighborsMesh->vertices.end(),
+      neighborVertices.begin(), neighborVertices.end());
+  }
+  mRenderData.rdLevelGroundNeighborUpdateTime += mLevelGroundNeighborUpdateTimer.stop();
+
+  /* remove instances that fell out of the level boundaries */
+  for (const auto& instance : mWorldUpdateInstances) {
+    const InstanceSettings& instSettings = instance->getInstanceSettings();
+
+    if (instSettings.isWorldPosition.y < mRenderData.rdWorldStartPos.y - 50.0f) {
+      int instanceId = instSettings.isInstanceIndexPosition;
+      Logger::log(1, "%s warning: instance id %i fell out of level boundaries, deleting\n", __FUNCTION__, instanceId);
+      deleteInstance(getInstanceById(instanceId));
+    }
+  }
+
+  /* check for collisions */
+  mCollisionCheckTimer.start();
+  checkForInstanceCollisions();
+  checkForBorderCollisions();
+  mRenderData.rdCollisionCheckTime += mCollisionCheckTimer.stop();
+
+  mRenderData.rdNumberOfRebucketedInstances = mInstanceGrid.getNumberOfRebucketedInstances();
+  mRenderData.rdNumberOfEndpointSwaps = mInstanceSweepAndPrune.getNumberOfEndpointSwaps();
+  mRenderData.rdNumberOfInstancePairTests = mRenderData.rdCollisionBroadphase == collisionBroadphase::sweepAndPrune ?
+    mInstanceSweepAndPrune.getNumberOfPairTests() : mInstanceGrid.getNumberOfPairTests();
+
+  /* level collisions */
+  if (mModelInstCamData.micLevels.size() > 1) {
+    mLevelCollisionTimer.start();
+    checkForLevelCollisions();
+    mRenderData.rdLevelCollisionTime += mLevelCollisionTimer.stop();
+  }
+
+  /* behavior update */
+  mBehviorTimer.start();
+  mBehaviorManager->update(deltaTime);
+  mRenderData.rdBehaviorTime += mBehviorTimer.stop();
+
+  mRenderData.rdWorldUpdateAllocations = mWorldUpdateAllocationCounter.stop();
+}
+
+void OGLRenderer::runBoneMatrixComputeShader(std::shared_ptr<AssimpModel> model, size_t numberOfBones, size_t numberOfUpdates,
+    ShaderStorageBuffer& trsMatrixBuffer, ShaderStorageBuffer& boneMatrixBuffer) {
+  mBoneMatrixGpuTimer.start();
+
+  /* the level order shader caches the parent matrices in shared memory, no walk up to the root per bone */
+  if (mRenderData.rdUseLevelOrderBoneMatrices && numberOfBones <= MAX_LEVEL_ORDER_BONES) {
+    mAssimpMatrixLevelComputeShader.use();
+
+    mUploadToUBOTimer.start();
+    mAssimpMatrixLevelComputeShader.setUniformValue(numberOfBones);
+    trsMatrixBuffer.bind(0);
+    model->bindBoneParentBuffer(1);
+    model->bindBoneMatrixOffsetBuffer(2);
+    boneMatrixBuffer.bind(3);
+    model->bindBoneLevelBuffer(4);
+    mBoneUpdateInstanceBuffer.bind(5);
+    mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+
+    /* one work group per instance, the bones are done level by level */
+    glDispatchCompute(numberOfUpdates, 1, 1);
+  } else {
+    mAssimpMatrixComputeShader.use();
+
+    mUploadToUBOTimer.start();
+    trsMatrixBuffer.bind(0);
+    model->bindBoneParentBuffer(1);
+    model->bindBoneMatrixOffsetBuffer(2);
+    boneMatrixBuffer.bind(3);
+    mBoneUpdateInstanceBuffer.bind(4);
+    mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+
+    /* do the computation - in groups of 32 invocations */
+    glDispatchCompute(numberOfBones, std::ceil(numberOfUpdates / 32.0f), 1);
+  }
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+  mBoneMatrixGpuTimer.stop();
+}
+
+size_t OGLRenderer::selectBoneUpdateInstances(std::shared_ptr<AssimpModel> model,
+    const std::vector<std::shared_ptr<AssimpInstance>>& instances, size_t numberOfInstances, glm::vec3 cameraPosition, int alwaysUpdateInstanceIndex) {
+  const ModelSettings& modSettings = model->getModelSettings();
+  bool useAnimationLod = mRenderData.rdEnableAnimationLod && modSettings.msUseAnimationLod;
+
+  std::vector<int>& updatedInstanceIndices = mLodUpdatedInstanceIndices[model->getModelFileName()];
+  updatedInstanceIndices.resize(numberOfInstances, -1);
+
+  mBoneUpdateLodTiers.resize(numberOfInstances);
+  mBoneUpdateInstances.resize(numberOfInstances + 1);
+
+  size_t numberOfUpdates = 0;
+  for (size_t i = 0; i < numberOfInstances; ++i) {
+    int instanceIndex = instances.at(i)->getInstanceIndexPosition();
+
+    /* no skinning data for invisible instances, the pose is recalculated as soon as the instance gets visible again */
+    if (!mInstanceVisible.at(i) && instanceIndex != alwaysUpdateInstanceIndex) {
+      mBoneUpdateLodTiers.at(i) = -1;
+      updatedInstanceIndices.at(i) = -1;
+      continue;
+    }
+
+    /* the buffers may contain the pose of another instance, or nothing at all */
+    bool staleData = updatedInstanceIndices.at(i) != instanceIndex;
+
+    int lodTier = 0;
+    if (useAnimationLod && !staleData && instanceIndex != alwaysUpdateInstanceIndex) {
+      /* mWorldPosMatrices has been filled for this model */
+      float distance = glm::length(glm::vec3(mWorldPosMatrices.at(i)[3]) - cameraPosition);
+      for (size_t tier = 1; tier < modSettings.msAnimationLodTiers.size(); ++tier) {
+        if (distance >= modSettings.msAnimationLodTiers.at(tier).altMinDistance) {
+          lodTier = tier;
+        }
+      }
+    }
+
+    const AnimationLodTier& tierSettings = modSettings.msAnimationLodTiers.at(lodTier);
+    int updateInterval = lodTier == 0 ? 1 : std::max(tierSettings.altUpdateInterval, 1);
+
+    /* spread the updates of the instances in a tier over the frames */
+    if ((mAnimationLodFrameCounter + i) % updateInterval != 0) {
+      mBoneUpdateLodTiers.at(i) = -1;
+      continue;
+    }
+
+    uint32_t updateData = static_cast<uint32_t>(i);
+    if (lodTier > 0 && tierSettings.altReducedSkeleton) {
+      updateData |= REDUCED_SKELETON_BIT;
+    }
+
+    mBoneUpdateInstances.at(numberOfUpdates + 1) = updateData;
+    mBoneUpdateLodTiers.at(i) = lodTier;
+    updatedInstanceIndices.at(i) = instanceIndex;
+    ++numberOfUpdates;
+  }
+  mBoneUpdateInstances.at(0) = numberOfUpdates;
+  mBoneUpdateInstances.resize(numberOfUpdates + 1);
+
+  mUploadToUBOTimer.start();
+  mBoneUpdateInstanceBuffer.uploadSsboData(mBoneUpdateInstances);
+  mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+
+  return numberOfUpdates;
+}
+
+void OGLRenderer::uploadAllBoneUpdateInstances(size_t numberOfInstances) {
+  mBoneUpdateInstances.resize(numberOfInstances + 1);
+  mBoneUpdateInstances.at(0) = numberOfInstances;
+  for (size_t i = 0; i < numberOfInstances; ++i) {
+    mBoneUpdateInstances.at(i + 1) = i;
+  }
+
+  mUploadToUBOTimer.start();
+  mBoneUpdateInstanceBuffer.uploadSsboData(mBoneUpdateInstances);
+  mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+}
+
+void OGLRenderer::cullInstances(std::shared_ptr<AssimpModel> model, const std::vector<std::shared_ptr<AssimpInstance>>& instances,
+    size_t numberOfInstances) {
+  mCullingTimer.start();
+
+  if (mRenderData.rdEnableInstanceCulling) {
+    /* extract the planes from the rows of the view projection matrix, normals point inside */
+    glm::mat4 rows = glm::transpose(mProjectionMatrix * mViewMatrix);
+    mCullingParameters.frustumPlanes.at(0) = rows[3] + rows[0];
+    mCullingParameters.frustumPlanes.at(1) = rows[3] - rows[0];
+    mCullingParameters.frustumPlanes.at(2) = rows[3] + rows[1];
+    mCullingParameters.frustumPlanes.at(3) = rows[3] - rows[1];
+    mCullingParameters.frustumPlanes.at(4) = rows[3] + rows[2];
+    mCullingParameters.frustumPlanes.at(5) = rows[3] - rows[2];
+
+    for (auto& plane : mCullingParameters.frustumPlanes) {
+      plane /= glm::length(glm::vec3(plane));
+    }
+  } else {
+    /* every instance is on the positive side */
+    mCullingParameters.frustumPlanes.fill(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+  }
+
+  /* the bounding boxes are updated in updateWorld() */
+  mCullingAABBs.resize(numberOfInstances * 2);
+  mInstanceVisible.resize(numberOfInstances);
+  for (size_t i = 0; i < numberOfInstances; ++i) {
+    BoundingBox3D box = instances.at(i)->getBoundingBox();
+    glm::vec3 minPos = box.getFrontTopLeft();
+    glm::vec3 maxPos = box.getFrontTopLeft() + box.getSize();
+    mCullingAABBs.at(i * 2) = glm::vec4(minPos, 1.0f);
+    mCullingAABBs.at(i * 2 + 1) = glm::vec4(maxPos, 1.0f);
+
+    /* same test as in the culling shader, the corner farthest along the plane normal must be inside */
+    bool visible = true;
+    for (const auto& plane : mCullingParameters.frustumPlanes) {
+      glm::vec3 positiveCorner = glm::mix(minPos, maxPos, glm::greaterThanEqual(glm::vec3(plane), glm::vec3(0.0f)));
+      if (glm::dot(glm::vec3(plane), positiveCorner) + plane.w < 0.0f) {
+        visible = false;
+        break;
+      }
+    }
+    mInstanceVisible.at(i) = visible;
+  }
+
+  mCullingParameters.numberOfInstances = numberOfInstances;
+  mCullingParameters.numberOfDrawCommands = model->getDrawCommands().size();
+
+  mAssimpInstanceCullingShader.use();
+
+  mUploadToUBOTimer.start();
+  mCullingAABBBuffer.uploadSsboData(mCullingAABBs, 0);
+  mCullingParameterBuffer.uploadSsboData(mCullingParameters, 1);
+  mVisibleInstanceBuffer.checkForResize(numberOfInstances * sizeof(uint32_t));
+  mVisibleInstanceBuffer.bind(2);
+  /* resets the instance counts of the draw commands */
+  mDrawCommandBuffer.uploadSsboData(model->getDrawCommands(), 3);
+  mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+
+  /* one invocation per instance - in groups of 64 invocations */
+  glDispatchCompute(std::ceil(numberOfInstances / 64.0f), 1, 1);
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+  mRenderData.rdCullingTime += mCullingTimer.stop();
+}
+
 bool OGLRenderer::draw(float deltaTime) {
   if (!mApplicationRunning) {
     return false;
@@ -3357,6 +4627,18 @@ bool OGLRenderer::draw(float deltaTime) {
     return true;
   }
 
+  if (mLevelDataCacheSavePending && std::chrono::steady_clock::now() >= mLevelDataCacheSaveTime) {
+    saveLevelDataCache();
+  }
+
+  if (mConfigLoadPending) {
+    updateConfigLoading();
+  }
+
+  /* mip levels of the streamed textures, the budget keeps the frame time stable */
+  mTextureManager.setStreamingEnabled(mRenderData.rdEnableTextureStreaming);
+  mTextureManager.uploadStreamedTextures(static_cast<size_t>(mRenderData.rdTextureStreamingBudget) * 1024);
+
   if (mRenderData.rdEnableTimeOfDay) {
     mRenderData.rdTimeOfDay += deltaTime * mRenderData.rdTimeScaleFactor;
     if (mRenderData.rdTimeOfDay > mRenderData.rdLengthOfDay) {
@@ -3373,30 +4655,33 @@ bool OGLRenderer::draw(float deltaTime) {
   mRenderData.rdFrameTime = mFrameTimer.stop();
   mFrameTimer.start();
 
+  mRenderData.rdFrameAllocations = mFrameAllocationCounter.stop();
+  mFrameAllocationCounter.start();
+
+  mRenderData.rdNumberOfTextures = mTextureManager.getNumberOfTextures();
+  mRenderData.rdTextureMemorySize = mTextureManager.getTextureMemorySize();
+  mRenderData.rdTextureCacheHits = mTextureManager.getNumberOfCacheHits();
+  mRenderData.rdNumberOfPendingTextureUploads = mTextureManager.getNumberOfPendingUploads();
+
   /* reset timers and other values */
   mRenderData.rdMatricesSize = 0;
   mRenderData.rdMatrixGenerateTime = 0.0f;
+  /* the GPU runs a few frames behind, the bone matrix time is from an older frame */
+  mRenderData.rdBoneMatrixGpuTime = mBoneMatrixGpuTimer.nextFrame();
   mRenderData.rdUploadToUBOTime = 0.0f;
   mRenderData.rdUploadToVBOTime = 0.0f;
   mRenderData.rdDownloadFromUBOTime = 0.0f;
   mRenderData.rdUIGenerateTime = 0.0f;
-  mRenderData.rdNumberOfCollisions = 0;
   mRenderData.rdCollisionDebugDrawTime = 0.0f;
-  mRenderData.rdCollisionCheckTime = 0.0f;
-  mRenderData.rdBehaviorTime = 0.0f;
   mRenderData.rdInteractionTime = 0.0f;
   mRenderData.rdNumberOfInteractionCandidates = 0;
   mRenderData.rdInteractWithInstanceId = 0;
   mRenderData.rdFaceAnimTime = 0.0f;
-  mRenderData.rdNumberOfCollidingTriangles = 0;
-  mRenderData.rdNumberOfCollidingGroundTriangles = 0;
-  mRenderData.rdLevelCollisionTime = 0.0f;
   mRenderData.rdIKTime = 0.0f;
-  mRenderData.rdPathFindingTime = 0.0f;
-  mRenderData.rdLevelGroundNeighborUpdateTime = 0.0f;
-
-  mLevelGroundNeighborsMesh->vertices.clear();
-  mInstancePathMesh->vertices.clear();
+  mRenderData.rdCullingTime = 0.0f;
+  mRenderData.rdNumberOfBoneUpdates = 0;
+  mRenderData.rdNumberOfAnimatedInstances = 0;
+  ++mAnimationLodFrameCounter;
 
   /* save the selected instance for color highlight */
   std::shared_ptr<AssimpInstance> currentSelectedInstance = nullptr;
@@ -3419,6 +4704,9 @@ bool OGLRenderer::draw(float deltaTime) {
 
   handleMovementKeys();
 
+  /* advance the simulation, the remaining code only draws the results */
+  updateWorld(deltaTime);
+
   std::shared_ptr<Camera> cam = mModelInstCamData.micCameras.at(mModelInstCamData.micSelectedCamera);
   CameraSettings camSettings = cam->getCameraSettings();
 
@@ -3529,24 +4817,26 @@ bool OGLRenderer::draw(float deltaTime) {
     level->draw();
   }
 
-  mOctree->clear();
-
   int firstPersonCamWorldPos = -1;
 
   if (mRenderData.rdDrawIKDebugLines) {
     mIKFootPointMesh->vertices.clear();
   }
 
+  int selectedInstanceIndex = currentSelectedInstance ? currentSelectedInstance->getInstanceIndexPosition() : -1;
+  int followInstanceIndex = cam->getInstanceToFollow() ? cam->getInstanceToFollow()->getInstanceIndexPosition() : -1;
+
   for (const auto& model : mModelInstCamData.micModelList) {
     size_t numberOfInstances = mModelInstCamData.micAssimpInstancesPerModel[model->getModelFileName()].size();
-    std::vector<std::shared_ptr<AssimpInstance>> instances = mModelInstCamData.micAssimpInstancesPerModel[model->getModelFileName()];
+    const std::vector<std::shared_ptr<AssimpInstance>>& instances = mModelInstCamData.micAssimpInstancesPerModel[model->getModelFileName()];
     if (numberOfInstances > 0 && model->getTriangleCount() > 0) {
 
       /* animated models */
       if (model->hasAnimations() && !model->getBoneList().empty()) {
 
         size_t numberOfBones = model->getBoneList().size();
-        ModelSettings modSettings = model->getModelSettings();
+        const ModelSettings& modSettings = model->getModelSettings();
+        bool hasHeadMovement = model->hasHeadMovementAnimationsMapped();
 
         mMatrixGenerateTimer.start();
 
@@ -3557,8 +4847,19 @@ bool OGLRenderer::draw(float deltaTime) {
 
         mFaceAnimPerInstanceData.resize(numberOfInstances);
 
+        /* same clips for all instances, missing directions use the first clip */
+        std::array<int, static_cast<size_t>(headMoveDirection::NUM)> headMoveClips{};
+        if (hasHeadMovement) {
+          for (const auto& clip : modSettings.msHeadMoveClipMappings) {
+            if (clip.first < headMoveDirection::NUM) {
+              headMoveClips.at(static_cast<size_t>(clip.first)) = clip.second;
+            }
+          }
+        }
+
         for (size_t i = 0; i < numberOfInstances; ++i) {
-          InstanceSettings instSettings = instances.at(i)->getInstanceSettings();
+          const InstanceSettings& instSettings = instances.at(i)->getInstanceSettings();
+          int instanceIndex = instSettings.isInstanceIndexPosition;
 
           /* animations */
           PerInstanceAnimData animData{};
@@ -3568,16 +4869,16 @@ bool OGLRenderer::draw(float deltaTime) {
           animData.secondClipReplayTimestamp = instSettings.isSecondClipAnimPlayTimePos;
           animData.blendFactor = instSettings.isAnimBlendFactor;
 
-          if (model->hasHeadMovementAnimationsMapped()) {
+          if (hasHeadMovement) {
             if (instSettings.isHeadLeftRightMove > 0.0f) {
-              animData.headLeftRightAnimClipNum = modSettings.msHeadMoveClipMappings[headMoveDirection::left];
+              animData.headLeftRightAnimClipNum = headMoveClips.at(static_cast<size_t>(headMoveDirection::left));
             } else {
-              animData.headLeftRightAnimClipNum = modSettings.msHeadMoveClipMappings[headMoveDirection::right];
+              animData.headLeftRightAnimClipNum = headMoveClips.at(static_cast<size_t>(headMoveDirection::right));
             }
             if (instSettings.isHeadUpDownMove > 0.0f) {
-              animData.headUpDownAnimClipNum = modSettings.msHeadMoveClipMappings[headMoveDirection::up];
+              animData.headUpDownAnimClipNum = headMoveClips.at(static_cast<size_t>(headMoveDirection::up));
             } else {
-              animData.headUpDownAnimClipNum = modSettings.msHeadMoveClipMappings[headMoveDirection::down];
+              animData.headUpDownAnimClipNum = headMoveClips.at(static_cast<size_t>(headMoveDirection::down));
             }
             animData.headLeftRightReplayTimestamp = std::fabs(instSettings.isHeadLeftRightMove) * model->getMaxClipDuration();
             animData.headUpDownReplayTimestamp = std::fabs(instSettings.isHeadUpDownMove) * model->getMaxClipDuration();
@@ -3586,40 +4887,23 @@ bool OGLRenderer::draw(float deltaTime) {
           mPerInstanceAnimData.at(i) = animData;
 
           if (mRenderData.rdApplicationMode == appMode::edit) {
-            if (currentSelectedInstance == instances.at(i)) {
+            if (instanceIndex == selectedInstanceIndex) {
               mSelectedInstance.at(i).x = mRenderData.rdSelectedInstanceHighlightValue;
             } else {
               mSelectedInstance.at(i).x = 1.0f;
             }
 
             if (mMousePick) {
-              mSelectedInstance.at(i).y = static_cast<float>(instSettings.isInstanceIndexPosition);
+              mSelectedInstance.at(i).y = static_cast<float>(instanceIndex);
             }
           } else {
             mSelectedInstance.at(i).x = 1.0f;
           }
 
-          if (camSettings.csCamType == cameraType::firstPerson && cam->getInstanceToFollow() &&
-              instSettings.isInstanceIndexPosition == cam->getInstanceToFollow()->getInstanceIndexPosition()) {
-            firstPersonCamWorldPos = instSettings.isInstanceIndexPosition;
+          if (camSettings.csCamType == cameraType::firstPerson && instanceIndex == followInstanceIndex) {
+            firstPersonCamWorldPos = instanceIndex;
           }
 
-          instances.at(i)->updateAnimation(deltaTime);
-
-          /* get AABB and calculate 3D boundaries */
-          AABB instanceAABB = model->getAABB(instSettings);
-
-          glm::vec3 position = instanceAABB.getMinPos();
-          glm::vec3 size = glm::vec3(std::fabs(instanceAABB.getMaxPos().x - instanceAABB.getMinPos().x),
-                                     std::fabs(instanceAABB.getMaxPos().y - instanceAABB.getMinPos().y),
-                                     std::fabs(instanceAABB.getMaxPos().z - instanceAABB.getMinPos().z));
-
-          BoundingBox3D box{position, size};
-          instances.at(i)->setBoundingBox(box);
-
-          /* add instance to octree */
-          mOctree->add(instSettings.isInstanceIndexPosition);
-
           /* use a glm::vec3 to transport all morph data */
           mFaceAnimTimer.start();
 
@@ -3633,199 +4917,68 @@ bool OGLRenderer::draw(float deltaTime) {
 
           mRenderData.rdFaceAnimTime += mFaceAnimTimer.stop();
 
-          /* gravity and ground collisions */
-          mLevelCollisionTimer.start();
-
-          /* extend the AABB a bit below the feet to allow a better ground collision handling */
-          glm::vec3 instBoxPos = position - mRenderData.rdLevelCollisionAABBExtension;
-          glm::vec3 instBoxSize = size + mRenderData.rdLevelCollisionAABBExtension;
-          BoundingBox3D instanceBox{instBoxPos, instBoxSize};
-
-          std::vector<MeshTriangle> collidingTriangles = mTriangleOctree->query(instanceBox);
-          instances.at(i)->setCollidingTriangles(collidingTriangles);
-
-          /* set state to "instance on ground" if gravity is disabled */
-          bool instanceOnGround = true;
-          if (mRenderData.rdEnableSimpleGravity) {
-            glm::vec3 gravity = glm::vec3(0.0f, GRAVITY_CONSTANT * deltaTime, 0.0f);
-            glm::vec3 footPoint = instSettings.isWorldPosition;
-
-            instanceOnGround = false;
-            for (const auto& tri : collidingTriangles) {
-              /* check for slope */
-              bool isWalkable = false;
-              if (glm::dot(tri.normal, glm::vec3(0.0f, 1.0f, 0.0f)) >= std::cos(glm::radians(mRenderData.rdMaxLevelGroundSlopeAngle))) {
-                isWalkable = true;
-              }
-
-              if (isWalkable) {
-                std::optional<glm::vec3> result = Tools::rayTriangleIntersection(instSettings.isWorldPosition - gravity, glm::vec3(0.0f, 1.0f, 0.0f), tri);
-                if (result.has_value()) {
-                  footPoint = result.value();
-                  instances.at(i)->setWorldPosition(footPoint);
-                  instanceOnGround = true;
-                }
-              }
-            }
-          }
-          instances.at(i)->setInstanceOnGround(instanceOnGround);
-          instances.at(i)->applyGravity(deltaTime);
-          mRenderData.rdLevelCollisionTime += mLevelCollisionTimer.stop();
-
-          /* update instance speed and position */
-          instances.at(i)->updateInstanceSpeed(deltaTime);
-          instances.at(i)->updateInstancePosition(deltaTime);
-
           mWorldPosMatrices.at(i) = instances.at(i)->getWorldTransformMatrix();
-
-          /* path update */
-          if (mRenderData.rdEnableNavigation && instSettings.isNavigationEnabled) {
-            mPathFindingTimer.start();
-            int pathTargetInstance = instSettings.isPathTargetInstance;
-
-            /* invalid target, reset */
-            if (pathTargetInstance >= mModelInstCamData.micAssimpInstances.size()) {
-              pathTargetInstance = -1;
-              instances.at(i)->setPathTargetInstanceId(pathTargetInstance);
-            }
-
-            int pathTargetInstanceTriIndex = -1;
-            glm::vec3 pathTargetWorldPos = glm::vec3(0.0f);
-            if (pathTargetInstance != -1) {
-              /* target instance is always valid here */
-              std::shared_ptr<AssimpInstance> targetInstance = mModelInstCamData.micAssimpInstances.at(pathTargetInstance);
-              pathTargetInstanceTriIndex = targetInstance->getCurrentGroundTriangleIndex();
-              pathTargetWorldPos = targetInstance->getWorldPosition();
-            }
-
-            /* do a path update only if both start and end triangle indices are valid and we or target changed its triangle */
-            if ((instSettings.isCurrentGroundTriangleIndex > -1 && pathTargetInstanceTriIndex > -1) &&
-                (instSettings.isCurrentGroundTriangleIndex != instSettings.isPathStartTriangleIndex ||
-                pathTargetInstanceTriIndex != instSettings.isPathTargetTriangleIndex)) {
-              instances.at(i)->setPathStartTriIndex(instSettings.isCurrentGroundTriangleIndex);
-              instances.at(i)->setPathTargetTriIndex(pathTargetInstanceTriIndex);
-
-              std::vector<int> pathToTarget = mPathFinder.findPath(instSettings.isCurrentGroundTriangleIndex, pathTargetInstanceTriIndex);
-
-              /* disable navigation if target is unreachable */
-              if (pathToTarget.empty()) {
-                instances.at(i)->setNavigationEnabled(false);
-                instances.at(i)->setPathTargetInstanceId(-1);
-              } else {
-                instances.at(i)->setPathToTarget(pathToTarget);
-              }
-            }
-
-            std::vector<int> pathToTarget = instances.at(i)->getPathToTarget();
-
-            /* remove first and last elements, they are the target centers of start and target triangles */
-            if (pathToTarget.size() > 1) {
-              pathToTarget.pop_back();
-            }
-            if (!pathToTarget.empty()) {
-              pathToTarget.erase(pathToTarget.begin());
-            }
-
-            /* navigate to target */
-            if (!pathToTarget.empty()) {
-              /* navigate to next triangle, not the one we may stand on (start triangle)*/
-              int nextTarget = pathToTarget.at(0);
-              glm::vec3 destPos = mPathFinder.getTriangleCenter(nextTarget);
-              instances.at(i)->rotateTo(destPos, deltaTime);
-            } else {
-              /* empty path means we have only the target itself left */
-              instances.at(i)->rotateTo(pathTargetWorldPos, deltaTime);
-            }
-
-            if (mRenderData.rdDrawInstancePaths && pathTargetInstance > -1) {
-              glm::vec3 pathColor = glm::vec3(0.4f, 1.0f, 0.4f);
-              glm::vec3 pathYOffset = glm::vec3(0.0f, 1.0f, 0.0f);
-
-              OGLLineVertex vert;
-              vert.color = pathColor;
-
-              vert.position = instSettings.isWorldPosition + pathYOffset;
-              mInstancePathMesh->vertices.emplace_back(vert);
-
-              if (!pathToTarget.empty()) {
-                vert.position = mPathFinder.getTriangleCenter(pathToTarget.at(0)) + pathYOffset;
-                mInstancePathMesh->vertices.emplace_back(vert);
-
-                std::shared_ptr<OGLLineMesh> pathMesh =
-                  mPathFinder.getAsLineMesh(pathToTarget, pathColor, pathYOffset);
-
-                mInstancePathMesh->vertices.insert(mInstancePathMesh->vertices.end(), pathMesh->vertices.begin(), pathMesh->vertices.end());
-
-                vert.position = mPathFinder.getTriangleCenter(pathToTarget.at(pathToTarget.size() - 1)) + pathYOffset;
-                mInstancePathMesh->vertices.emplace_back(vert);
-              }
-
-              vert.position = pathTargetWorldPos + pathYOffset;
-              mInstancePathMesh->vertices.emplace_back(vert);
-            }
-            mRenderData.rdPathFindingTime += mPathFindingTimer.stop();
-          }
-
-          /* neighbor triangles */
-          mLevelGroundNeighborUpdateTimer.start();
-          int groundTri = instSettings.isCurrentGroundTriangleIndex;
-          if (groundTri > -1) {
-            std::vector<int> neighborIndices = mPathFinder.getGroundTriangleNeighbors(groundTri);
-            instances.at(i)->setNeighborGroundTriangleIndices(neighborIndices);
-
-            std::shared_ptr<OGLLineMesh> neighborMesh =
-              mPathFinder.getAsTriangleMesh(neighborIndices, glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, 0.8f), glm::vec3(0.0f, 0.01f, 0.0f));
-            mLevelGroundNeighborsMesh->vertices.insert(mLevelGroundNeighborsMesh->vertices.end(),
-              neighborMesh->vertices.begin(), neighborMesh->vertices.end());
-          }
-          mRenderData.rdLevelGroundNeighborUpdateTime += mLevelGroundNeighborUpdateTimer.stop();
         }
 
         size_t trsMatrixSize = numberOfBones * numberOfInstances * 3 * sizeof(glm::vec4);
         size_t bufferMatrixSize = numberOfBones * numberOfInstances * sizeof(glm::mat4);
 
+        ShaderStorageBuffer& trsMatrixBuffer = mLodTRSMatrixBuffers[model->getModelFileName()];
+        ShaderStorageBuffer& boneMatrixBuffer = mLodBoneMatrixBuffers[model->getModelFileName()];
+
+        /* a resize drops the old content, all instances need new matrices */
+        if (bufferMatrixSize > boneMatrixBuffer.getBufferSize() || trsMatrixSize > trsMatrixBuffer.getBufferSize()) {
+          mLodUpdatedInstanceIndices[model->getModelFileName()].clear();
+        }
+
         /* we may have to resize the buffers (uploadSsboData() checks for the size automatically, bind() not) */
-        mShaderBoneMatrixBuffer.checkForResize(bufferMatrixSize);
-        mShaderTRSMatrixBuffer.checkForResize(trsMatrixSize);
+        boneMatrixBuffer.checkForResize(bufferMatrixSize);
+        trsMatrixBuffer.checkForResize(trsMatrixSize);
         mRenderData.rdMatricesSize += trsMatrixSize + bufferMatrixSize;
 
+        /* cull first, the instances outside the view frustum need no bone matrices
+         * the first person camera moves the view below, but culling again would draw instances without a pose */
+        cullInstances(model, instances, numberOfInstances);
+
+        /* the first person camera needs the current bone matrix of the followed instance */
+        int alwaysUpdateInstanceIndex = camSettings.csCamType == cameraType::firstPerson ? followInstanceIndex : -1;
+        size_t numberOfUpdates = selectBoneUpdateInstances(model, instances, numberOfInstances,
+          camSettings.csWorldPosition, alwaysUpdateInstanceIndex);
+        mRenderData.rdNumberOfBoneUpdates += numberOfUpdates;
+        mRenderData.rdNumberOfAnimatedInstances += numberOfInstances;
+
+        /* feet IK only for freshly animated full skeletons, the reduced skeletons may still contain the last IK pose */
+        auto isFeetIKInstance = [&](size_t slot) {
+          int lodTier = mBoneUpdateLodTiers.at(slot);
+          return lodTier == 0 || (lodTier > 0 && !modSettings.msAnimationLodTiers.at(lodTier).altReducedSkeleton);
+        };
+
         mRenderData.rdMatrixGenerateTime += mMatrixGenerateTimer.stop();
 
         /* upload world matrices */
         mShaderModelRootMatrixBuffer.uploadSsboData(mWorldPosMatrices);
 
         /* calculate TRS matrices from node transforms */
-        if (model->hasHeadMovementAnimationsMapped()) {
-          mAssimpTransformHeadMoveComputeShader.use();
-        } else {
-          mAssimpTransformComputeShader.use();
-        }
+        Shader& transformComputeShader = getTransformComputeShader(model, model->hasHeadMovementAnimationsMapped());
+        transformComputeShader.use();
 
         mUploadToUBOTimer.start();
         model->bindAnimLookupBuffer(0);
         mPerInstanceAnimDataBuffer.uploadSsboData(mPerInstanceAnimData, 1);
-        mShaderTRSMatrixBuffer.bind(2);
+        trsMatrixBuffer.bind(2);
+        mBoneUpdateInstanceBuffer.bind(3);
+        model->bindBoneParentBuffer(4);
+        transformComputeShader.setUniformValue(modSettings.msReducedSkeletonDepth);
 
         mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-        /* do the computation - in groups of 32 invocations */
-        glDispatchCompute(numberOfBones, std::ceil(numberOfInstances / 32.0f), 1);
+        /* do the computation - in groups of 32 invocations, only for the instances to update */
+        glDispatchCompute(numberOfBones, std::ceil(numberOfUpdates / 32.0f), 1);
         glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
         /* multiply every bone TRS matrix with its parent bones TRS matrices, until the root bone has been reached
          * also, multiply the bone TRS and the bone offset matrix */
-        mAssimpMatrixComputeShader.use();
-
-        mUploadToUBOTimer.start();
-        mShaderTRSMatrixBuffer.bind(0);
-        model->bindBoneParentBuffer(1);
-        model->bindBoneMatrixOffsetBuffer(2);
-        mShaderBoneMatrixBuffer.bind(3);
-        mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
-
-        /* do the computation - in groups of 32 invocations */
-        glDispatchCompute(numberOfBones, std::ceil(numberOfInstances / 32.0f), 1);
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        runBoneMatrixComputeShader(model, numberOfBones, numberOfUpdates, trsMatrixBuffer, boneMatrixBuffer);
 
         std::shared_ptr<Camera> cam = mModelInstCamData.micCameras.at(mModelInstCamData.micSelectedCamera);
         CameraSettings camSettings = cam->getCameraSettings();
@@ -3838,7 +4991,7 @@ bool OGLRenderer::draw(float deltaTime) {
           int selectedBone = camSettings.csFirstPersonBoneToFollow;
           glm::mat4 offsetMatrix = glm::translate(glm::mat4(1.0f), camSettings.csFirstPersonOffsets);
           /* get the bone matrix of the selected bone from the SSBO */
-          glm::mat4 boneMatrix = mShaderBoneMatrixBuffer.getSsboDataMat4(selectedInstance * numberOfBones + selectedBone, 1).at(0);
+          glm::mat4 boneMatrix = boneMatrixBuffer.getSsboDataMat4(selectedInstance * numberOfBones + selectedBone, 1).at(0);
 
           cam->setBoneMatrix(mWorldPosMatrices.at(selectedInstance) * boneMatrix * offsetMatrix *
             model->getInverseBoneOffsetMatrix(selectedBone));
@@ -3858,13 +5011,89 @@ bool OGLRenderer::draw(float deltaTime) {
           mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
         }
 
-        /* inverse kinematics */
-        if (mRenderData.rdEnableFeetIK) {
+        /* inverse kinematics, the GPU solver needs no readbacks but the debug lines need the CPU data */
+        bool useGpuFeetIK = mRenderData.rdEnableGpuFeetIK && !mRenderData.rdDrawIKDebugLines;
+        for (const auto& chain : modSettings.msFootIKChainNodes) {
+          if (chain.size() > static_cast<size_t>(MAX_IK_CHAIN_NODES)) {
+            useGpuFeetIK = false;
+          }
+        }
+
+        if (mRenderData.rdEnableFeetIK && useGpuFeetIK) {
+          mIKTimer.start();
+
+          /* collect the ground triangles of all instances, the raycasts are done on the GPU */
+          mIKInstanceData.resize(numberOfInstances);
+          mIKGroundTrianglePoints.clear();
+          for (size_t i = 0; i < numberOfInstances; ++i) {
+            const InstanceSettings& instSettings = instances.at(i)->getInstanceSettings();
+            const std::vector<int>& collidingTriangles = instances.at(i)->getCollidingTriangles();
+
+            AABB instanceAABB = model->getAABB(instSettings);
+
+            IKInstanceData& instIKData = mIKInstanceData.at(i);
+            instIKData.triangleOffset = mIKGroundTrianglePoints.size() / 3;
+            instIKData.triangleCount = collidingTriangles.size();
+            instIKData.instanceHeight = instanceAABB.getMaxPos().y - instanceAABB.getMinPos().y;
+            instIKData.worldPosY = instSettings.isWorldPosition.y;
+
+            /* no ground triangles disable the solver, the TRS data of skipped instances already contains the IK rotations */
+            if (!isFeetIKInstance(i)) {
+              instIKData.triangleCount = 0;
+              continue;
+            }
+
+            for (const auto triIndex : collidingTriangles) {
+              for (const auto& point : mTriangleBVH->getTriangle(triIndex).points) {
+                mIKGroundTrianglePoints.emplace_back(point, 1.0f);
+              }
+            }
+          }
+
+          /* bones, instances and iterations, followed by the chain size and the node ids of both feet */
+          mIKChainData.assign(3 + 2 * (MAX_IK_CHAIN_NODES + 1), 0);
+          mIKChainData.at(0) = numberOfBones;
+          mIKChainData.at(1) = numberOfInstances;
+          mIKChainData.at(2) = mRenderData.rdNumberOfIkIteratons;
+          for (int foot = 0; foot < modSettings.msFootIKChainNodes.size(); ++foot) {
+            int chainStart = 3 + foot * (MAX_IK_CHAIN_NODES + 1);
+            mIKChainData.at(chainStart) = modSettings.msFootIKChainNodes.at(foot).size();
+            std::copy(modSettings.msFootIKChainNodes.at(foot).begin(), modSettings.msFootIKChainNodes.at(foot).end(),
+              mIKChainData.begin() + chainStart + 1);
+          }
+
+          /* solve FABRIK and rotate the chain nodes directly in the TRS buffer */
+          mAssimpFeetIKComputeShader.use();
+
+          mUploadToUBOTimer.start();
+          trsMatrixBuffer.bind(0);
+          model->bindBoneParentBuffer(1);
+          mShaderModelRootMatrixBuffer.bind(2);
+          mIKChainDataBuffer.uploadSsboData(mIKChainData, 3);
+          mIKInstanceDataBuffer.uploadSsboData(mIKInstanceData, 4);
+          mIKGroundTriangleBuffer.uploadSsboData(mIKGroundTrianglePoints, 5);
+          mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
+
+          /* one invocation per instance - in groups of 32 invocations */
+          glDispatchCompute(std::ceil(numberOfInstances / 32.0f), 1, 1);
+          glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+          /* recalculate all TRS matrices once */
+          runBoneMatrixComputeShader(model, numberOfBones, numberOfUpdates, trsMatrixBuffer, boneMatrixBuffer);
+
+          mRenderData.rdIKTime += mIKTimer.stop();
+        }
+
+        /* CPU solver, needs to read back the bone matrices after every chain node */
+        if (mRenderData.rdEnableFeetIK && !useGpuFeetIK) {
           mIKTimer.start();
 
+          /* instances skipped by the animation LOD get no ground */
+          const std::vector<int> noGroundTriangles{};
+
           /* read back all node positions for foot positions */
           mDownloadFromUBOTimer.start();
-          mShaderBoneMatrices = mShaderBoneMatrixBuffer.getSsboDataMat4();
+          mShaderBoneMatrices = boneMatrixBuffer.getSsboDataMat4();
           mRenderData.rdDownloadFromUBOTime += mDownloadFromUBOTimer.stop();
 
           for (int foot = 0; foot < modSettings.msFootIKChainPair.size(); ++foot) {
@@ -3873,7 +5102,7 @@ bool OGLRenderer::draw(float deltaTime) {
 
           /* get positions of left and right foot from final world positions */
           for (size_t i = 0; i < numberOfInstances; ++i) {
-            InstanceSettings instSettings = instances.at(i)->getInstanceSettings();
+            const InstanceSettings& instSettings = instances.at(i)->getInstanceSettings();
             for (int foot = 0; foot < modSettings.msFootIKChainPair.size(); ++foot) {
               int nodeChainSize = modSettings.msFootIKChainNodes[foot].size();
 
@@ -3896,7 +5125,12 @@ bool OGLRenderer::draw(float deltaTime) {
 
               OGLLineVertex vert;
               glm::vec3 hitPoint = footWorldPos;
-              for (const auto& tri : instSettings.isCollidingTriangles) {
+
+              /* without a hit, FABRIK keeps the chain and the rotations below are identity rotations */
+              const std::vector<int>& groundTriangles = isFeetIKInstance(i) ?
+                instances.at(i)->getCollidingTriangles() : noGroundTriangles;
+              for (const auto triIndex : groundTriangles) {
+                const MeshTriangle& tri = mTriangleBVH->getTriangle(triIndex);
                 std::optional<glm::vec3> result{};
 
                 /* raycast downwards from middle height to detect ground below foot */
@@ -3960,7 +5194,7 @@ bool OGLRenderer::draw(float deltaTime) {
 
           /* read current TRS values */
           mDownloadFromUBOTimer.start();
-          mTRSData = mShaderTRSMatrixBuffer.getSsboDataTRSMatrixData();
+          mTRSData = trsMatrixBuffer.getSsboDataTRSMatrixData();
           mRenderData.rdDownloadFromUBOTime += mDownloadFromUBOTimer.stop();
 
           /* we need to ROTATE the original bones to get the final position, starting with the root node */
@@ -4004,22 +5238,15 @@ bool OGLRenderer::draw(float deltaTime) {
               }
 
               /* recalculate all TRS matrices */
-              mAssimpMatrixComputeShader.use();
-
               mUploadToUBOTimer.start();
-              mShaderTRSMatrixBuffer.uploadSsboData(mTRSData, 0);
-              model->bindBoneParentBuffer(1);
-              model->bindBoneMatrixOffsetBuffer(2);
-              mShaderBoneMatrixBuffer.bind(3);
+              trsMatrixBuffer.uploadSsboData(mTRSData);
               mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-              /* do the computation - in groups of 32 invocations */
-              glDispatchCompute(numberOfBones, std::ceil(numberOfInstances / 32.0f), 1);
-              glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+              runBoneMatrixComputeShader(model, numberOfBones, numberOfUpdates, trsMatrixBuffer, boneMatrixBuffer);
 
               /* read (new) bone positions */
               mDownloadFromUBOTimer.start();
-              mShaderBoneMatrices = mShaderBoneMatrixBuffer.getSsboDataMat4();
+              mShaderBoneMatrices = boneMatrixBuffer.getSsboDataMat4();
               mRenderData.rdDownloadFromUBOTime += mDownloadFromUBOTimer.stop();
             }
           }
@@ -4027,45 +5254,42 @@ bool OGLRenderer::draw(float deltaTime) {
         }
 
         /* now bind the final bone transforms to the vertex skinning shader */
-        if (mMousePick && mRenderData.rdApplicationMode == appMode::edit) {
-          mAssimpSkinningSelectionShader.use();
-        } else {
-          mAssimpSkinningShader.use();
-        }
+        Shader& skinningShader = getModelShader(model, true, false);
+        skinningShader.use();
 
         /* draw all meshes without morph anims first */
         mUploadToUBOTimer.start();
-        mAssimpSkinningShader.setUniformValue(numberOfBones);
-        mShaderBoneMatrixBuffer.bind(1);
+        skinningShader.setUniformValue(numberOfBones);
+        boneMatrixBuffer.bind(1);
         mShaderModelRootMatrixBuffer.bind(2);
         mSelectedInstanceBuffer.uploadSsboData(mSelectedInstance, 3);
+        mVisibleInstanceBuffer.bind(6);
         mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-        model->drawInstancedNoMorphAnims(numberOfInstances);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, mDrawCommandBuffer.getBufferId());
+        model->drawInstancedIndirectNoMorphAnims();
 
         /* and if the model has morph anims, draw them in a separate pass */
         if (model->hasAnimMeshes()) {
           mFaceAnimTimer.start();
 
-          if (mMousePick && mRenderData.rdApplicationMode == appMode::edit) {
-            mAssimpSkinningMorphSelectionShader.use();
-          } else {
-            mAssimpSkinningMorphShader.use();
-          }
+          Shader& skinningMorphShader = getModelShader(model, true, true);
+          skinningMorphShader.use();
 
           mUploadToUBOTimer.start();
-          mAssimpSkinningMorphShader.setUniformValue(numberOfBones);
-          mShaderBoneMatrixBuffer.bind(1);
+          skinningMorphShader.setUniformValue(numberOfBones);
+          boneMatrixBuffer.bind(1);
           mShaderModelRootMatrixBuffer.bind(2);
           mSelectedInstanceBuffer.bind(3);
           model->bindMorphAnimBuffer(4);
           mFaceAnimPerInstanceDataBuffer.uploadSsboData(mFaceAnimPerInstanceData, 5);
           mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-          model->drawInstancedMorphAnims(numberOfInstances);
+          model->drawInstancedIndirectMorphAnims();
 
           mRenderData.rdFaceAnimTime += mFaceAnimTimer.stop();
         }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
       } else {
         /* non-animated models */
 
@@ -4074,105 +5298,40 @@ bool OGLRenderer::draw(float deltaTime) {
         mSelectedInstance.resize(numberOfInstances);
 
         for (size_t i = 0; i < numberOfInstances; ++i) {
-          InstanceSettings instSettings = instances.at(i)->getInstanceSettings();
-
+          int instanceIndex = instances.at(i)->getInstanceIndexPosition();
           if (mRenderData.rdApplicationMode == appMode::edit) {
-            if (currentSelectedInstance == instances.at(i)) {
+            if (instanceIndex == selectedInstanceIndex) {
               mSelectedInstance.at(i).x = mRenderData.rdSelectedInstanceHighlightValue;
             } else {
               mSelectedInstance.at(i).x = 1.0f;
             }
 
             if (mMousePick) {
-              mSelectedInstance.at(i).y = static_cast<float>(instSettings.isInstanceIndexPosition);
+              mSelectedInstance.at(i).y = static_cast<float>(instanceIndex);
             }
           } else {
             mSelectedInstance.at(i).x = 1.0f;
           }
 
-          /* get AABB and calculate 3D boundaries */
-          AABB instanceAABB = model->getAABB(instSettings);
-
-          glm::vec3 position = instanceAABB.getMinPos();
-          glm::vec3 size = glm::vec3(std::fabs(instanceAABB.getMaxPos().x - instanceAABB.getMinPos().x),
-                                     std::fabs(instanceAABB.getMaxPos().y - instanceAABB.getMinPos().y),
-                                     std::fabs(instanceAABB.getMaxPos().z - instanceAABB.getMinPos().z));
-
-          BoundingBox3D box{position, size};
-          instances.at(i)->setBoundingBox(box);
-
-          /* add instance to octree */
-          mOctree->add(instSettings.isInstanceIndexPosition);
-
-          /* gravity and ground collisions */
-          mLevelCollisionTimer.start();
-
-          /* extend the AABB a bit below the feet to allow a better ground collision handling */
-          glm::vec3 instBoxPos = position - mRenderData.rdLevelCollisionAABBExtension;
-          glm::vec3 instBoxSize = size + mRenderData.rdLevelCollisionAABBExtension;
-          BoundingBox3D instanceBox{instBoxPos, instBoxSize};
-
-          std::vector<MeshTriangle> collidingTriangles = mTriangleOctree->query(instanceBox);
-          instances.at(i)->setCollidingTriangles(collidingTriangles);
-
-          /* set state to "instance on ground" if gravity is disabled */
-          bool instanceOnGround = true;
-          if (mRenderData.rdEnableSimpleGravity) {
-            glm::vec3 gravity = glm::vec3(0.0f, GRAVITY_CONSTANT * deltaTime, 0.0f);
-            glm::vec3 footPoint = instSettings.isWorldPosition;
-
-            instanceOnGround = false;
-            for (const auto& tri : collidingTriangles) {
-              /* check for slope */
-              bool isWalkable = false;
-              if (glm::dot(tri.normal, glm::vec3(0.0f, 1.0f, 0.0f)) >= std::cos(glm::radians(mRenderData.rdMaxLevelGroundSlopeAngle))) {
-                isWalkable = true;
-              }
-
-              if (isWalkable) {
-                std::optional<glm::vec3> result = Tools::rayTriangleIntersection(instSettings.isWorldPosition - gravity, glm::vec3(0.0f, 1.0f, 0.0f), tri);
-                if (result.has_value()) {
-                  footPoint = result.value();
-                  instances.at(i)->setWorldPosition(footPoint);
-                  instanceOnGround = true;
-                }
-              }
-            }
-          }
-          instances.at(i)->setInstanceOnGround(instanceOnGround);
-          instances.at(i)->applyGravity(deltaTime);
-          mRenderData.rdLevelCollisionTime += mLevelCollisionTimer.stop();
-
-          instances.at(i)->updateInstancePosition(deltaTime);
           mWorldPosMatrices.at(i) = instances.at(i)->getWorldTransformMatrix();
         }
 
         mRenderData.rdMatrixGenerateTime += mMatrixGenerateTimer.stop();
         mRenderData.rdMatricesSize += mWorldPosMatrices.size() * sizeof(glm::mat4);
 
-        if (mMousePick && mRenderData.rdApplicationMode == appMode::edit) {
-          mAssimpSelectionShader.use();
-        } else {
-          mAssimpShader.use();
-        }
+        cullInstances(model, instances, numberOfInstances);
+
+        getModelShader(model, false, false).use();
 
         mUploadToUBOTimer.start();
         mShaderModelRootMatrixBuffer.uploadSsboData(mWorldPosMatrices, 1);
         mSelectedInstanceBuffer.uploadSsboData(mSelectedInstance, 2);
+        mVisibleInstanceBuffer.bind(6);
         mRenderData.rdUploadToUBOTime += mUploadToUBOTimer.stop();
 
-        model->drawInstanced(numberOfInstances);
-      }
-
-      /* remove instances that fell out of the level boundaries */
-      for (size_t i = 0; i < numberOfInstances; ++i) {
-        InstanceSettings instSettings = instances.at(i)->getInstanceSettings();
-
-        if (instSettings.isWorldPosition.y < mRenderData.rdWorldStartPos.y - 50.0f) {
-          int instanceId = instSettings.isInstanceIndexPosition;
-          Logger::log(1, "%s warning: instance id %i fell out of level boundaries, deleting\n", __FUNCTION__, instanceId);
-          deleteInstance(getInstanceById(instanceId));
-        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, mDrawCommandBuffer.getBufferId());
+        model->drawInstancedIndirect();
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
       }
     }
   }
@@ -4182,7 +5341,7 @@ bool OGLRenderer::draw(float deltaTime) {
   mLineMesh->vertices.clear();
   if (mRenderData.rdApplicationMode == appMode::edit) {
     if (mModelInstCamData.micSelectedInstance > 0) {
-      InstanceSettings instSettings = mModelInstCamData.micAssimpInstances.at(mModelInstCamData.micSelectedInstance)->getInstanceSettings();
+      const InstanceSettings& instSettings = mModelInstCamData.micAssimpInstances.at(mModelInstCamData.micSelectedInstance)->getInstanceSettings();
 
       /* draw coordiante arrows at origin of selected instance */
       switch(mRenderData.rdInstanceEditMode) {
@@ -4243,12 +5402,6 @@ bool OGLRenderer::draw(float deltaTime) {
   drawInteractionDebug();
   mRenderData.rdInteractionTime += mInteractionTimer.stop();
 
-  /* check for collisions */
-  mCollisionCheckTimer.start();
-  checkForInstanceCollisions();
-  checkForBorderCollisions();
-  mRenderData.rdCollisionCheckTime += mCollisionCheckTimer.stop();
-
   mCollisionDebugDrawTimer.start();
   drawCollisionDebug();
   mRenderData.rdCollisionDebugDrawTime += mCollisionDebugDrawTimer.stop();
@@ -4256,8 +5409,6 @@ bool OGLRenderer::draw(float deltaTime) {
   /* level stuff */
   if (mModelInstCamData.micLevels.size() > 1) {
     mLevelCollisionTimer.start();
-    checkForLevelCollisions();
-
     if (mRenderData.rdDrawLevelAABB) {
       drawLevelAABB();
     }
@@ -4266,8 +5417,8 @@ bool OGLRenderer::draw(float deltaTime) {
       drawLevelWireframe();
     }
 
-    if (mRenderData.rdDrawLevelOctree) {
-      drawLevelOctree();
+    if (mRenderData.rdDrawLevelBVH) {
+      drawLevelBVH();
     }
 
     if (mRenderData.rdDrawLevelCollisionTriangles) {
@@ -4297,11 +5448,6 @@ bool OGLRenderer::draw(float deltaTime) {
   }
   mRenderData.rdIKTime += mIKTimer.stop();
 
-  /* behavior update */
-  mBehviorTimer.start();
-  mBehaviorManager->update(deltaTime);
-  mRenderData.rdBehaviorTime += mBehviorTimer.stop();
-
   mFramebuffer.unbind();
 
   /* blit color buffer to screen */
@@ -4320,6 +5466,7 @@ bool OGLRenderer::draw(float deltaTime) {
   /* always draw the status bar and instance positions window */
   mUserInterface.createStatusBar(mRenderData, mModelInstCamData);
   mUserInterface.createPositionsWindow(mRenderData, mModelInstCamData);
+  mUserInterface.createAssetLoadingWindow(mRenderData);
 
   /* only loaded data right now */
   if (mGraphEditor->getShowEditor()) {
@@ -4336,10 +5483,39 @@ bool OGLRenderer::draw(float deltaTime) {
   mUserInterface.render();
   mRenderData.rdUIDrawTime = mUIDrawTimer.stop();
 
+  endFrame();
+
   return true;
 }
 
+void OGLRenderer::endFrame() {
+  mRenderData.rdInstanceDataUploadSize = mShaderModelRootMatrixBuffer.getUploadedBytes() +
+    mPerInstanceAnimDataBuffer.getUploadedBytes() + mSelectedInstanceBuffer.getUploadedBytes() +
+    mFaceAnimPerInstanceDataBuffer.getUploadedBytes() + mCullingAABBBuffer.getUploadedBytes() +
+    mBoneUpdateInstanceBuffer.getUploadedBytes();
+
+  /* size the sections for all instances, the ring buffers grow between two frames only */
+  size_t numberOfInstances = mModelInstCamData.micAssimpInstances.size();
+  mShaderModelRootMatrixBuffer.checkForResize(numberOfInstances * sizeof(glm::mat4));
+  mPerInstanceAnimDataBuffer.checkForResize(numberOfInstances * sizeof(PerInstanceAnimData));
+  mSelectedInstanceBuffer.checkForResize(numberOfInstances * sizeof(glm::vec2));
+  mFaceAnimPerInstanceDataBuffer.checkForResize(numberOfInstances * sizeof(glm::vec4));
+  mCullingAABBBuffer.checkForResize(numberOfInstances * 2 * sizeof(glm::vec4));
+  mBoneUpdateInstanceBuffer.checkForResize(numberOfInstances * sizeof(uint32_t));
+
+  mShaderModelRootMatrixBuffer.nextFrame();
+  mPerInstanceAnimDataBuffer.nextFrame();
+  mSelectedInstanceBuffer.nextFrame();
+  mFaceAnimPerInstanceDataBuffer.nextFrame();
+  mCullingAABBBuffer.nextFrame();
+  mBoneUpdateInstanceBuffer.nextFrame();
+}
+
 void OGLRenderer::cleanup() {
+  mJobSystem.cleanup();
+  mPathService.cleanup();
+  mAssetLoader.cleanup();
+
   /* delete models and levels to destroy OpenGL objects */
   for (const auto& model : mModelInstCamData.micModelList) {
     model->cleanup();
@@ -4349,6 +5525,9 @@ void OGLRenderer::cleanup() {
     model->cleanup();
   }
 
+  /* after the models, they release their textures in cleanup() */
+  mTextureManager.cleanup();
+
   for (const auto& level : mModelInstCamData.micLevels) {
     level->cleanup();
   }
@@ -4365,17 +5544,49 @@ void OGLRenderer::cleanup() {
   mEmptyBoneOffsetBuffer.cleanup();
   mBoundingSphereBuffer.cleanup();
   mBoundingSphereAdjustmentBuffer.cleanup();
+  mCollisionSphereBuffer.cleanup();
+  mSpherePairBuffer.cleanup();
+  mCollidingPairBuffer.cleanup();
   mFaceAnimPerInstanceDataBuffer.cleanup();
   mEmptyWorldPositionBuffer.cleanup();
+  mIKChainDataBuffer.cleanup();
+  mIKInstanceDataBuffer.cleanup();
+  mIKGroundTriangleBuffer.cleanup();
+  mCullingAABBBuffer.cleanup();
+  mCullingParameterBuffer.cleanup();
+  mVisibleInstanceBuffer.cleanup();
+  mDrawCommandBuffer.cleanup();
+  mBoneUpdateInstanceBuffer.cleanup();
+  for (auto& buffer : mLodTRSMatrixBuffers) {
+    buffer.second.cleanup();
+  }
+  for (auto& buffer : mLodBoneMatrixBuffers) {
+    buffer.second.cleanup();
+  }
 
   mAssimpTransformHeadMoveComputeShader.cleanup();
   mAssimpTransformComputeShader.cleanup();
+  mAssimpTransformHeadMoveCompressedComputeShader.cleanup();
+  mAssimpTransformCompressedComputeShader.cleanup();
   mAssimpMatrixComputeShader.cleanup();
+  mAssimpMatrixLevelComputeShader.cleanup();
+  mAssimpFeetIKComputeShader.cleanup();
+  mAssimpInstanceCullingShader.cleanup();
+
+  mBoneMatrixGpuTimer.cleanup();
   mAssimpBoundingBoxComputeShader.cleanup();
+  mAssimpSphereCollisionComputeShader.cleanup();
+  mAssimpAABBLookupComputeShader.cleanup();
 
   mSkyboxShader.cleanup();
   mGroundMeshShader.cleanup();
   mAssimpLevelShader.cleanup();
+  mAssimpSkinningMorphSelectionPackedShader.cleanup();
+  mAssimpSkinningSelectionPackedShader.cleanup();
+  mAssimpSkinningMorphPackedShader.cleanup();
+  mAssimpSelectionPackedShader.cleanup();
+  mAssimpSkinningPackedShader.cleanup();
+  mAssimpPackedShader.cleanup();
   mAssimpSkinningMorphSelectionShader.cleanup();
   mAssimpSkinningSelectionShader.cleanup();
   mAssimpSkinningMorphShader.cleanup();
@@ -4385,12 +5596,14 @@ void OGLRenderer::cleanup() {
   mSphereShader.cleanup();
   mLineShader.cleanup();
 
-  mUserInterface.cleanup();
+  if (mRenderData.rdWindow) {
+    mUserInterface.cleanup();
+  }
 
   mGroundMeshVertexBuffer.cleanup();
   mIKLinesVertexBuffer.cleanup();
   mLevelWireframeVertexBuffer.cleanup();
-  mLevelOctreeVertexBuffer.cleanup();
+  mLevelBVHVertexBuffer.cleanup();
   mLevelAABBVertexBuffer.cleanup();
   mLineVertexBuffer.cleanup();
   mUniformBuffer.cleanup();
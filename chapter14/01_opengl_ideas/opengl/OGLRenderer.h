@@ -3,8 +3,10 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <chrono>
 #include <random>
+#include <atomic>
 
 #include <glm/glm.hpp>
 
@@ -12,9 +14,12 @@
 #include <GLFW/glfw3.h>
 
 #include "Timer.h"
+#include "GpuTimer.h"
+#include "AllocationCounter.h"
 #include "Framebuffer.h"
 #include "LineVertexBuffer.h"
 #include "Texture.h"
+#include "TextureManager.h"
 #include "Shader.h"
 #include "UniformBuffer.h"
 #include "ShaderStorageBuffer.h"
@@ -28,8 +33,10 @@
 #include "AssimpModel.h"
 #include "AssimpInstance.h"
 #include "Octree.h"
+#include "InstanceGrid.h"
+#include "InstanceSweepAndPrune.h"
 #include "BoundingBox3D.h"
-#include "TriangleOctree.h"
+#include "TriangleBVH.h"
 #include "GraphEditor.h"
 #include "SingleInstanceBehavior.h"
 #include "BehaviorManager.h"
@@ -38,22 +45,35 @@
 #include "IKSolver.h"
 #include "SimpleVertexBuffer.h"
 #include "PathFinder.h"
+#include "PathService.h"
+#include "LevelDataCache.h"
+#include "AABBLookupCache.h"
 #include "SkyboxBuffer.h"
 #include "SkyboxModel.h"
+#include "JobSystem.h"
+#include "AssetLoader.h"
 
 #include "OGLRenderData.h"
 #include "ModelInstanceCamData.h"
 
 #include "Callbacks.h"
 
+class YamlParser;
+
 class OGLRenderer {
   public:
     OGLRenderer(GLFWwindow *window);
+    /* headless, the caller has created and bound a context without a window (i.e. through EGL) */
+    OGLRenderer(GLADloadproc glLoadFunction);
 
-    bool init(unsigned int width, unsigned int height);
+    bool init(unsigned int width, unsigned int height, std::string configFileName = std::string());
     void setSize(unsigned int width, unsigned int height);
     void uploadAssimpData(OGLMesh vertexData);
+    /* CPU-side simulation step only, does not draw anything */
+    void updateWorld(float deltaTime);
     bool draw(float deltaTime);
+    /* switches the per-frame ring buffers to the next section, call after every updateWorld() */
+    void endFrame();
     void handleKeyEvents(int key, int scancode, int action, int mods);
     void handleMouseButtonEvents(int button, int action, int mods);
     void handleMousePositionEvents(double xPos, double yPos);
@@ -101,6 +121,7 @@ class OGLRenderer {
     ModelInstanceCamData& getModInstCamData();
 
     std::shared_ptr<BoundingBox3D> getWorldBoundaries();
+    PathFinder& getPathFinder();
 
     void cleanup();
 
@@ -122,8 +143,14 @@ class OGLRenderer {
     Timer mFaceAnimTimer{};
     Timer mLevelCollisionTimer{};
     Timer mIKTimer{};
+    GpuTimer mBoneMatrixGpuTimer{};
+    Timer mCullingTimer{};
     Timer mLevelGroundNeighborUpdateTimer{};
     Timer mPathFindingTimer{};
+    Timer mInstanceUpdateTimer{};
+
+    AllocationCounter mFrameAllocationCounter{};
+    AllocationCounter mWorldUpdateAllocationCounter{};
 
     Shader mLineShader{};
     Shader mSphereShader{};
@@ -135,10 +162,24 @@ class OGLRenderer {
     Shader mAssimpSkinningSelectionShader{};
     Shader mAssimpSkinningMorphSelectionShader{};
 
+    Shader mAssimpPackedShader{};
+    Shader mAssimpSkinningPackedShader{};
+    Shader mAssimpSkinningMorphPackedShader{};
+    Shader mAssimpSelectionPackedShader{};
+    Shader mAssimpSkinningSelectionPackedShader{};
+    Shader mAssimpSkinningMorphSelectionPackedShader{};
+
     Shader mAssimpTransformComputeShader{};
     Shader mAssimpTransformHeadMoveComputeShader{};
+    Shader mAssimpTransformCompressedComputeShader{};
+    Shader mAssimpTransformHeadMoveCompressedComputeShader{};
     Shader mAssimpMatrixComputeShader{};
+    Shader mAssimpMatrixLevelComputeShader{};
+    Shader mAssimpFeetIKComputeShader{};
+    Shader mAssimpInstanceCullingShader{};
     Shader mAssimpBoundingBoxComputeShader{};
+    Shader mAssimpSphereCollisionComputeShader{};
+    Shader mAssimpAABBLookupComputeShader{};
 
     Shader mAssimpLevelShader{};
     Shader mGroundMeshShader{};
@@ -148,7 +189,7 @@ class OGLRenderer {
     Framebuffer mFramebuffer{};
     LineVertexBuffer mLineVertexBuffer{};
     LineVertexBuffer mLevelAABBVertexBuffer{};
-    LineVertexBuffer mLevelOctreeVertexBuffer{};
+    LineVertexBuffer mLevelBVHVertexBuffer{};
     LineVertexBuffer mLevelWireframeVertexBuffer{};
     LineVertexBuffer mIKLinesVertexBuffer{};
     SimpleVertexBuffer mGroundMeshVertexBuffer{};
@@ -176,6 +217,12 @@ class OGLRenderer {
     /* per-model-and-node adjustments for the spheres */
     ShaderStorageBuffer mBoundingSphereAdjustmentBuffer{};
 
+    /* spheres of all instances in a broadphase pair, copied per model on the GPU */
+    ShaderStorageBuffer mCollisionSphereBuffer{};
+    ShaderStorageBuffer mSpherePairBuffer{};
+    /* append buffer: counter, followed by the indices of the colliding sphere pairs */
+    ShaderStorageBuffer mCollidingPairBuffer{};
+
     std::vector<AABB> mPerInstanceAABB{};
     std::shared_ptr<OGLLineMesh> mAABBMesh = nullptr;
 
@@ -219,6 +266,47 @@ class OGLRenderer {
     void updateLevelTriangleCount();
     void assignInstanceIndices();
 
+    /* plain or compressed animation lookups, with or without head movement */
+    Shader& getTransformComputeShader(std::shared_ptr<AssimpModel> model, bool withHeadMovement);
+    /* plain or packed vertices, static or skinned, with or without morph anims and selection */
+    Shader& getModelShader(std::shared_ptr<AssimpModel> model, bool skinned, bool withMorphAnims);
+
+    /* size of the shared memory matrix cache in the level order shader */
+    const size_t MAX_LEVEL_ORDER_BONES = 256;
+    void runBoneMatrixComputeShader(std::shared_ptr<AssimpModel> model, size_t numberOfBones, size_t numberOfUpdates,
+      ShaderStorageBuffer& trsMatrixBuffer, ShaderStorageBuffer& boneMatrixBuffer);
+
+    /* animation LOD, skipped instances keep the bone matrices of their last update, so every model needs its own buffers */
+    std::unordered_map<std::string, ShaderStorageBuffer> mLodTRSMatrixBuffers{};
+    std::unordered_map<std::string, ShaderStorageBuffer> mLodBoneMatrixBuffers{};
+    /* global instance index per slot at the last update, a different instance in the slot forces an update */
+    std::unordered_map<std::string, std::vector<int>> mLodUpdatedInstanceIndices{};
+    /* number of updates, followed by the per-model indices of the instances to update */
+    std::vector<uint32_t> mBoneUpdateInstances{};
+    ShaderStorageBuffer mBoneUpdateInstanceBuffer{};
+    /* LOD tier of every instance in this frame, -1 if the bone matrices are not updated */
+    std::vector<int> mBoneUpdateLodTiers{};
+    unsigned int mAnimationLodFrameCounter = 0;
+    const uint32_t REDUCED_SKELETON_BIT = 0x80000000;
+
+    size_t selectBoneUpdateInstances(std::shared_ptr<AssimpModel> model,
+      const std::vector<std::shared_ptr<AssimpInstance>>& instances, size_t numberOfInstances, glm::vec3 cameraPosition, int alwaysUpdateInstanceIndex);
+    /* update every instance, for the lookup and bounding sphere passes */
+    void uploadAllBoneUpdateInstances(size_t numberOfInstances);
+
+    /* frustum culling on the GPU, fills the visible instance list and the indirect draw commands of the model
+     * the CPU does the same test for the bone matrix updates */
+    void cullInstances(std::shared_ptr<AssimpModel> model, const std::vector<std::shared_ptr<AssimpInstance>>& instances,
+      size_t numberOfInstances);
+    ShaderStorageBuffer mCullingAABBBuffer{};
+    ShaderStorageBuffer mCullingParameterBuffer{};
+    ShaderStorageBuffer mVisibleInstanceBuffer{};
+    ShaderStorageBuffer mDrawCommandBuffer{};
+    std::vector<glm::vec4> mCullingAABBs{};
+    CullingParameters mCullingParameters{};
+    /* per-model slot, instances outside the view frustum get no bone matrix update */
+    std::vector<bool> mInstanceVisible{};
+
     /* create identity matrix by default */
     glm::mat4 mViewMatrix = glm::mat4(1.0f);
     glm::mat4 mProjectionMatrix = glm::mat4(1.0f);
@@ -243,10 +331,30 @@ class OGLRenderer {
     bool saveConfigFile(std::string configFileName);
     void createEmptyConfig();
 
+    /* shared by all models, unused textures are evicted when the deleted models are cleaned up */
+    TextureManager mTextureManager{};
+    void deletePendingModels();
+
+    /* the models of a config are prepared on the asset loader threads, the GL objects are created in draw() */
+    AssetLoader mAssetLoader{};
+    bool mConfigLoadPending = false;
+    std::shared_ptr<YamlParser> mPendingConfigParser = nullptr;
+    std::vector<std::shared_ptr<AssimpModel>> mPendingConfigModels{};
+    Timer mConfigLoadTimer{};
+    /* levels and config parsing, before the asset jobs started */
+    float mConfigLoadTime = 0.0f;
+    void updateConfigLoading();
+    bool finishConfigLoading();
+    void cancelConfigLoading();
+    bool restoreConfigSettings(YamlParser& parser);
+
     void loadDefaultFreeCam();
 
     bool mConfigIsDirty = false;
     std::string mWindowTitleDirtySign;
+
+    /* no user interface and no window calls without a window */
+    GLADloadproc mGLLoadFunction = nullptr;
     void setConfigDirtyFlag(bool flag);
     bool getConfigDirtyFlag();
 
@@ -260,11 +368,21 @@ class OGLRenderer {
     std::vector<glm::vec3> getPositionOfAllInstances();
 
     void initOctree(int thresholdPerBox, int maxDepth);
+    /* refills the octree from the last world update, only needed for the minimap */
+    void updateOctree();
     std::shared_ptr<Octree> mOctree = nullptr;
+    bool mOctreeDirty = true;
+    /* broadphase for the instance collisions and the interaction queries */
+    InstanceGrid mInstanceGrid{};
+    InstanceSweepAndPrune mInstanceSweepAndPrune{};
+    /* contact changes against the collisions of the last frame */
+    std::vector<std::pair<int, int>> mPreviousInstanceCollisions{};
+    std::vector<std::pair<int, int>> mBeginInstanceCollisions{};
+    std::vector<std::pair<int, int>> mEndInstanceCollisions{};
     std::shared_ptr<BoundingBox3D> mWorldBoundaries = nullptr;
 
     void createAABBLookup(std::shared_ptr<AssimpModel> model);
-    void drawAABBs(std::vector<std::shared_ptr<AssimpInstance>> instances, glm::vec4 aabbColor);
+    void drawAABBs(const std::vector<std::shared_ptr<AssimpInstance>>& instances, glm::vec4 aabbColor);
     void drawCollisionDebug();
     void drawSelectedBoundingSpheres();
     void drawCollidingBoundingSpheres();
@@ -272,7 +390,15 @@ class OGLRenderer {
 
     void runBoundingSphereComputeShaders(std::shared_ptr<AssimpModel> model, int numberOfBones, int numInstances);
 
-    std::map<int, std::vector<glm::vec4>> mBoundingSpheresPerInstance{};
+    /* offset and number of spheres in mCollisionSphereBuffer, indexed by instance id */
+    std::vector<glm::uvec2> mSphereRangePerInstance{};
+    std::vector<SpherePair> mSpherePairs{};
+    /* position of the sphere pairs in micInstanceCollisions */
+    std::vector<size_t> mSpherePairCollisionIndices{};
+    /* per-frame collision data, cleared but not freed */
+    std::map<std::string, std::vector<int>> mSphereCollisionInstances{};
+    std::vector<bool> mKeepInstanceCollisions{};
+    std::vector<uint32_t> mCollidingSpherePairs{};
 
     void checkForInstanceCollisions();
     void checkForBorderCollisions();
@@ -296,24 +422,36 @@ class OGLRenderer {
 
     void generateLevelVertexData();
     void generateLevelAABB();
-    void generateLevelOctree();
+    void generateLevelBVH();
+    void generateLevelBVHMesh();
     void generateLevelWireframe();
 
+    std::unordered_map<std::string, uint64_t> mLevelFileHashes{};
+    std::string mLevelDataCacheDirectory = "cache/";
+    bool mLevelDataCacheSavePending = false;
+    std::chrono::time_point<std::chrono::steady_clock> mLevelDataCacheSaveTime{};
+    const std::chrono::seconds LEVEL_DATA_CACHE_SAVE_DELAY = std::chrono::seconds(2);
+
+    uint64_t getLevelDataCacheKey();
+    std::string getLevelDataCacheFileName();
+    bool loadLevelDataCache();
+    void saveLevelDataCache();
+
     void drawLevelAABB();
-    void drawLevelOctree();
+    void drawLevelBVH();
     void drawLevelWireframe();
     void drawLevelCollisionTriangles();
 
     void resetLevelData();
-    void initTriangleOctree(int thresholdPerBox, int maxDepth);
-    std::shared_ptr<TriangleOctree> mTriangleOctree = nullptr;
+    /* processed triangles of all levels, also written to the level data cache */
+    std::shared_ptr<TriangleBVH> mTriangleBVH = nullptr;
 
     void checkForLevelCollisions();
     const float GRAVITY_CONSTANT = 9.81f;
 
     AABB mAllLevelAABB{};
     std::shared_ptr<OGLLineMesh> mLevelAABBMesh = nullptr;
-    std::shared_ptr<OGLLineMesh> mLevelOctreeMesh = nullptr;
+    std::shared_ptr<OGLLineMesh> mLevelBVHMesh = nullptr;
     std::shared_ptr<OGLLineMesh> mLevelWireframeMesh = nullptr;
     std::shared_ptr<OGLLineMesh> mLevelCollidingTriangleMesh = nullptr;
 
@@ -324,10 +462,36 @@ class OGLRenderer {
     std::vector<glm::vec3> mIKSolvedPositions{};
     std::vector<TRSMatrixData> mTRSData{};
 
+    /* GPU feet IK, longer chains fall back to the CPU solver */
+    const int MAX_IK_CHAIN_NODES = 16;
+    ShaderStorageBuffer mIKChainDataBuffer{};
+    ShaderStorageBuffer mIKInstanceDataBuffer{};
+    ShaderStorageBuffer mIKGroundTriangleBuffer{};
+    std::vector<int> mIKChainData{};
+    std::vector<IKInstanceData> mIKInstanceData{};
+    std::vector<glm::vec4> mIKGroundTrianglePoints{};
+
     void drawIKDebugLines();
 
     PathFinder mPathFinder{};
     void generateGroundTriangleData();
+
+    /* path searches on background threads, results are applied at the start of the world update */
+    PathService mPathService{};
+    PathResult mPathResult{};
+    void applyPathResults();
+    /* one flow field per target instance, rebuilt before the parallel path update if the target changed its triangle */
+    std::unordered_map<int, std::unique_ptr<FlowField>> mFlowFields{};
+    std::vector<int> mFlowFieldTargets{};
+    std::vector<FlowField*> mDirtyFlowFields{};
+    std::vector<int> mDirtyFlowFieldTargetTris{};
+    void updateFlowFields();
+    void updateInstanceFlowFieldPath(std::shared_ptr<AssimpInstance> instance, int pathTargetInstance, int pathTargetTriIndex,
+      glm::vec3 pathTargetWorldPos, float deltaTime, std::vector<OGLLineVertex>& pathVertices);
+
+    /* statistics of the synchronous searches, written by the job system threads */
+    std::atomic<size_t> mPathQueries = 0;
+    std::atomic<size_t> mPathNodesExpanded = 0;
     std::shared_ptr<OGLLineMesh> mLevelGroundNeighborsMesh = nullptr;
     std::shared_ptr<OGLLineMesh> mInstancePathMesh = nullptr;
 
@@ -344,4 +508,17 @@ class OGLRenderer {
     Texture mSkyboxTexture{};
     SkyboxModel mSkyboxModel{};
     SkyboxBuffer mSkyboxBuffer{};
+
+    /* per-instance world update, phases run in parallel on the job system */
+    void updateInstanceSimulation(std::shared_ptr<AssimpInstance> instance, float deltaTime);
+    void updateInstancePath(std::shared_ptr<AssimpInstance> instance, float deltaTime, std::vector<OGLLineVertex>& pathVertices);
+    void updateInstanceGroundNeighbors(std::shared_ptr<AssimpInstance> instance, std::vector<OGLLineVertex>& neighborVertices);
+
+    JobSystem mJobSystem{};
+    const size_t WORLD_UPDATE_CHUNK_SIZE = 16;
+    std::vector<std::shared_ptr<AssimpInstance>> mWorldUpdateInstances{};
+    std::vector<std::shared_ptr<AssimpInstance>> mWorldUpdateAnimatedInstances{};
+    /* debug vertices per animated instance, merged in instance order after the parallel phases */
+    std::vector<std::vector<OGLLineVertex>> mInstancePathVertices{};
+    std::vector<std::vector<OGLLineVertex>> mInstanceNeighborVertices{};
 };
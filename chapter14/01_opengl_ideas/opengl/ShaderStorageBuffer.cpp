@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cstring>
+
 #include "ShaderStorageBuffer.h"
 
 void ShaderStorageBuffer::init(size_t bufferSize) {
@@ -10,21 +13,231 @@ void ShaderStorageBuffer::init(size_t bufferSize) {
   glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
+void ShaderStorageBuffer::initRingBuffer(size_t sectionSize) {
+  GLint offsetAlignment = 1;
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+  mOffsetAlignment = std::max(1, offsetAlignment);
+
+  /* every section must start on an aligned offset */
+  mRingSectionSize = ((std::max<size_t>(sectionSize, 1) + mOffsetAlignment - 1) / mOffsetAlignment) * mOffsetAlignment;
+  mBufferSize = mRingSectionSize * RING_BUFFER_SECTIONS;
+  mRingSectionOffset = 0;
+  mCurrentRingSection = 0;
+  mRingSectionFences.fill(nullptr);
+  mIsRingBuffer = true;
+
+  GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+  glGenBuffers(1, &mShaderStorageBuffer);
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
+  glBufferStorage(GL_SHADER_STORAGE_BUFFER, mBufferSize, nullptr, flags);
+  mMappedData = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, mBufferSize, flags);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  if (!mMappedData) {
+    Logger::log(1, "%s error: could not map SSBO %i\n", __FUNCTION__, mShaderStorageBuffer);
+  }
+}
+
+void ShaderStorageBuffer::uploadData(const void* data, size_t dataSize) {
+  mUploadedBytes += dataSize;
+
+  if (!mIsRingBuffer) {
+    if (dataSize > mBufferSize) {
+      Logger::log(1, "%s: resizing SSBO %i from %i to %i bytes\n", __FUNCTION__, mShaderStorageBuffer, mBufferSize, dataSize);
+      cleanup();
+      init(dataSize);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, dataSize, data);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    mLastUploadBuffer = mShaderStorageBuffer;
+    mLastUploadOffset = 0;
+    mLastUploadSize = dataSize;
+    return;
+  }
+
+  size_t alignedSize = ((dataSize + mOffsetAlignment - 1) / mOffsetAlignment) * mOffsetAlignment;
+  mRingFrameBytes += alignedSize;
+
+  /* the sections may be in use by the GPU, never recreate the buffer within a frame */
+  if (dataSize > mRingSectionSize || !mMappedData) {
+    uploadToOverflowBuffer(data, dataSize);
+    return;
+  }
+
+  /* section full: spill into the next section, the sections will grow in nextFrame() */
+  if (mRingSectionOffset + dataSize > mRingSectionSize) {
+    advanceRingSection();
+  }
+
+  size_t offset = mCurrentRingSection * mRingSectionSize + mRingSectionOffset;
+  std::memcpy(static_cast<char*>(mMappedData) + offset, data, dataSize);
+
+  mLastUploadBuffer = mShaderStorageBuffer;
+  mLastUploadOffset = offset;
+  mLastUploadSize = dataSize;
+
+  mRingSectionOffset += alignedSize;
+}
+
+void ShaderStorageBuffer::uploadToOverflowBuffer(const void* data, size_t dataSize) {
+  GLuint overflowBuffer = 0;
+  glGenBuffers(1, &overflowBuffer);
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, overflowBuffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, dataSize, data, GL_STREAM_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  mOverflowBuffers.emplace_back(overflowBuffer);
+
+  mLastUploadBuffer = overflowBuffer;
+  mLastUploadOffset = 0;
+  mLastUploadSize = dataSize;
+}
+
+void ShaderStorageBuffer::deleteOverflowBuffers() {
+  if (mOverflowBuffers.empty()) {
+    return;
+  }
+
+  /* the driver keeps the storage alive until all pending draws have used it */
+  glDeleteBuffers(static_cast<GLsizei>(mOverflowBuffers.size()), mOverflowBuffers.data());
+  mOverflowBuffers.clear();
+}
+
+void ShaderStorageBuffer::bindLastUpload(int bindingPoint) {
+  if (mLastUploadSize == 0) {
+    return;
+  }
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, mLastUploadBuffer);
+  glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingPoint, mLastUploadBuffer, mLastUploadOffset,
+    mLastUploadSize);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
 void ShaderStorageBuffer::bind(int bindingPoint) {
   if (mBufferSize == 0) {
     return;
   }
 
+  /* the ring buffer has the data somewhere inside the current section */
+  if (mIsRingBuffer) {
+    bindLastUpload(bindingPoint);
+    return;
+  }
+
   glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
   glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPoint, mShaderStorageBuffer);
   glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
+void ShaderStorageBuffer::copyFromBuffer(ShaderStorageBuffer& sourceBuffer, size_t sourceOffset, size_t targetOffset, size_t dataSize) {
+  if (dataSize == 0) {
+    return;
+  }
+
+  if (sourceOffset + dataSize > sourceBuffer.getBufferSize() || targetOffset + dataSize > mBufferSize) {
+    Logger::log(1, "%s error: copy of %i bytes from SSBO %i to SSBO %i out of range\n", __FUNCTION__, dataSize,
+      sourceBuffer.getBufferId(), mShaderStorageBuffer);
+    return;
+  }
+
+  glBindBuffer(GL_COPY_READ_BUFFER, sourceBuffer.getBufferId());
+  glBindBuffer(GL_COPY_WRITE_BUFFER, mShaderStorageBuffer);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceOffset, targetOffset, dataSize);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+void ShaderStorageBuffer::nextFrame() {
+  mUploadedBytes = 0;
+
+  if (!mIsRingBuffer) {
+    return;
+  }
+
+  deleteOverflowBuffers();
+
+  /* a complete frame should fit into a single section */
+  size_t newSectionSize = std::min(std::max(mRequestedSectionSize, mRingFrameBytes), MAX_RING_SECTION_SIZE);
+  mRingFrameBytes = 0;
+  mRequestedSectionSize = 0;
+
+  if (newSectionSize > mRingSectionSize) {
+    resizeRingBuffer(newSectionSize);
+    return;
+  }
+
+  /* nothing written in this frame, section can be reused */
+  if (mRingSectionOffset > 0) {
+    advanceRingSection();
+  }
+}
+
+size_t ShaderStorageBuffer::getUploadedBytes() {
+  return mUploadedBytes;
+}
+
+void ShaderStorageBuffer::advanceRingSection() {
+  if (mRingSectionFences.at(mCurrentRingSection)) {
+    glDeleteSync(mRingSectionFences.at(mCurrentRingSection));
+  }
+  mRingSectionFences.at(mCurrentRingSection) = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  mCurrentRingSection = (mCurrentRingSection + 1) % RING_BUFFER_SECTIONS;
+  mRingSectionOffset = 0;
+
+  waitForRingSection(mCurrentRingSection);
+}
+
+void ShaderStorageBuffer::waitForRingSection(int section) {
+  GLsync fence = mRingSectionFences.at(section);
+  if (!fence) {
+    return;
+  }
+
+  /* flush on the first wait only, 1ms timeout per iteration */
+  GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+  while (true) {
+    GLenum result = glClientWaitSync(fence, waitFlags, 1'000'000);
+    if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+      break;
+    }
+    if (result == GL_WAIT_FAILED) {
+      Logger::log(1, "%s error: waiting for fence of SSBO %i failed\n", __FUNCTION__, mShaderStorageBuffer);
+      break;
+    }
+    waitFlags = 0;
+  }
+
+  glDeleteSync(fence);
+  mRingSectionFences.at(section) = nullptr;
+}
+
+void ShaderStorageBuffer::resizeRingBuffer(size_t newSectionSize) {
+  Logger::log(1, "%s: resizing ring buffer SSBO %i from %i to %i bytes per section\n", __FUNCTION__,
+    mShaderStorageBuffer, mRingSectionSize, newSectionSize);
+
+  /* the driver keeps the old storage alive until all pending draws have used it */
+  cleanup();
+  initRingBuffer(newSectionSize);
+}
+
 GLuint ShaderStorageBuffer::getBufferId() {
   return mShaderStorageBuffer;
 }
 
 void ShaderStorageBuffer::checkForResize(size_t newBufferSize) {
+  if (mIsRingBuffer) {
+    mRequestedSectionSize = std::max(mRequestedSectionSize, newBufferSize);
+    return;
+  }
+
   if (newBufferSize > mBufferSize) {
     Logger::log(1, "%s: resizing SSBO %i from %i to %i bytes\n", __FUNCTION__, mShaderStorageBuffer, mBufferSize, newBufferSize);
     cleanup();
@@ -68,6 +281,22 @@ std::vector<glm::vec4> ShaderStorageBuffer::getSsboDataVec4(int numberOfElements
   return ssboData;
 }
 
+std::vector<uint32_t> ShaderStorageBuffer::getSsboDataUInt(int elementOffset, int numberOfElements) {
+  std::vector<uint32_t> ssboData;
+  getSsboDataUInt(elementOffset, numberOfElements, ssboData);
+  return ssboData;
+}
+
+void ShaderStorageBuffer::getSsboDataUInt(int elementOffset, int numberOfElements, std::vector<uint32_t>& ssboData) {
+  ssboData.resize(numberOfElements);
+  GLsizeiptr bufferSizeToRead = numberOfElements * sizeof(uint32_t);
+  GLintptr offset = elementOffset * sizeof(uint32_t);
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, bufferSizeToRead, ssboData.data());
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
 std::vector<TRSMatrixData> ShaderStorageBuffer::getSsboDataTRSMatrixData() {
   std::vector<TRSMatrixData> ssboData;
   ssboData.resize(mBufferSize / sizeof(TRSMatrixData));
@@ -80,6 +309,24 @@ std::vector<TRSMatrixData> ShaderStorageBuffer::getSsboDataTRSMatrixData() {
 }
 
 void ShaderStorageBuffer::cleanup() {
+  if (mIsRingBuffer) {
+    for (auto& fence : mRingSectionFences) {
+      if (fence) {
+        glDeleteSync(fence);
+        fence = nullptr;
+      }
+    }
+
+    if (mMappedData) {
+      glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
+      glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+      glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+      mMappedData = nullptr;
+    }
+    deleteOverflowBuffers();
+    mLastUploadSize = 0;
+  }
+
   glDeleteBuffers(1, &mShaderStorageBuffer);
 }
 
@@ -1,6 +1,7 @@
 /* OpenGL shader stroage buffer */
 #pragma once
 #include <vector>
+#include <array>
 #include <map>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
@@ -12,90 +13,97 @@
 class ShaderStorageBuffer {
   public:
     void init(size_t bufferSize);
+    /* persistent and coherent mapped ring buffer for per-frame data, every frame writes to its own section */
+    void initRingBuffer(size_t sectionSize);
 
     /* upload and bind */
     template <typename T>
-    void uploadSsboData(std::vector<T> bufferData, int bindingPoint) {
+    void uploadSsboData(const std::vector<T>& bufferData, int bindingPoint) {
       if (bufferData.empty()) {
         return;
       }
 
-      size_t bufferSize = bufferData.size() * sizeof(T);
-      if (bufferSize > mBufferSize) {
-        Logger::log(1, "%s: resizing SSBO %i from %i to %i bytes\n", __FUNCTION__, mShaderStorageBuffer, mBufferSize, bufferSize);
-        cleanup();
-        init(bufferSize);
-      }
-
-      glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
-      glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bufferSize, bufferData.data());
-      glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingPoint, mShaderStorageBuffer, 0,
-        bufferSize);
-      glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+      uploadData(bufferData.data(), bufferData.size() * sizeof(T));
+      bindLastUpload(bindingPoint);
     }
 
     template <typename T>
-    void uploadSsboData(T bufferData, int bindingPoint) {
-      size_t bufferSize =  sizeof(T);
-      if (bufferSize > mBufferSize) {
-        Logger::log(1, "%s: resizing SSBO %i from %i to %i bytes\n", __FUNCTION__, mShaderStorageBuffer, mBufferSize, bufferSize);
-        cleanup();
-        init(bufferSize);
-      }
-
-      glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
-      glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bufferSize, &bufferData);
-      glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingPoint, mShaderStorageBuffer, 0,
-        bufferSize);
-      glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    void uploadSsboData(const T& bufferData, int bindingPoint) {
+      uploadData(&bufferData, sizeof(T));
+      bindLastUpload(bindingPoint);
     }
 
     /* just upload, use bind() call to use */
     template <typename T>
-    void uploadSsboData(std::vector<T> bufferData) {
+    void uploadSsboData(const std::vector<T>& bufferData) {
       if (bufferData.empty()) {
         return;
       }
 
-      size_t bufferSize = bufferData.size() * sizeof(T);
-      if (bufferSize > mBufferSize) {
-        Logger::log(1, "%s: resizing SSBO %i from %i to %i bytes\n", __FUNCTION__, mShaderStorageBuffer, mBufferSize, bufferSize);
-        cleanup();
-        init(bufferSize);
-      }
-
-      glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
-      glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bufferSize, bufferData.data());
-      glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+      uploadData(bufferData.data(), bufferData.size() * sizeof(T));
     }
 
     template <typename T>
-    void uploadSsboData(T bufferData) {
-      size_t bufferSize = sizeof(T);
-      if (bufferSize > mBufferSize) {
-        Logger::log(1, "%s: resizing SSBO %i from %i to %i bytes\n", __FUNCTION__, mShaderStorageBuffer, mBufferSize, bufferSize);
-        cleanup();
-        init(bufferSize);
-      }
-
-      glBindBuffer(GL_SHADER_STORAGE_BUFFER, mShaderStorageBuffer);
-      glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bufferSize, bufferData);
-      glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    void uploadSsboData(const T& bufferData) {
+      uploadData(&bufferData, sizeof(T));
     }
 
     void bind(int bindingPoint);
+    /* GPU side copy, no CPU roundtrip */
+    void copyFromBuffer(ShaderStorageBuffer& sourceBuffer, size_t sourceOffset, size_t targetOffset, size_t dataSize);
     GLuint getBufferId();
     size_t getBufferSize();
 
+    /* ring buffer: fence the current section and wait until the GPU has finished reading the next one,
+     * a pending resize is done here, outside of a frame */
+    void nextFrame();
+    /* bytes uploaded since the last call of nextFrame() */
+    size_t getUploadedBytes();
+
     std::vector<glm::mat4> getSsboDataMat4();
     std::vector<glm::mat4> getSsboDataMat4(int matricesOffset, int numberOfMatrices);
     std::vector<glm::vec4> getSsboDataVec4(int numberOfElements);
+    std::vector<uint32_t> getSsboDataUInt(int elementOffset, int numberOfElements);
+    /* reuses the memory of the vector */
+    void getSsboDataUInt(int elementOffset, int numberOfElements, std::vector<uint32_t>& ssboData);
     std::vector<TRSMatrixData> getSsboDataTRSMatrixData();
 
+    /* ring buffer: the new section size is applied in the next call of nextFrame() */
     void checkForResize(size_t newBufferSize);
     void cleanup();
 
   private:
+    void uploadData(const void* data, size_t dataSize);
+    void bindLastUpload(int bindingPoint);
+
+    void advanceRingSection();
+    void waitForRingSection(int section);
+    void resizeRingBuffer(size_t newSectionSize);
+    void uploadToOverflowBuffer(const void* data, size_t dataSize);
+    void deleteOverflowBuffers();
+
     size_t mBufferSize = 0;
     GLuint mShaderStorageBuffer = 0;
+
+    GLuint mLastUploadBuffer = 0;
+    size_t mLastUploadOffset = 0;
+    size_t mLastUploadSize = 0;
+    size_t mUploadedBytes = 0;
+
+    /* ring buffer mode */
+    static constexpr int RING_BUFFER_SECTIONS = 3;
+    static constexpr size_t MAX_RING_SECTION_SIZE = 64 * 1024 * 1024;
+
+    bool mIsRingBuffer = false;
+    void* mMappedData = nullptr;
+    size_t mRingSectionSize = 0;
+    size_t mRingSectionOffset = 0;
+    int mCurrentRingSection = 0;
+    /* aligned bytes of the current frame and the section size requested by checkForResize() */
+    size_t mRingFrameBytes = 0;
+    size_t mRequestedSectionSize = 0;
+    /* uploads larger than a section, deleted in nextFrame() */
+    std::vector<GLuint> mOverflowBuffers{};
+    size_t mOffsetAlignment = 1;
+    std::array<GLsync, RING_BUFFER_SECTIONS> mRingSectionFences{};
 };
@@ -2,20 +2,90 @@
 #include <stb_image.h>
 
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
 
 #include "Texture.h"
 #include "Logger.h"
 
 bool Texture::loadTexture(std::string textureFilename, bool flipImage) {
-  mTextureName = textureFilename;
+  TextureData decodedData{};
+  if (!decodeTexture(textureFilename, decodedData, flipImage)) {
+    return false;
+  }
+  return uploadTexture(decodedData);
+}
+
+bool Texture::loadTexture(std::string textureName, aiTexel* textureData, int width, int height, bool flipImage) {
+  TextureData decodedData{};
+  if (!decodeTexture(textureName, textureData, width, height, decodedData, flipImage)) {
+    return false;
+  }
+  return uploadTexture(decodedData);
+}
+
+bool Texture::decodeTexture(std::string textureFilename, TextureData& decodedData, bool flipImage) {
+  decodedData.name = textureFilename;
 
-  stbi_set_flip_vertically_on_load(flipImage);
+  /* the flip setting must not leak into decodes running on other threads */
+  stbi_set_flip_vertically_on_load_thread(flipImage);
   /* always load as RGBA */
-  unsigned char *textureData = stbi_load(textureFilename.c_str(), &mTexWidth, &mTexHeight, &mNumberOfChannels, STBI_rgb_alpha);
+  unsigned char *textureData = stbi_load(textureFilename.c_str(), &decodedData.width, &decodedData.height,
+    &decodedData.numberOfChannels, STBI_rgb_alpha);
 
   if (!textureData) {
-    Logger::log(1, "%s error: could not load file '%s'\n", __FUNCTION__, mTextureName.c_str());
-    stbi_image_free(textureData);
+    Logger::log(1, "%s error: could not load file '%s'\n", __FUNCTION__, textureFilename.c_str());
+    return false;
+  }
+
+  decodedData.pixels.assign(textureData, textureData + decodedData.width * decodedData.height * 4);
+  stbi_image_free(textureData);
+  return true;
+}
+
+bool Texture::decodeTexture(std::string textureName, const aiTexel* textureData, int width, int height,
+    TextureData& decodedData, bool flipImage) {
+  decodedData.name = textureName;
+
+  if (!textureData) {
+    Logger::log(1, "%s error: could not load texture '%s'\n", __FUNCTION__, textureName.c_str());
+    return false;
+  }
+
+  Logger::log(1, "%s: texture file '%s' has width %i and height %i\n", __FUNCTION__, textureName.c_str(), width, height);
+
+  /* allow to flip the image, similar to file loaded from disk */
+  stbi_set_flip_vertically_on_load_thread(flipImage);
+
+  /* we use stbi to detect the in-memory format, but always request RGBA */
+  const unsigned char* memoryData = reinterpret_cast<const unsigned char*>(textureData);
+  unsigned char *data = nullptr;
+  if (height == 0)   {
+    data = stbi_load_from_memory(memoryData, width, &decodedData.width, &decodedData.height, &decodedData.numberOfChannels, STBI_rgb_alpha);
+  }
+  else   {
+    data = stbi_load_from_memory(memoryData, width * height, &decodedData.width, &decodedData.height, &decodedData.numberOfChannels, STBI_rgb_alpha);
+  }
+
+  if (!data) {
+    Logger::log(1, "%s error: could not decode texture '%s'\n", __FUNCTION__, textureName.c_str());
+    return false;
+  }
+
+  decodedData.pixels.assign(data, data + decodedData.width * decodedData.height * 4);
+  stbi_image_free(data);
+  return true;
+}
+
+bool Texture::uploadTexture(const TextureData& decodedData) {
+  mTextureName = decodedData.name;
+  mTexWidth = decodedData.width;
+  mTexHeight = decodedData.height;
+  mNumberOfChannels = decodedData.numberOfChannels;
+
+  if (decodedData.pixels.empty()) {
+    Logger::log(1, "%s error: texture '%s' has no data\n", __FUNCTION__, mTextureName.c_str());
     return false;
   }
 
@@ -27,24 +97,84 @@ bool Texture::loadTexture(std::string textureFilename, bool flipImage) {
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, mTexWidth, mTexHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, textureData);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, mTexWidth, mTexHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, decodedData.pixels.data());
 
   glGenerateMipmap(GL_TEXTURE_2D);
   glBindTexture(GL_TEXTURE_2D, 0);
 
-  stbi_image_free(textureData);
-
   Logger::log(1, "%s: texture '%s' loaded (%dx%d, %d channels)\n", __FUNCTION__, mTextureName.c_str(), mTexWidth, mTexHeight, mNumberOfChannels);
   return true;
 }
 
-bool Texture::loadTexture(std::string textureName, aiTexel* textureData, int width, int height, bool flipImage) {
-  if (!textureData) {
-    Logger::log(1, "%s error: could not load texture '%s'\n", __FUNCTION__, textureName.c_str());
-    return false;
+void Texture::createMipLevels(TextureData& decodedData, std::vector<TextureData>& mipLevels) {
+  /* the textures are sRGB, average the color channels in linear space like the driver does */
+  static const std::array<float, 256> srgbToLinear = []() {
+    std::array<float, 256> table{};
+    for (size_t i = 0; i < table.size(); ++i) {
+      float value = i / 255.0f;
+      table.at(i) = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+    return table;
+  }();
+  auto linearToSrgb = [](float value) {
+    float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(std::clamp(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+  };
+
+  mipLevels.clear();
+  mipLevels.emplace_back(std::move(decodedData));
+
+  while (mipLevels.back().width > 1 || mipLevels.back().height > 1) {
+    const TextureData& source = mipLevels.back();
+
+    TextureData level{};
+    level.name = source.name;
+    level.width = std::max(1, source.width / 2);
+    level.height = std::max(1, source.height / 2);
+    level.numberOfChannels = source.numberOfChannels;
+    level.pixels.resize(level.width * level.height * 4);
+
+    for (int y = 0; y < level.height; ++y) {
+      /* a source size of 1 reuses the single row or column */
+      int sourceRows[2] = { std::min(y * 2, source.height - 1), std::min(y * 2 + 1, source.height - 1) };
+      for (int x = 0; x < level.width; ++x) {
+        int sourceColumns[2] = { std::min(x * 2, source.width - 1), std::min(x * 2 + 1, source.width - 1) };
+
+        float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (const int row : sourceRows) {
+          for (const int column : sourceColumns) {
+            const uint8_t* texel = source.pixels.data() + (row * source.width + column) * 4;
+            color[0] += srgbToLinear.at(texel[0]);
+            color[1] += srgbToLinear.at(texel[1]);
+            color[2] += srgbToLinear.at(texel[2]);
+            color[3] += texel[3];
+          }
+        }
+
+        uint8_t* targetTexel = level.pixels.data() + (y * level.width + x) * 4;
+        targetTexel[0] = linearToSrgb(color[0] / 4.0f);
+        targetTexel[1] = linearToSrgb(color[1] / 4.0f);
+        targetTexel[2] = linearToSrgb(color[2] / 4.0f);
+        /* alpha is linear */
+        targetTexel[3] = static_cast<uint8_t>(color[3] / 4.0f + 0.5f);
+      }
+    }
+
+    mipLevels.emplace_back(std::move(level));
   }
+}
 
-  Logger::log(1, "%s: texture file '%s' has width %i and height %i\n", __FUNCTION__, textureName.c_str(), width, height);
+void Texture::initStreaming(std::string textureName, std::shared_ptr<Texture> fallbackTexture) {
+  mTextureName = textureName;
+  mFallbackTexture = fallbackTexture;
+}
+
+void Texture::allocateStreamingStorage(int width, int height, int numberOfLevels) {
+  mTexWidth = width;
+  mTexHeight = height;
+  mNumberOfChannels = 4;
+  mNumberOfLevels = numberOfLevels;
+  mLowestUploadedLevel = numberOfLevels;
 
   glGenTextures(1, &mTexture);
   glBindTexture(GL_TEXTURE_2D, mTexture);
@@ -54,33 +184,32 @@ bool Texture::loadTexture(std::string textureName, aiTexel* textureData, int wid
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-  /* allow to flip the image, similar to file loaded from disk */
-  stbi_set_flip_vertically_on_load(flipImage);
-
-  /* we use stbi to detect the in-memory format, but always request RGBA */
-  unsigned char *data = nullptr;
-  if (height == 0)   {
-    data = stbi_load_from_memory(reinterpret_cast<unsigned char*>(textureData), width, &mTexWidth, &mTexHeight, &mNumberOfChannels, STBI_rgb_alpha);
-  }
-  else   {
-    data = stbi_load_from_memory(reinterpret_cast<unsigned char*>(textureData), width * height, &mTexWidth, &mTexHeight, &mNumberOfChannels, STBI_rgb_alpha);
-  }
-
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, mTexWidth, mTexHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+  /* immutable storage, the levels are filled while the texture is already in use */
+  glTexStorage2D(GL_TEXTURE_2D, mNumberOfLevels, GL_SRGB8_ALPHA8, mTexWidth, mTexHeight);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
 
-  stbi_image_free(data);
+void Texture::uploadStreamingLevel(int level, int width, int height, size_t bufferOffset) {
+  glBindTexture(GL_TEXTURE_2D, mTexture);
+  glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+    reinterpret_cast<const void*>(bufferOffset));
 
-  glGenerateMipmap(GL_TEXTURE_2D);
+  /* sample only from the levels we have */
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
   glBindTexture(GL_TEXTURE_2D, 0);
 
-  Logger::log(1, "%s: texture '%s' loaded (%dx%d, %d channels)\n", __FUNCTION__, textureName.c_str(), mTexWidth, mTexHeight, mNumberOfChannels);
-  return true;
+  mLowestUploadedLevel = level;
+  if (level == 0) {
+    mFallbackTexture = nullptr;
+    Logger::log(1, "%s: texture '%s' streamed (%dx%d, %d levels)\n", __FUNCTION__, mTextureName.c_str(), mTexWidth,
+      mTexHeight, mNumberOfLevels);
+  }
 }
 
 bool Texture::loadCubemapTexture(std::string textureFilename, bool flipImage) {
   mTextureName = textureFilename;
 
-  stbi_set_flip_vertically_on_load(flipImage);
+  stbi_set_flip_vertically_on_load_thread(flipImage);
   /* always convert to RGBA */
   unsigned char *textureData = stbi_load(textureFilename.c_str(), &mTexWidth, &mTexHeight, &mNumberOfChannels, STBI_rgb_alpha);
 
@@ -158,9 +287,15 @@ bool Texture::loadCubemapTexture(std::string textureFilename, bool flipImage) {
 
 void Texture::cleanup() {
   glDeleteTextures(1, &mTexture);
+  mFallbackTexture = nullptr;
 }
 
 void Texture::bind() {
+  /* streamed texture without any uploaded level */
+  if (mFallbackTexture && mLowestUploadedLevel >= mNumberOfLevels) {
+    mFallbackTexture->bind();
+    return;
+  }
   glBindTexture(GL_TEXTURE_2D, mTexture);
 }
 
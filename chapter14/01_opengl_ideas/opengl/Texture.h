@@ -1,15 +1,42 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 #include <assimp/texture.h>
 
+/* decoded RGBA image, filled without a GL context */
+struct TextureData {
+  std::string name;
+  int width = 0;
+  int height = 0;
+  int numberOfChannels = 0;
+  std::vector<uint8_t> pixels{};
+};
+
 class Texture {
   public:
     bool loadTexture(std::string textureFilename, bool flipImage = true);
     bool loadTexture(std::string textureName, aiTexel* textureData, int width, int height, bool flipImage = true);
 
+    /* the decode functions are thread safe, the upload needs the GL context */
+    static bool decodeTexture(std::string textureFilename, TextureData& decodedData, bool flipImage = true);
+    static bool decodeTexture(std::string textureName, const aiTexel* textureData, int width, int height,
+      TextureData& decodedData, bool flipImage = true);
+    bool uploadTexture(const TextureData& decodedData);
+
+    /* box filtered mip chain down to 1x1, level 0 is moved into the chain, thread safe */
+    static void createMipLevels(TextureData& decodedData, std::vector<TextureData>& mipLevels);
+
+    /* streamed textures show the fallback texture until the smallest mip level is uploaded */
+    void initStreaming(std::string textureName, std::shared_ptr<Texture> fallbackTexture);
+    void allocateStreamingStorage(int width, int height, int numberOfLevels);
+    /* reads from the bound GL_PIXEL_UNPACK_BUFFER, the levels must arrive from the smallest to level 0 */
+    void uploadStreamingLevel(int level, int width, int height, size_t bufferOffset);
+
     bool loadCubemapTexture(std::string textureFilename, bool flipImage = true);
 
     void bind();
@@ -26,4 +53,9 @@ class Texture {
     int mTexHeight = 0;
     int mNumberOfChannels = 0;
     std::string mTextureName;
+
+    std::shared_ptr<Texture> mFallbackTexture = nullptr;
+    int mNumberOfLevels = 0;
+    /* sampling starts here, levels above are not uploaded yet */
+    int mLowestUploadedLevel = 0;
 };
@@ -0,0 +1,337 @@
+#include <filesystem>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdio>
+
+#include "TextureManager.h"
+#include "LevelDataCache.h"
+#include "Logger.h"
+
+std::string TextureManager::getFileKey(std::string textureFilename) {
+  return std::filesystem::path(textureFilename).lexically_normal().generic_string();
+}
+
+std::string TextureManager::getDataKey(const void* data, size_t size) {
+  char hashString[17];
+  std::snprintf(hashString, sizeof(hashString), "%016llx",
+    static_cast<unsigned long long>(LevelDataCache::hashData(data, size)));
+  /* the '*' can not start a normalized file name */
+  return std::string("*") + hashString + "_" + std::to_string(size);
+}
+
+bool TextureManager::init(unsigned int numStreamingThreads) {
+  /* a single grey texel, neutral enough for every material */
+  TextureData placeholderData{};
+  placeholderData.name = "streaming placeholder";
+  placeholderData.width = 1;
+  placeholderData.height = 1;
+  placeholderData.numberOfChannels = 4;
+  placeholderData.pixels = { 128, 128, 128, 255 };
+
+  mStreamingPlaceholder = std::make_shared<Texture>();
+  if (!mStreamingPlaceholder->uploadTexture(placeholderData)) {
+    Logger::log(1, "%s error: could not create streaming placeholder texture\n", __FUNCTION__);
+    mStreamingPlaceholder = nullptr;
+    return false;
+  }
+
+  mStreamingLoader.init(numStreamingThreads);
+  mStreamingInitialized = true;
+  return true;
+}
+
+void TextureManager::setStreamingEnabled(bool value) {
+  mStreamingEnabled = value;
+}
+
+bool TextureManager::isStreamingEnabled() {
+  return mStreamingInitialized && mStreamingEnabled;
+}
+
+bool TextureManager::hasTexture(std::string key) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mTextures.count(key) > 0;
+}
+
+std::shared_ptr<Texture> TextureManager::getTexture(std::string key) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  const auto iter = mTextures.find(key);
+  if (iter == mTextures.end()) {
+    return nullptr;
+  }
+
+  ++mCacheHits;
+  Logger::log(2, "%s: using shared texture '%s'\n", __FUNCTION__, key.c_str());
+  return iter->second.texture;
+}
+
+std::shared_ptr<Texture> TextureManager::addTexture(std::string key, const TextureData& decodedData) {
+  std::shared_ptr<Texture> newTex = std::make_shared<Texture>();
+  if (!newTex->uploadTexture(decodedData)) {
+    return nullptr;
+  }
+
+  TextureEntry entry{};
+  entry.texture = newTex;
+  entry.memorySize = decodedData.pixels.size() * 4 / 3;
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  mTextures.insert({key, entry});
+  mTextureMemorySize += entry.memorySize;
+  return newTex;
+}
+
+std::shared_ptr<Texture> TextureManager::loadTexture(std::string textureFilename) {
+  std::string key = getFileKey(textureFilename);
+  std::shared_ptr<Texture> texture = getTexture(key);
+  if (texture) {
+    return texture;
+  }
+
+  TextureData decodedData{};
+  if (!Texture::decodeTexture(textureFilename, decodedData)) {
+    return nullptr;
+  }
+  return addTexture(key, decodedData);
+}
+
+std::shared_ptr<Texture> TextureManager::streamTexture(std::string key, textureDecodeFunction decodeFunction) {
+  std::shared_ptr<Texture> newTex = std::make_shared<Texture>();
+  newTex->initStreaming(key, mStreamingPlaceholder);
+
+  std::shared_ptr<StreamedTexture> streamedTexture = std::make_shared<StreamedTexture>();
+  streamedTexture->key = key;
+  streamedTexture->texture = newTex;
+
+  {
+    /* the memory size is set once the size of the image is known */
+    TextureEntry entry{};
+    entry.texture = newTex;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTextures.insert({key, entry});
+    mStreamedTextures.emplace_back(streamedTexture);
+  }
+
+  mStreamingLoader.addJob([this, streamedTexture, decodeFunction]() {
+    TextureData decodedData{};
+    bool decoded = decodeFunction(decodedData);
+    if (decoded) {
+      Texture::createMipLevels(decodedData, streamedTexture->mipLevels);
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    streamedTexture->decodeFailed = !decoded;
+    streamedTexture->decodeFinished = true;
+    return decoded;
+  });
+
+  Logger::log(2, "%s: streaming texture '%s'\n", __FUNCTION__, key.c_str());
+  return newTex;
+}
+
+void TextureManager::uploadStreamedTextures(size_t byteBudget) {
+  std::vector<std::shared_ptr<StreamedTexture>> decodedTextures;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const auto& streamedTexture : mStreamedTextures) {
+      if (streamedTexture->decodeFinished) {
+        decodedTextures.emplace_back(streamedTexture);
+      }
+    }
+  }
+
+  if (decodedTextures.empty()) {
+    return;
+  }
+
+  /* the small levels of all textures first, then the large levels in load order */
+  std::vector<PlannedUpload> plannedUploads;
+  size_t uploadSize = 0;
+  bool budgetLeft = true;
+  for (const auto& streamedTexture : decodedTextures) {
+    budgetLeft = planStreamingLevels(streamedTexture, STREAMING_PREVIEW_SIZE, byteBudget, uploadSize, plannedUploads);
+    if (!budgetLeft) {
+      break;
+    }
+  }
+
+  if (budgetLeft) {
+    for (const auto& streamedTexture : decodedTextures) {
+      if (!planStreamingLevels(streamedTexture, std::numeric_limits<int>::max(), byteBudget, uploadSize, plannedUploads)) {
+        break;
+      }
+    }
+  }
+
+  if (!plannedUploads.empty()) {
+    if (mUploadBuffer == 0) {
+      glGenBuffers(1, &mUploadBuffer);
+    }
+    mUploadBufferSize = std::max(mUploadBufferSize, uploadSize);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mUploadBuffer);
+    /* orphan the buffer, the copies of the last frame may still read from the old storage */
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, mUploadBufferSize, nullptr, GL_STREAM_DRAW);
+    uint8_t* bufferData = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, uploadSize,
+      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+    if (!bufferData) {
+      Logger::log(1, "%s error: could not map texture upload buffer %i\n", __FUNCTION__, mUploadBuffer);
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+      /* try the same levels again in the next frame */
+      for (const auto& upload : plannedUploads) {
+        upload.streamedTexture->nextLevel = std::max(upload.streamedTexture->nextLevel, upload.level);
+      }
+      return;
+    }
+
+    for (const auto& upload : plannedUploads) {
+      const TextureData& level = upload.streamedTexture->mipLevels.at(upload.level);
+      std::memcpy(bufferData + upload.bufferOffset, level.pixels.data(), level.pixels.size());
+    }
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    /* the copies to the textures run asynchronously from the pixel buffer */
+    for (const auto& upload : plannedUploads) {
+      TextureData& level = upload.streamedTexture->mipLevels.at(upload.level);
+      upload.streamedTexture->texture->uploadStreamingLevel(upload.level, level.width, level.height,
+        upload.bufferOffset);
+      std::vector<uint8_t>().swap(level.pixels);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (auto iter = mStreamedTextures.begin(); iter != mStreamedTextures.end();) {
+    const std::shared_ptr<StreamedTexture>& streamedTexture = *iter;
+    if (streamedTexture->decodeFailed) {
+      Logger::log(1, "%s error: could not decode streamed texture '%s', keeping the placeholder\n", __FUNCTION__,
+        streamedTexture->key.c_str());
+      iter = mStreamedTextures.erase(iter);
+    } else if (streamedTexture->storageAllocated && streamedTexture->nextLevel < 0) {
+      iter = mStreamedTextures.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+bool TextureManager::planStreamingLevels(std::shared_ptr<StreamedTexture> streamedTexture, int maxLevelSize,
+    size_t byteBudget, size_t& uploadSize, std::vector<PlannedUpload>& plannedUploads) {
+  if (streamedTexture->decodeFailed) {
+    return true;
+  }
+
+  if (!streamedTexture->storageAllocated) {
+    const TextureData& baseLevel = streamedTexture->mipLevels.at(0);
+    streamedTexture->texture->allocateStreamingStorage(baseLevel.width, baseLevel.height,
+      streamedTexture->mipLevels.size());
+    streamedTexture->nextLevel = streamedTexture->mipLevels.size() - 1;
+    streamedTexture->storageAllocated = true;
+
+    size_t memorySize = 0;
+    for (const auto& level : streamedTexture->mipLevels) {
+      memorySize += level.pixels.size();
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    const auto iter = mTextures.find(streamedTexture->key);
+    if (iter != mTextures.end() && iter->second.texture == streamedTexture->texture) {
+      iter->second.memorySize = memorySize;
+      mTextureMemorySize += memorySize;
+    }
+  }
+
+  while (streamedTexture->nextLevel >= 0) {
+    const TextureData& level = streamedTexture->mipLevels.at(streamedTexture->nextLevel);
+    if (std::max(level.width, level.height) > maxLevelSize) {
+      return true;
+    }
+
+    /* at least one level per frame, a level larger than the budget must not stall the streaming */
+    if (uploadSize > 0 && uploadSize + level.pixels.size() > byteBudget) {
+      return false;
+    }
+
+    PlannedUpload upload{};
+    upload.streamedTexture = streamedTexture;
+    upload.level = streamedTexture->nextLevel;
+    upload.bufferOffset = uploadSize;
+    plannedUploads.emplace_back(upload);
+
+    uploadSize += level.pixels.size();
+    --streamedTexture->nextLevel;
+  }
+  return true;
+}
+
+size_t TextureManager::getNumberOfPendingUploads() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mStreamedTextures.size();
+}
+
+size_t TextureManager::evictUnusedTextures() {
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  size_t numberOfEvictedTextures = 0;
+  for (auto iter = mTextures.begin(); iter != mTextures.end();) {
+    /* the manager holds the only reference */
+    if (iter->second.texture.use_count() == 1) {
+      iter->second.texture->cleanup();
+      mTextureMemorySize -= iter->second.memorySize;
+      iter = mTextures.erase(iter);
+      ++numberOfEvictedTextures;
+    } else {
+      ++iter;
+    }
+  }
+
+  if (numberOfEvictedTextures > 0) {
+    Logger::log(1, "%s: evicted %i unused textures, %i textures left\n", __FUNCTION__, numberOfEvictedTextures,
+      mTextures.size());
+  }
+  return numberOfEvictedTextures;
+}
+
+size_t TextureManager::getNumberOfTextures() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mTextures.size();
+}
+
+size_t TextureManager::getTextureMemorySize() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mTextureMemorySize;
+}
+
+size_t TextureManager::getNumberOfCacheHits() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mCacheHits;
+}
+
+void TextureManager::cleanup() {
+  /* running decodes write into the streamed textures */
+  mStreamingLoader.cleanup();
+  mStreamingInitialized = false;
+
+  if (mUploadBuffer != 0) {
+    glDeleteBuffers(1, &mUploadBuffer);
+    mUploadBuffer = 0;
+    mUploadBufferSize = 0;
+  }
+
+  if (mStreamingPlaceholder) {
+    mStreamingPlaceholder->cleanup();
+    mStreamingPlaceholder = nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStreamedTextures.clear();
+  for (auto& texture : mTextures) {
+    texture.second.texture->cleanup();
+  }
+  mTextures.clear();
+  mTextureMemorySize = 0;
+}
@@ -0,0 +1,101 @@
+/* renderer-wide texture store, models with the same texture file or embedded data share one GL texture */
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Texture.h"
+#include "AssetLoader.h"
+
+/* fills the decoded level 0, runs on a streaming thread */
+using textureDecodeFunction = std::function<bool(TextureData&)>;
+
+class TextureManager {
+  public:
+    /* threads and placeholder for texture streaming, the manager loads synchronously without init() */
+    bool init(unsigned int numStreamingThreads);
+    void setStreamingEnabled(bool value);
+    /* may be called from the asset loader threads */
+    bool isStreamingEnabled();
+
+    /* normalized path for files, content hash for embedded data */
+    static std::string getFileKey(std::string textureFilename);
+    static std::string getDataKey(const void* data, size_t size);
+
+    /* may be called from the asset loader threads to skip decoding */
+    bool hasTexture(std::string key);
+
+    /* nullptr if not loaded yet, a found texture counts as cache hit */
+    std::shared_ptr<Texture> getTexture(std::string key);
+    std::shared_ptr<Texture> addTexture(std::string key, const TextureData& decodedData);
+    /* shared placeholder textures, loaded on first use */
+    std::shared_ptr<Texture> loadTexture(std::string textureFilename);
+
+    /* returns at once, the texture shows a placeholder until the decode is done and the mip levels arrive */
+    std::shared_ptr<Texture> streamTexture(std::string key, textureDecodeFunction decodeFunction);
+    /* GL thread, copies mip levels to the pixel buffer until the byte budget of the frame is used */
+    void uploadStreamedTextures(size_t byteBudget);
+    /* textures still decoding or with missing mip levels */
+    size_t getNumberOfPendingUploads();
+
+    /* deletes all textures without a reference outside the manager, returns the number of deleted textures */
+    size_t evictUnusedTextures();
+
+    size_t getNumberOfTextures();
+    /* level 0 plus the mip chain, RGBA8 */
+    size_t getTextureMemorySize();
+    size_t getNumberOfCacheHits();
+
+    void cleanup();
+
+  private:
+    struct TextureEntry {
+      std::shared_ptr<Texture> texture = nullptr;
+      size_t memorySize = 0;
+    };
+
+    struct StreamedTexture {
+      std::string key;
+      std::shared_ptr<Texture> texture = nullptr;
+      /* level 0 to 1x1, filled by the streaming thread */
+      std::vector<TextureData> mipLevels{};
+      bool decodeFinished = false;
+      bool decodeFailed = false;
+      /* GL thread only, counts down to level 0 */
+      bool storageAllocated = false;
+      int nextLevel = 0;
+    };
+
+    struct PlannedUpload {
+      std::shared_ptr<StreamedTexture> streamedTexture = nullptr;
+      int level = 0;
+      size_t bufferOffset = 0;
+    };
+
+    bool planStreamingLevels(std::shared_ptr<StreamedTexture> streamedTexture, int maxLevelSize, size_t byteBudget,
+      size_t& uploadSize, std::vector<PlannedUpload>& plannedUploads);
+
+    /* levels up to this size are uploaded first for all textures, to replace the placeholders fast */
+    static const int STREAMING_PREVIEW_SIZE = 64;
+
+    std::mutex mMutex;
+    std::unordered_map<std::string, TextureEntry> mTextures{};
+    size_t mTextureMemorySize = 0;
+    size_t mCacheHits = 0;
+
+    AssetLoader mStreamingLoader{};
+    bool mStreamingInitialized = false;
+    std::atomic<bool> mStreamingEnabled = false;
+    std::shared_ptr<Texture> mStreamingPlaceholder = nullptr;
+    /* protected by mMutex, the streaming threads set the decode results */
+    std::vector<std::shared_ptr<StreamedTexture>> mStreamedTextures{};
+
+    GLuint mUploadBuffer = 0;
+    size_t mUploadBufferSize = 0;
+};
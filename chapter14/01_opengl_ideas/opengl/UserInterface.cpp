@@ -46,6 +46,7 @@ void UserInterface::init(OGLRenderData &renderData) {
   mFrameTimeValues.resize(mNumFrameTimeValues);
   mModelUploadValues.resize(mNumModelUploadValues);
   mMatrixGenerationValues.resize(mNumMatrixGenerationValues);
+  mBoneMatrixGpuValues.resize(mNumBoneMatrixGpuValues);
   mMatrixUploadValues.resize(mNumMatrixUploadValues);
   mMatrixDownloadValues.resize(mNumMatrixDownloadValues);
   mUiGenValues.resize(mNumUiGenValues);
@@ -60,6 +61,8 @@ void UserInterface::init(OGLRenderData &renderData) {
   mIKValues.resize(mNumIKValues);
   mLevelGroundNeighborUpdateValues.resize(mNumLevelGroundNeighborUpdateValues);
   mPathFindingValues.resize(mNumPathFindingValues);
+  mInstanceUpdateValues.resize(mNumInstanceUpdateValues);
+  mCullingValues.resize(mNumCullingValues);
 
   /* Use CTRL to detach links */
   ImNodesIO& io = ImNodes::GetIO();
@@ -319,8 +322,9 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
     ImGui::EndPopup();
   }
 
-  /* show error message if load was not successful */
-  if (!loadSuccessful) {
+  /* show error message if load was not successful, the models fail later in the background */
+  if (!loadSuccessful || renderData.rdConfigLoadFailed) {
+    renderData.rdConfigLoadFailed = false;
     ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f), ImGuiCond_Always, ImVec2(0.5f,0.5f));
     ImGui::OpenPopup("Load Error!");
   }
@@ -489,6 +493,9 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
     mMatrixGenerationValues.at(mMatrixGenOffset) = renderData.rdMatrixGenerateTime;
     mMatrixGenOffset = ++mMatrixGenOffset % mNumMatrixGenerationValues;
 
+    mBoneMatrixGpuValues.at(mBoneMatrixGpuOffset) = renderData.rdBoneMatrixGpuTime;
+    mBoneMatrixGpuOffset = ++mBoneMatrixGpuOffset % mNumBoneMatrixGpuValues;
+
     mMatrixUploadValues.at(mMatrixUploadOffset) = renderData.rdUploadToUBOTime;
     mMatrixUploadOffset = ++mMatrixUploadOffset % mNumMatrixUploadValues;
 
@@ -531,6 +538,12 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
     mPathFindingValues.at(mPathFindingOffset) = renderData.rdPathFindingTime;
     mPathFindingOffset = ++mPathFindingOffset % mNumPathFindingValues;
 
+    mInstanceUpdateValues.at(mInstanceUpdateOffset) = renderData.rdInstanceUpdateTime;
+    mInstanceUpdateOffset = ++mInstanceUpdateOffset % mNumInstanceUpdateValues;
+
+    mCullingValues.at(mCullingOffset) = renderData.rdCullingTime;
+    mCullingOffset = ++mCullingOffset % mNumCullingValues;
+
     mUpdateTime += 1.0 / 30.0;
   }
 
@@ -580,6 +593,41 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
 
     ImGui::Text("Instance Matrix Size:  %8.2f %2s", memoryUsage, unit.c_str());
 
+    unit = "B";
+    float uploadSize = renderData.rdInstanceDataUploadSize;
+
+    if (uploadSize > 1024.0f * 1024.0f) {
+      uploadSize /= 1024.0f * 1024.0f;
+      unit = "MB";
+    } else  if (uploadSize > 1024.0f) {
+      uploadSize /= 1024.0f;
+      unit = "KB";
+    }
+
+    ImGui::Text("Instance Data Upload:  %8.2f %2s", uploadSize, unit.c_str());
+
+    unit = "B";
+    float textureMemory = renderData.rdTextureMemorySize;
+
+    if (textureMemory > 1024.0f * 1024.0f) {
+      textureMemory /= 1024.0f * 1024.0f;
+      unit = "MB";
+    } else  if (textureMemory > 1024.0f) {
+      textureMemory /= 1024.0f;
+      unit = "KB";
+    }
+
+    ImGui::Text("Textures:               %10li", renderData.rdNumberOfTextures);
+    ImGui::Text("Texture Memory:        %8.2f %2s", textureMemory, unit.c_str());
+    ImGui::Text("Shared Texture Hits:    %10li", renderData.rdTextureCacheHits);
+    ImGui::Text("Pending Tex Uploads:    %10li", renderData.rdNumberOfPendingTextureUploads);
+
+    std::string boneUpdates = std::to_string(renderData.rdNumberOfBoneUpdates) + "/" + std::to_string(renderData.rdNumberOfAnimatedInstances);
+    ImGui::Text("Skeleton Updates:       %10s", boneUpdates.c_str());
+
+    ImGui::Text("Allocations per Frame:  %10li", renderData.rdFrameAllocations);
+    ImGui::Text("World Update Allocs:    %10li", renderData.rdWorldUpdateAllocations);
+
     std::string windowDims = std::to_string(renderData.rdWidth) + "x" + std::to_string(renderData.rdHeight);
     ImGui::Text("Window Dimensions:      %10s", windowDims.c_str());
 
@@ -645,6 +693,25 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
       ImGui::EndTooltip();
     }
 
+    ImGui::Text("Bone Matrix GPU Time:    %10.4f ms", renderData.rdBoneMatrixGpuTime);
+
+    if (ImGui::IsItemHovered()) {
+      ImGui::BeginTooltip();
+      float averageBoneMatrixGpu = 0.0f;
+      for (const auto value : mBoneMatrixGpuValues) {
+        averageBoneMatrixGpu += value;
+      }
+      averageBoneMatrixGpu /= static_cast<float>(mNumBoneMatrixGpuValues);
+      std::string boneMatrixGpuOverlay = "now:     " + std::to_string(renderData.rdBoneMatrixGpuTime) +
+        " ms\n30s avg: " + std::to_string(averageBoneMatrixGpu) + " ms";
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Bone Matrix GPU");
+      ImGui::SameLine();
+      ImGui::PlotLines("##BoneMatrixGpuTimes", mBoneMatrixGpuValues.data(), mBoneMatrixGpuValues.size(), mBoneMatrixGpuOffset,
+        boneMatrixGpuOverlay.c_str(), 0.0f, std::numeric_limits<float>::max(), ImVec2(0, 80));
+      ImGui::EndTooltip();
+    }
+
     ImGui::Text("Matrix Upload Time:      %10.4f ms", renderData.rdUploadToUBOTime);
 
     if (ImGui::IsItemHovered()) {
@@ -886,6 +953,65 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
         pathFindingOverlay.c_str(), 0.0f, std::numeric_limits<float>::max(), ImVec2(0, 80));
       ImGui::EndTooltip();
     }
+
+    ImGui::Text("Instance Update:         %10.4f ms", renderData.rdInstanceUpdateTime);
+
+    if (ImGui::IsItemHovered()) {
+      ImGui::BeginTooltip();
+      float averageInstanceUpdate = 0.0f;
+      for (const auto value : mInstanceUpdateValues) {
+        averageInstanceUpdate += value;
+      }
+      averageInstanceUpdate /= static_cast<float>(mNumInstanceUpdateValues);
+      std::string instanceUpdateOverlay = "now:     " + std::to_string(renderData.rdInstanceUpdateTime) +
+        " ms\n30s avg: " + std::to_string(averageInstanceUpdate) + " ms";
+      ImGui::Text("Instance Update");
+      ImGui::SameLine();
+      ImGui::PlotLines("##InstanceUpdate", mInstanceUpdateValues.data(), mInstanceUpdateValues.size(), mInstanceUpdateOffset,
+        instanceUpdateOverlay.c_str(), 0.0f, std::numeric_limits<float>::max(), ImVec2(0, 80));
+      ImGui::EndTooltip();
+    }
+
+    ImGui::Text("Instance Culling:        %10.4f ms", renderData.rdCullingTime);
+
+    if (ImGui::IsItemHovered()) {
+      ImGui::BeginTooltip();
+      float averageCulling = 0.0f;
+      for (const auto value : mCullingValues) {
+        averageCulling += value;
+      }
+      averageCulling /= static_cast<float>(mNumCullingValues);
+      std::string cullingOverlay = "now:     " + std::to_string(renderData.rdCullingTime) +
+        " ms\n30s avg: " + std::to_string(averageCulling) + " ms";
+      ImGui::Text("Instance Culling");
+      ImGui::SameLine();
+      ImGui::PlotLines("##InstanceCulling", mCullingValues.data(), mCullingValues.size(), mCullingOffset,
+        cullingOverlay.c_str(), 0.0f, std::numeric_limits<float>::max(), ImVec2(0, 80));
+      ImGui::EndTooltip();
+    }
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Worker Threads:  ");
+    ImGui::SameLine();
+    ImGui::PushItemWidth(300.0f);
+    ImGui::SliderInt("##WorkerThreads", &renderData.rdNumberOfWorkerThreads, 1,
+      renderData.rdMaxNumberOfWorkerThreads, "%d", flags);
+    ImGui::PopItemWidth();
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Bone Level Order:");
+    ImGui::SameLine();
+    ImGui::Checkbox("##LevelOrderBones", &renderData.rdUseLevelOrderBoneMatrices);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Frustum Culling: ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##FrustumCulling", &renderData.rdEnableInstanceCulling);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Animation LOD:   ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##AnimationLod", &renderData.rdEnableAnimationLod);
   }
 
   if (ImGui::CollapsingHeader("Music & Sound")) {
@@ -1675,6 +1801,65 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
       std::shared_ptr<AssimpModel> currentModel = modInstCamData.micModelList[modInstCamData.micSelectedModel];
       currentModel->setAsNavigationTarget(isNavTarget);
     }
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Stream Textures: ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##EnableTextureStreaming", &renderData.rdEnableTextureStreaming);
+
+    if (!renderData.rdEnableTextureStreaming) {
+      ImGui::BeginDisabled();
+    }
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Upload KB/Frame: ");
+    ImGui::SameLine();
+    ImGui::SliderInt("##TextureStreamingBudget", &renderData.rdTextureStreamingBudget, 64, 16384, "%d", flags);
+    if (!renderData.rdEnableTextureStreaming) {
+      ImGui::EndDisabled();
+    }
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Compress Anims:  ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##CompressAnimLookups", &renderData.rdCompressAnimLookups);
+    ImGui::SameLine();
+    ImGui::Text("(for new models)");
+
+    if (!renderData.rdCompressAnimLookups) {
+      ImGui::BeginDisabled();
+    }
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Anim Max Error:  ");
+    ImGui::SameLine();
+    ImGui::SliderFloat("##AnimLookupMaxError", &renderData.rdAnimLookupMaxError, 0.0001f, 0.05f, "%.4f",
+      flags | ImGuiSliderFlags_Logarithmic);
+    if (!renderData.rdCompressAnimLookups) {
+      ImGui::EndDisabled();
+    }
+
+    if (!modelListEmtpy && !modelIsStatic) {
+      AnimLookupCompressionStats lookupStats = selectedModel->getAnimLookupStats();
+      ImGui::Text("Anim Lookups:    %.2f MB (%s)", lookupStats.compressedSize / (1024.0f * 1024.0f),
+        selectedModel->hasCompressedAnimLookups() ? "compressed" : "uncompressed");
+      if (selectedModel->hasCompressedAnimLookups()) {
+        ImGui::Text("Uncompressed:    %.2f MB", lookupStats.uncompressedSize / (1024.0f * 1024.0f));
+        ImGui::Text("Kept Keys:       %li/%li", lookupStats.numberOfKeys, lookupStats.numberOfSamples);
+        ImGui::Text("Max Errors:      T %.4f, R %.3f deg, S %.4f", lookupStats.maxTranslationError,
+          glm::degrees(lookupStats.maxRotationError), lookupStats.maxScaleError);
+      }
+    }
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Pack Vertices:   ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##PackModelVertices", &renderData.rdPackModelVertices);
+    ImGui::SameLine();
+    ImGui::Text("(for new models)");
+
+    if (!modelListEmtpy) {
+      ImGui::Text("Vertex Buffers:  %.2f MB (%s)", selectedModel->getVertexBufferSize() / (1024.0f * 1024.0f),
+        selectedModel->hasPackedVertices() ? "packed" : "unpacked");
+    }
   }
 
   if (ImGui::CollapsingHeader("Levels")) {
@@ -1816,6 +2001,25 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
       recreateLevelData = true;
     }
 
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Level Data Cache:  ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##EnableLevelDataCache", &renderData.rdEnableLevelDataCache);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("AABB Lookup Cache: ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##EnableAABBLookupCache", &renderData.rdEnableAABBLookupCache);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Nav Cluster Size:  ");
+    ImGui::SameLine();
+    ImGui::SliderFloat("##NavClusterSize", &renderData.rdNavClusterSize,
+      4.0f, 64.0f, "%.1f", flags);
+    if (ImGui::IsItemDeactivatedAfterEdit()) {
+      recreateLevelData = true;
+    }
+
     ImGui::AlignTextToFramePadding();
     ImGui::Text("Simple Gravity:    ");
     ImGui::SameLine();
@@ -1837,22 +2041,14 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
     ImGui::Checkbox("##DrawLevelWireframeMiniMap", &renderData.rdDrawLevelWireframeMiniMap);
 
     ImGui::AlignTextToFramePadding();
-    ImGui::Text("Draw Octree:       ");
-    ImGui::SameLine();
-    ImGui::Checkbox("##DrawLevelOctree", &renderData.rdDrawLevelOctree);
-
-    ImGui::AlignTextToFramePadding();
-    ImGui::Text("Octree Max Depth:  ");
+    ImGui::Text("Draw BVH Leafs:    ");
     ImGui::SameLine();
-    ImGui::SliderInt("##LevelOctreeMaxDepth", &renderData.rdLevelOctreeMaxDepth, 1, 10, "%d", flags);
-    if (ImGui::IsItemDeactivatedAfterEdit() || ImGui::IsItemActive()) {
-      recreateLevelData = true;
-    }
+    ImGui::Checkbox("##DrawLevelBVH", &renderData.rdDrawLevelBVH);
 
     ImGui::AlignTextToFramePadding();
-    ImGui::Text("Octree Threshold:  ");
+    ImGui::Text("BVH Leaf Tris:     ");
     ImGui::SameLine();
-    ImGui::SliderInt("##LevelOctreeThreshold", &renderData.rdLevelOctreeThreshold, 1, 20, "%d", flags);
+    ImGui::SliderInt("##LevelBVHMaxLeafTriangles", &renderData.rdLevelBVHMaxLeafTriangles, 1, 16, "%d", flags);
     if (ImGui::IsItemDeactivatedAfterEdit() || ImGui::IsItemActive()) {
       recreateLevelData = true;
     }
@@ -2518,6 +2714,78 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
     }
   }
 
+  if (ImGui::CollapsingHeader("Model Animation LOD")) {
+    size_t numberOfInstances = modInstCamData.micAssimpInstances.size() - 1;
+
+    ModelSettings modSettings;
+
+    if (numberOfInstances > 0 && modInstCamData.micSelectedInstance > 0) {
+      mCurrentModel = mCurrentInstance->getModel();
+      modSettings = mCurrentModel->getModelSettings();
+
+      if (mCurrentInstance != modInstCamData.micAssimpInstances.at(modInstCamData.micSelectedInstance)) {
+        mCurrentInstance = modInstCamData.micAssimpInstances.at(modInstCamData.micSelectedInstance);
+        mCurrentModel = mCurrentInstance->getModel();
+        modSettings = mCurrentModel->getModelSettings();
+      }
+    }
+
+    if (numberOfInstances > 0 && modInstCamData.micSelectedInstance > 0) {
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Use Animation LOD:   ");
+      ImGui::SameLine();
+      ImGui::Checkbox("##ModelUseAnimationLod", &modSettings.msUseAnimationLod);
+
+      if (!modSettings.msUseAnimationLod) {
+        ImGui::BeginDisabled();
+      }
+
+      /* first tier is for the near instances, always full rate and full skeleton */
+      for (size_t i = 1; i < modSettings.msAnimationLodTiers.size(); ++i) {
+        AnimationLodTier& tier = modSettings.msAnimationLodTiers.at(i);
+
+        ImGui::PushID(static_cast<int>(i));
+        ImGui::Text("Tier %i", static_cast<int>(i));
+
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Min Distance:        ");
+        ImGui::SameLine();
+        ImGui::PushItemWidth(250.0f);
+        ImGui::SliderFloat("##ModelLodDistance", &tier.altMinDistance,
+          0.0f, 500.0f, "%.1f", flags);
+        ImGui::PopItemWidth();
+
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Update every Frame:  ");
+        ImGui::SameLine();
+        ImGui::PushItemWidth(250.0f);
+        ImGui::SliderInt("##ModelLodInterval", &tier.altUpdateInterval,
+          1, 16, "%d", flags);
+        ImGui::PopItemWidth();
+
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Reduced Skeleton:    ");
+        ImGui::SameLine();
+        ImGui::Checkbox("##ModelLodReduced", &tier.altReducedSkeleton);
+        ImGui::PopID();
+      }
+
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Reduced Bone Depth:  ");
+      ImGui::SameLine();
+      ImGui::PushItemWidth(250.0f);
+      ImGui::SliderInt("##ModelReducedSkeletonDepth", &modSettings.msReducedSkeletonDepth,
+        0, 16, "%d", flags);
+      ImGui::PopItemWidth();
+
+      if (!modSettings.msUseAnimationLod) {
+        ImGui::EndDisabled();
+      }
+
+      mCurrentModel->setModelSettings(modSettings);
+    }
+  }
+
   if (ImGui::CollapsingHeader("Model Bounding Sphere Adjustment")) {
     size_t numberOfInstances = modInstCamData.micAssimpInstances.size() - 1;
 
@@ -2624,6 +2892,11 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
         modInstCamData.micIkIterationsCallbackFunction(renderData.rdNumberOfIkIteratons);
       }
 
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Solve on GPU:   ");
+      ImGui::SameLine();
+      ImGui::Checkbox("##FeetIKGPU", &renderData.rdEnableGpuFeetIK);
+
       modSettings = mCurrentModel->getModelSettings();
 
       /* read out values to use shorter lines */
@@ -3107,9 +3380,9 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
     }
 
     ImGui::AlignTextToFramePadding();
-    ImGui::Text("Ground Tri:      %10i", settings.isCurrentGroundTriangleIndex);
+    ImGui::Text("Ground Tri:      %10i", mCurrentInstance->getCurrentGroundTriangleIndex());
     ImGui::AlignTextToFramePadding();
-    ImGui::Text("Neighbor Tris:   %10li", settings.isNeighborGroundTriangles.size());
+    ImGui::Text("Neighbor Tris:   %10li", mCurrentInstance->getNeighborGroundTriangleIndices().size());
 
     std::vector<int> navTargets = modInstCamData.micGetNavTargetsCallbackFunction();
     size_t numNavTargets = navTargets.size();
@@ -3331,6 +3604,35 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
       ImGui::EndTooltip();
     }
 
+    ImGui::Text("Rebucketed Instances:  %4i", renderData.rdNumberOfRebucketedInstances);
+    ImGui::Text("Endpoint Swaps:        %4i", renderData.rdNumberOfEndpointSwaps);
+    ImGui::Text("Instance Pair Tests:   %4i", renderData.rdNumberOfInstancePairTests);
+    ImGui::Text("GPU Sphere Pair Tests: %4i", renderData.rdNumberOfSpherePairTests);
+    ImGui::Text("Contacts Begin/End:    %4i/%4i", renderData.rdNumberOfContactBegins, renderData.rdNumberOfContactEnds);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Broadphase:             ");
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Grid##Broadphase",
+      renderData.rdCollisionBroadphase == collisionBroadphase::grid)) {
+      renderData.rdCollisionBroadphase = collisionBroadphase::grid;
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Sweep and Prune##Broadphase",
+      renderData.rdCollisionBroadphase == collisionBroadphase::sweepAndPrune)) {
+      renderData.rdCollisionBroadphase = collisionBroadphase::sweepAndPrune;
+    }
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Grid Cell Size:         ");
+    ImGui::SameLine();
+    ImGui::SliderFloat("##InstanceGridCellSize", &renderData.rdInstanceGridCellSize, 1.0f, 32.0f, "%.1f", flags);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Events on Contact only: ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##CollisionEventsOnContactChange", &renderData.rdCollisionEventsOnContactChange);
+
     ImGui::AlignTextToFramePadding();
     ImGui::Text("Collisions:             ");
     ImGui::SameLine();
@@ -3481,6 +3783,44 @@ void UserInterface::createSettingsWindow(OGLRenderData& renderData, ModelInstanc
     ImGui::Text("Enable Navigation:     ");
     ImGui::SameLine();
     ImGui::Checkbox("##EnableNavGlobal", &renderData.rdEnableNavigation);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Hierarchical Search:   ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##HierarchicalPathFinding", &renderData.rdUseHierarchicalPathFinding);
+
+    ImGui::Text("Path Queries:          %4li", renderData.rdNumberOfPathQueries);
+    ImGui::Text("Nodes Expanded:        %4li", renderData.rdPathNodesExpanded);
+    ImGui::Text("Nodes per Query:       %.1f", renderData.rdPathNodesPerQuery);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Use Flow Fields:       ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##UseFlowFields", &renderData.rdUseFlowFields);
+
+    ImGui::Text("Flow Fields:           %4li", renderData.rdNumberOfFlowFields);
+    ImGui::Text("Flow Field Rebuilds:   %4li", renderData.rdNumberOfFlowFieldRebuilds);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Async Path Finding:    ");
+    ImGui::SameLine();
+    ImGui::Checkbox("##AsyncPathFinding", &renderData.rdEnableAsyncPathFinding);
+
+    if (!renderData.rdEnableAsyncPathFinding) {
+      ImGui::BeginDisabled();
+    }
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Path Result Budget:    ");
+    ImGui::SameLine();
+    ImGui::SliderFloat("##PathResultBudget", &renderData.rdPathResultBudget, 0.05f, 2.0f, "%.2f ms", flags);
+
+    ImGui::Text("Pending Path Requests: %4li", renderData.rdNumberOfPendingPathRequests);
+    ImGui::Text("Applied Path Results:  %4li", renderData.rdNumberOfAppliedPathResults);
+
+    if (!renderData.rdEnableAsyncPathFinding) {
+      ImGui::EndDisabled();
+    }
   }
 
   ImGui::End();
@@ -3692,6 +4032,30 @@ void UserInterface::createStatusBar(OGLRenderData& renderData, ModelInstanceCamD
   ImGui::End();
 }
 
+void UserInterface::createAssetLoadingWindow(OGLRenderData& renderData) {
+  if (!renderData.rdAssetLoadingActive) {
+    return;
+  }
+
+  ImGuiIO& io = ImGui::GetIO();
+  ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f), ImGuiCond_Always, ImVec2(0.5f,0.5f));
+
+  /* modal, no other changes until the config is loaded */
+  ImGui::OpenPopup("Loading Configuration");
+  if (ImGui::BeginPopupModal("Loading Configuration", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove)) {
+    float progress = 0.0f;
+    if (renderData.rdNumberOfAssetLoadJobs > 0) {
+      progress = static_cast<float>(renderData.rdNumberOfFinishedAssetLoadJobs) / renderData.rdNumberOfAssetLoadJobs;
+    }
+
+    ImGui::Text("Loading models and textures...");
+    std::string overlay = std::to_string(renderData.rdNumberOfFinishedAssetLoadJobs) + " / " +
+      std::to_string(renderData.rdNumberOfAssetLoadJobs) + " jobs";
+    ImGui::ProgressBar(progress, ImVec2(300.0f, 0.0f), overlay.c_str());
+    ImGui::EndPopup();
+  }
+}
+
 void UserInterface::render() {
   ImGui::Render();
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -24,6 +24,8 @@ class UserInterface {
     void createSettingsWindow(OGLRenderData &renderData, ModelInstanceCamData &modInstCamData);
     void createStatusBar(OGLRenderData &renderData, ModelInstanceCamData &modInstCamData);
     void createPositionsWindow(OGLRenderData &renderData, ModelInstanceCamData &modInstCamData);
+    /* progress of the background config loading */
+    void createAssetLoadingWindow(OGLRenderData &renderData);
     void resetPositionWindowOctreeView();
 
     void render();
@@ -46,6 +48,9 @@ class UserInterface {
     std::vector<float> mMatrixGenerationValues{};
     int mNumMatrixGenerationValues = 90;
 
+    std::vector<float> mBoneMatrixGpuValues{};
+    int mNumBoneMatrixGpuValues = 90;
+
     std::vector<float> mMatrixUploadValues{};
     int mNumMatrixUploadValues = 90;
 
@@ -88,6 +93,12 @@ class UserInterface {
     std::vector<float> mPathFindingValues{};
     int mNumPathFindingValues = 90;
 
+    std::vector<float> mInstanceUpdateValues{};
+    int mNumInstanceUpdateValues = 90;
+
+    std::vector<float> mCullingValues{};
+    int mNumCullingValues = 90;
+
     float mNewFps = 0.0f;
     double mUpdateTime = 0.0;
 
@@ -95,6 +106,7 @@ class UserInterface {
     int mFrameTimeOffset = 0;
     int mModelUploadOffset = 0;
     int mMatrixGenOffset = 0;
+    int mBoneMatrixGpuOffset = 0;
     int mMatrixUploadOffset = 0;
     int mMatrixDownloadOffset = 0;
     int mUiGenOffset = 0;
@@ -109,6 +121,8 @@ class UserInterface {
     int mIkOffset = 0;
     int mLevelGroundNeighborOffset = 0;
     int mPathFindingOffset= 0;
+    int mInstanceUpdateOffset = 0;
+    int mCullingOffset = 0;
 
     int mManyInstanceCreateNum = 1;
     int mManyInstanceCloneNum = 1;
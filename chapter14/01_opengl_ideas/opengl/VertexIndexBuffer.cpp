@@ -1,7 +1,9 @@
 #include "VertexIndexBuffer.h"
 #include "Logger.h"
 
-void VertexIndexBuffer::init() {
+void VertexIndexBuffer::init(bool packedVertices) {
+  mPackedVertices = packedVertices;
+
   glGenVertexArrays(1, &mVAO);
   glGenBuffers(1, &mVertexVBO);
   glGenBuffers(1, &mIndexVBO);
@@ -10,11 +12,23 @@ void VertexIndexBuffer::init() {
 
   glBindBuffer(GL_ARRAY_BUFFER, mVertexVBO);
 
-  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(OGLVertex), (void*) offsetof(OGLVertex, position));
-  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(OGLVertex), (void*) offsetof(OGLVertex, color));
-  glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(OGLVertex), (void*) offsetof(OGLVertex, normal));
-  glVertexAttribIPointer(3, 4, GL_UNSIGNED_INT,   sizeof(OGLVertex), (void*) offsetof(OGLVertex, boneNumber));
-  glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(OGLVertex), (void*) offsetof(OGLVertex, boneWeight));
+  if (mPackedVertices) {
+    /* same locations as the unpacked vertex, the texture coordinates have their own attribute */
+    glVertexAttribPointer(0, 4, GL_HALF_FLOAT, GL_FALSE, sizeof(OGLPackedVertex), (void*) offsetof(OGLPackedVertex, position));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(OGLPackedVertex), (void*) offsetof(OGLPackedVertex, color));
+    glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, sizeof(OGLPackedVertex), (void*) offsetof(OGLPackedVertex, normal));
+    glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, sizeof(OGLPackedVertex), (void*) offsetof(OGLPackedVertex, boneNumber));
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(OGLPackedVertex), (void*) offsetof(OGLPackedVertex, boneWeight));
+    glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, sizeof(OGLPackedVertex), (void*) offsetof(OGLPackedVertex, uv));
+
+    glEnableVertexAttribArray(5);
+  } else {
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(OGLVertex), (void*) offsetof(OGLVertex, position));
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(OGLVertex), (void*) offsetof(OGLVertex, color));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(OGLVertex), (void*) offsetof(OGLVertex, normal));
+    glVertexAttribIPointer(3, 4, GL_UNSIGNED_INT,   sizeof(OGLVertex), (void*) offsetof(OGLVertex, boneNumber));
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(OGLVertex), (void*) offsetof(OGLVertex, boneWeight));
+  }
 
   glEnableVertexAttribArray(0);
   glEnableVertexAttribArray(1);
@@ -28,7 +42,7 @@ void VertexIndexBuffer::init() {
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindVertexArray(0);
 
-  Logger::log(1, "%s: VAO and VBOs initialized\n", __FUNCTION__);
+  Logger::log(1, "%s: VAO and VBOs initialized (%s vertices)\n", __FUNCTION__, mPackedVertices ? "packed" : "unpacked");
 }
 
 void VertexIndexBuffer::cleanup() {
@@ -42,11 +56,36 @@ void VertexIndexBuffer::uploadData(std::vector<OGLVertex> vertexData, std::vecto
     Logger::log(1, "%s error: invalid data to upload (vertices: %i, indices: %i)\n", __FUNCTION__, vertexData.size(), indices.size());
     return;
   }
+  if (mPackedVertices) {
+    Logger::log(1, "%s error: buffer was initialized for packed vertices\n", __FUNCTION__);
+    return;
+  }
 
   glBindBuffer(GL_ARRAY_BUFFER, mVertexVBO);
   glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(OGLVertex), &vertexData.at(0), GL_DYNAMIC_DRAW);
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+  uploadIndexData(indices);
+}
+
+void VertexIndexBuffer::uploadData(std::vector<OGLPackedVertex> vertexData, std::vector<uint32_t> indices) {
+  if (vertexData.empty() || indices.empty()) {
+    Logger::log(1, "%s error: invalid data to upload (vertices: %i, indices: %i)\n", __FUNCTION__, vertexData.size(), indices.size());
+    return;
+  }
+  if (!mPackedVertices) {
+    Logger::log(1, "%s error: buffer was initialized for unpacked vertices\n", __FUNCTION__);
+    return;
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, mVertexVBO);
+  glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(OGLPackedVertex), &vertexData.at(0), GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  uploadIndexData(indices);
+}
+
+void VertexIndexBuffer::uploadIndexData(const std::vector<uint32_t>& indices) {
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexVBO);
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), &indices.at(0), GL_DYNAMIC_DRAW);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -89,3 +128,13 @@ void VertexIndexBuffer::bindAndDrawIndirectInstanced(GLuint mode, unsigned int n
   drawIndirectInstanced(mode, num, instanceCount);
   unbind();
 }
+
+void VertexIndexBuffer::drawIndirectCommand(GLuint mode, size_t commandOffset) {
+  glDrawElementsIndirect(mode, GL_UNSIGNED_INT, reinterpret_cast<const void*>(commandOffset));
+}
+
+void VertexIndexBuffer::bindAndDrawIndirectCommand(GLuint mode, size_t commandOffset) {
+  bind();
+  drawIndirectCommand(mode, commandOffset);
+  unbind();
+}
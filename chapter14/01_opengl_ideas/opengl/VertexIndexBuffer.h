@@ -10,8 +10,10 @@
 
 class VertexIndexBuffer {
   public:
-    void init();
+    /* the attribute layout is fixed in the VAO, upload only the matching vertex type */
+    void init(bool packedVertices = false);
     void uploadData(std::vector<OGLVertex> vertexData, std::vector<uint32_t> indices);
+    void uploadData(std::vector<OGLPackedVertex> vertexData, std::vector<uint32_t> indices);
 
     void bind();
     void unbind();
@@ -24,10 +26,17 @@ class VertexIndexBuffer {
     void bindAndDrawIndirect(GLuint mode, unsigned int num);
     void bindAndDrawIndirectInstanced(GLuint mode, unsigned int num, int instanceCount);
 
+    /* real indirect draw, command offset in bytes inside the bound GL_DRAW_INDIRECT_BUFFER */
+    void drawIndirectCommand(GLuint mode, size_t commandOffset);
+    void bindAndDrawIndirectCommand(GLuint mode, size_t commandOffset);
+
     void cleanup();
 
   private:
     GLuint mVAO = 0;
     GLuint mVertexVBO = 0;
     GLuint mIndexVBO = 0;
+    bool mPackedVertices = false;
+
+    void uploadIndexData(const std::vector<uint32_t>& indices);
 };
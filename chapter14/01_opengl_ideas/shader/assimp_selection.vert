@@ -26,14 +26,20 @@ layout (std430, binding = 2) readonly restrict buffer InstanceSelected {
   vec2 selected[];
 };
 
+/* compacted by the culling shader, gl_InstanceID counts only the visible instances */
+layout (std430, binding = 6) readonly restrict buffer VisibleInstances {
+  uint visibleInstance[];
+};
+
 void main() {
+  int instance = int(visibleInstance[gl_InstanceID]);
 
-  mat4 modelMat = worldPosMat[gl_InstanceID];
+  mat4 modelMat = worldPosMat[instance];
   gl_Position = projection * view * modelMat * vec4(aPos.x, aPos.y, aPos.z, 1.0);
 
-  color = aColor * selected[gl_InstanceID].x;
+  color = aColor * selected[instance].x;
   /* draw the instance always on top when highlighted, helps to find it better */
-  if (selected[gl_InstanceID].x != 1.0f) {
+  if (selected[instance].x != 1.0f) {
     gl_Position.z -= 1.0f;
   }
 
@@ -41,5 +47,5 @@ void main() {
   texCoord = vec2(aPos.w, aNormal.w);
 
   /* we need screen width (y -> x) and vertex id only (z -> y) */
-  selectInfo = selected[gl_InstanceID].y;
+  selectInfo = selected[instance].y;
 }
@@ -0,0 +1,61 @@
+#version 460 core
+layout (location = 0) in vec4 aPos; // half floats, w is unused
+layout (location = 1) in vec4 aColor; // unorm8
+layout (location = 2) in vec2 aNormal; // octahedral, snorm16
+layout (location = 3) in uvec4 aBoneNum; // ignored
+layout (location = 4) in vec4 aBoneWeight; // ignored
+layout (location = 5) in vec2 aTexCoord;
+
+layout (location = 0) out vec4 color;
+layout (location = 1) out vec4 normal;
+layout (location = 2) out vec2 texCoord;
+layout (location = 3) out float selectInfo;
+
+layout (std140, binding = 0) uniform Matrices {
+  mat4 view;
+  mat4 projection;
+  vec4 lightPos;
+  vec4 lightColor;
+  float fogDensity;
+};
+
+layout (std430, binding = 1) readonly restrict buffer WorldPosMatrices {
+  mat4 worldPosMat[];
+};
+
+layout (std430, binding = 2) readonly restrict buffer InstanceSelected {
+  vec2 selected[];
+};
+
+/* compacted by the culling shader, gl_InstanceID counts only the visible instances */
+layout (std430, binding = 6) readonly restrict buffer VisibleInstances {
+  uint visibleInstance[];
+};
+
+/* octahedral normal, the lower half is folded over the diagonals */
+vec3 decodeNormal(vec2 encoded) {
+  vec3 decoded = vec3(encoded.x, encoded.y, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float fold = max(-decoded.z, 0.0);
+  decoded.x += decoded.x >= 0.0 ? -fold : fold;
+  decoded.y += decoded.y >= 0.0 ? -fold : fold;
+  return normalize(decoded);
+}
+
+void main() {
+  int instance = int(visibleInstance[gl_InstanceID]);
+
+  mat4 modelMat = worldPosMat[instance];
+  gl_Position = projection * view * modelMat * vec4(aPos.x, aPos.y, aPos.z, 1.0);
+
+  color = aColor * selected[instance].x;
+  /* draw the instance always on top when highlighted, helps to find it better */
+  if (selected[instance].x != 1.0f) {
+    gl_Position.z -= 1.0f;
+  }
+
+  normal = transpose(inverse(modelMat)) * vec4(decodeNormal(aNormal), 1.0);
+  texCoord = aTexCoord;
+
+  /* we need screen width (y -> x) and vertex id only (z -> y) */
+  selectInfo = selected[instance].y;
+}
@@ -29,11 +29,17 @@ layout (std430, binding = 3) readonly restrict buffer InstanceSelected {
   vec2 selected[];
 };
 
+/* compacted by the culling shader, gl_InstanceID counts only the visible instances */
+layout (std430, binding = 6) readonly restrict buffer VisibleInstances {
+  uint visibleInstance[];
+};
+
 uniform int aModelStride;
 
 void main() {
+  int instance = int(visibleInstance[gl_InstanceID]);
 
-  int modelStride = gl_InstanceID * aModelStride;
+  int modelStride = instance * aModelStride;
 
   mat4 skinMat =
     aBoneWeight.x * boneMat[aBoneNum.x + modelStride] +
@@ -41,13 +47,13 @@ void main() {
     aBoneWeight.z * boneMat[aBoneNum.z + modelStride] +
     aBoneWeight.w * boneMat[aBoneNum.w + modelStride];
 
-  mat4 worldPosSkinMat = worldPos[gl_InstanceID] * skinMat;
+  mat4 worldPosSkinMat = worldPos[instance] * skinMat;
 
   gl_Position = projection * view * worldPosSkinMat * vec4(aPos.x, aPos.y, aPos.z, 1.0);
 
-  color = aColor * selected[gl_InstanceID].x;
+  color = aColor * selected[instance].x;
   /* draw the instance always on top when highlighted, helps to find it better */
-  if (selected[gl_InstanceID].x != 1.0f) {
+  if (selected[instance].x != 1.0f) {
     gl_Position.z -= 1.0f;
   }
 
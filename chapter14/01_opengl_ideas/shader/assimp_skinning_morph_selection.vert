@@ -44,11 +44,17 @@ layout (std430, binding = 5) readonly restrict buffer AnimMorphData {
 };
 
 
+/* compacted by the culling shader, gl_InstanceID counts only the visible instances */
+layout (std430, binding = 6) readonly restrict buffer VisibleInstances {
+  uint visibleInstance[];
+};
+
 uniform int aModelStride;
 
 void main() {
+  int instance = int(visibleInstance[gl_InstanceID]);
 
-  int modelStride = gl_InstanceID * aModelStride;
+  int modelStride = instance * aModelStride;
 
   mat4 skinMat =
     aBoneWeight.x * boneMat[aBoneNum.x + modelStride] +
@@ -56,30 +62,30 @@ void main() {
     aBoneWeight.z * boneMat[aBoneNum.z + modelStride] +
     aBoneWeight.w * boneMat[aBoneNum.w + modelStride];
 
-  mat4 worldPosSkinMat = worldPos[gl_InstanceID] * skinMat;
+  mat4 worldPosSkinMat = worldPos[instance] * skinMat;
 
   /* y and z data contain the offset into the morph anim buffer */
-  int morphAnimIndex = int(vertsPerMorphAnim[gl_InstanceID].y * vertsPerMorphAnim[gl_InstanceID].z);
+  int morphAnimIndex = int(vertsPerMorphAnim[instance].y * vertsPerMorphAnim[instance].z);
 
   vec4 origVertex = vec4(aPos.x, aPos.y, aPos.z, 1.0);
   vec4 morphVertex = vec4(morphVertices[gl_VertexID + morphAnimIndex].position.xyz, 1.0);
 
-  gl_Position = projection * view * worldPosSkinMat * mix(origVertex, morphVertex, vertsPerMorphAnim[gl_InstanceID].x);
+  gl_Position = projection * view * worldPosSkinMat * mix(origVertex, morphVertex, vertsPerMorphAnim[instance].x);
 
-  color = aColor * selected[gl_InstanceID].x;
+  color = aColor * selected[instance].x;
   /* draw the instance always on top when highlighted, helps to find it better */
-  if (selected[gl_InstanceID].x != 1.0f) {
+  if (selected[instance].x != 1.0f) {
     gl_Position.z -= 1.0f;
   }
 
   vec4 origNormal = vec4(aNormal.x, aNormal.y, aNormal.z, 1.0);
   vec4 morphNormal = vec4(morphVertices[gl_VertexID + morphAnimIndex].normal.xyz, 1.0);
-  normal = transpose(inverse(worldPosSkinMat)) * mix(origNormal, morphNormal, vertsPerMorphAnim[gl_InstanceID].x);
+  normal = transpose(inverse(worldPosSkinMat)) * mix(origNormal, morphNormal, vertsPerMorphAnim[instance].x);
 
   texCoord = vec2(aPos.w, aNormal.w);
 
   /* we need vertex id only (z -> y) */
-  selectInfo = selected[gl_InstanceID].y;
+  selectInfo = selected[instance].y;
 }
 
 
@@ -0,0 +1,101 @@
+#version 460 core
+layout (location = 0) in vec4 aPos; // half floats, w is unused
+layout (location = 1) in vec4 aColor; // unorm8
+layout (location = 2) in vec2 aNormal; // octahedral, snorm16
+layout (location = 3) in uvec4 aBoneNum; // bytes
+layout (location = 4) in vec4 aBoneWeight; // unorm8
+layout (location = 5) in vec2 aTexCoord;
+
+layout (location = 0) out vec4 color;
+layout (location = 1) out vec4 normal;
+layout (location = 2) out vec2 texCoord;
+layout (location = 3) out float selectInfo;
+
+layout (std140, binding = 0) uniform Matrices {
+  mat4 view;
+  mat4 projection;
+  vec4 lightPos;
+  vec4 lightColor;
+  float fogDensity;
+};
+
+struct MorphVertex {
+  vec4 position;
+  vec4 normal;
+};
+
+layout (std430, binding = 1) readonly restrict buffer BoneMatrices {
+  mat4 boneMat[];
+};
+
+layout (std430, binding = 2) readonly restrict buffer WorldPosMatrices {
+  mat4 worldPos[];
+};
+
+layout (std430, binding = 3) readonly restrict buffer InstanceSelected {
+  vec2 selected[];
+};
+
+layout (std430, binding = 4) readonly restrict buffer AnimMorphBuffer {
+  MorphVertex morphVertices[];
+};
+
+layout (std430, binding = 5) readonly restrict buffer AnimMorphData {
+  vec4 vertsPerMorphAnim[];
+};
+
+
+/* compacted by the culling shader, gl_InstanceID counts only the visible instances */
+layout (std430, binding = 6) readonly restrict buffer VisibleInstances {
+  uint visibleInstance[];
+};
+
+uniform int aModelStride;
+
+/* octahedral normal, the lower half is folded over the diagonals */
+vec3 decodeNormal(vec2 encoded) {
+  vec3 decoded = vec3(encoded.x, encoded.y, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float fold = max(-decoded.z, 0.0);
+  decoded.x += decoded.x >= 0.0 ? -fold : fold;
+  decoded.y += decoded.y >= 0.0 ? -fold : fold;
+  return normalize(decoded);
+}
+
+void main() {
+  int instance = int(visibleInstance[gl_InstanceID]);
+
+  int modelStride = instance * aModelStride;
+
+  mat4 skinMat =
+    aBoneWeight.x * boneMat[aBoneNum.x + modelStride] +
+    aBoneWeight.y * boneMat[aBoneNum.y + modelStride] +
+    aBoneWeight.z * boneMat[aBoneNum.z + modelStride] +
+    aBoneWeight.w * boneMat[aBoneNum.w + modelStride];
+
+  mat4 worldPosSkinMat = worldPos[instance] * skinMat;
+
+  /* y and z data contain the offset into the morph anim buffer */
+  int morphAnimIndex = int(vertsPerMorphAnim[instance].y * vertsPerMorphAnim[instance].z);
+
+  vec4 origVertex = vec4(aPos.x, aPos.y, aPos.z, 1.0);
+  vec4 morphVertex = vec4(morphVertices[gl_VertexID + morphAnimIndex].position.xyz, 1.0);
+
+  gl_Position = projection * view * worldPosSkinMat * mix(origVertex, morphVertex, vertsPerMorphAnim[instance].x);
+
+  color = aColor * selected[instance].x;
+  /* draw the instance always on top when highlighted, helps to find it better */
+  if (selected[instance].x != 1.0f) {
+    gl_Position.z -= 1.0f;
+  }
+
+  vec4 origNormal = vec4(decodeNormal(aNormal), 1.0);
+  vec4 morphNormal = vec4(morphVertices[gl_VertexID + morphAnimIndex].normal.xyz, 1.0);
+  normal = transpose(inverse(worldPosSkinMat)) * mix(origNormal, morphNormal, vertsPerMorphAnim[instance].x);
+
+  texCoord = aTexCoord;
+
+  /* we need vertex id only (z -> y) */
+  selectInfo = selected[instance].y;
+}
+
+
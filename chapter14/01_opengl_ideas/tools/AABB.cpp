@@ -29,11 +29,11 @@ void AABB::addPoint(glm::vec3 point) {
   mMaxPos.z = std::max(mMaxPos.z, point.z);
 }
 
-glm::vec3 AABB::getMinPos() {
+glm::vec3 AABB::getMinPos() const {
   return mMinPos;
 }
 
-glm::vec3 AABB::getMaxPos() {
+glm::vec3 AABB::getMaxPos() const {
   return mMaxPos;
 }
 
@@ -14,8 +14,8 @@ class AABB {
     void create(glm::vec3 point);
     void addPoint(glm::vec3 point);
 
-    glm::vec3 getMinPos();
-    glm::vec3 getMaxPos();
+    glm::vec3 getMinPos() const;
+    glm::vec3 getMaxPos() const;
     std::pair<glm::vec3, glm::vec3> getExtents();
 
     void setMinPos(glm::vec3 pos);
@@ -0,0 +1,136 @@
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+#include "AABBLookupCache.h"
+#include "MappedFile.h"
+#include "Logger.h"
+
+namespace {
+  struct CacheFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t numberOfClips;
+    uint32_t lookupSize;
+  };
+
+  const char CACHE_MAGIC[4] = { 'A', 'B', 'L', 'C' };
+}
+
+std::string AABBLookupCache::getCacheFileName(std::string modelFileName) {
+  return modelFileName + ".aabbcache";
+}
+
+bool AABBLookupCache::load(std::string fileName, uint64_t key, size_t numberOfClips, size_t lookupSize,
+    std::vector<std::vector<AABB>>& aabbLookups) {
+  MappedFile file{};
+  if (!file.open(fileName)) {
+    return false;
+  }
+
+  const char* fileData = file.getData();
+  size_t fileSize = file.getSize();
+
+  if (fileSize < sizeof(CacheFileHeader)) {
+    Logger::log(1, "%s error: cache file '%s' is too small\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  CacheFileHeader header{};
+  std::memcpy(&header, fileData, sizeof(header));
+  if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION) {
+    Logger::log(1, "%s: cache file '%s' has an old format, ignoring it\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  if (header.key != key || header.numberOfClips != numberOfClips || header.lookupSize != lookupSize) {
+    Logger::log(1, "%s: cache file '%s' was built for another model, ignoring it\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  /* min and max position for every clip and lookup */
+  size_t numberOfPositions = numberOfClips * lookupSize * 2;
+  if (fileSize != sizeof(CacheFileHeader) + numberOfPositions * sizeof(glm::vec3)) {
+    Logger::log(1, "%s error: cache file '%s' is damaged\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  std::vector<glm::vec3> positions(numberOfPositions);
+  std::memcpy(positions.data(), fileData + sizeof(CacheFileHeader), numberOfPositions * sizeof(glm::vec3));
+
+  aabbLookups.clear();
+  aabbLookups.resize(numberOfClips);
+  for (size_t i = 0; i < numberOfClips; ++i) {
+    aabbLookups.at(i).resize(lookupSize);
+    for (size_t j = 0; j < lookupSize; ++j) {
+      size_t index = (i * lookupSize + j) * 2;
+      aabbLookups.at(i).at(j).setExtents(positions.at(index), positions.at(index + 1));
+    }
+  }
+
+  Logger::log(1, "%s: loaded AABB lookups for %i clips from cache file '%s'\n", __FUNCTION__, numberOfClips,
+    fileName.c_str());
+  return true;
+}
+
+bool AABBLookupCache::save(std::string fileName, uint64_t key, const std::vector<std::vector<AABB>>& aabbLookups) {
+  if (aabbLookups.empty()) {
+    return false;
+  }
+
+  size_t numberOfClips = aabbLookups.size();
+  size_t lookupSize = aabbLookups.at(0).size();
+
+  std::vector<glm::vec3> positions;
+  positions.reserve(numberOfClips * lookupSize * 2);
+  for (const auto& clipLookups : aabbLookups) {
+    if (clipLookups.size() != lookupSize) {
+      Logger::log(1, "%s error: clips have different lookup sizes, not saving '%s'\n", __FUNCTION__, fileName.c_str());
+      return false;
+    }
+
+    for (const auto& aabb : clipLookups) {
+      positions.emplace_back(aabb.getMinPos());
+      positions.emplace_back(aabb.getMaxPos());
+    }
+  }
+
+  /* write to a temporary file first, a crash must not leave a half written cache */
+  std::error_code errorCode{};
+  std::string tempFileName = fileName + ".tmp";
+  {
+    std::ofstream outFile(tempFileName, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+      Logger::log(1, "%s error: could not open cache file '%s' for writing\n", __FUNCTION__, tempFileName.c_str());
+      return false;
+    }
+
+    CacheFileHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.numberOfClips = numberOfClips;
+    header.lookupSize = lookupSize;
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outFile.write(reinterpret_cast<const char*>(positions.data()), positions.size() * sizeof(glm::vec3));
+
+    if (!outFile.good()) {
+      Logger::log(1, "%s error: could not write cache file '%s'\n", __FUNCTION__, tempFileName.c_str());
+      outFile.close();
+      std::filesystem::remove(tempFileName, errorCode);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tempFileName, fileName, errorCode);
+  if (errorCode) {
+    Logger::log(1, "%s error: could not rename cache file '%s' (%s)\n", __FUNCTION__, tempFileName.c_str(),
+      errorCode.message().c_str());
+    std::filesystem::remove(tempFileName, errorCode);
+    return false;
+  }
+
+  Logger::log(1, "%s: saved AABB lookup cache file '%s'\n", __FUNCTION__, fileName.c_str());
+  return true;
+}
@@ -0,0 +1,22 @@
+/* binary cache of the per-clip animation AABB lookups of a model, stored next to the model file */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "AABB.h"
+
+class AABBLookupCache {
+  public:
+    static std::string getCacheFileName(std::string modelFileName);
+
+    /* fails if the file is missing, from an older version or was built for another key */
+    static bool load(std::string fileName, uint64_t key, size_t numberOfClips, size_t lookupSize,
+      std::vector<std::vector<AABB>>& aabbLookups);
+    static bool save(std::string fileName, uint64_t key, const std::vector<std::vector<AABB>>& aabbLookups);
+
+  private:
+    /* bump if the layout of the file changes */
+    static const uint32_t CACHE_VERSION = 1;
+};
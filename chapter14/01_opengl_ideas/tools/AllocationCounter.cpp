@@ -0,0 +1,51 @@
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+#include "AllocationCounter.h"
+#include "Logger.h"
+
+static std::atomic<size_t> totalAllocations = 0;
+
+/* replacement of the global new/delete, the array and nothrow variants forward to these by default */
+void* operator new(std::size_t size) {
+  totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  void* ptr = std::malloc(size > 0 ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void AllocationCounter::start() {
+  if (mRunning) {
+    Logger::log(1, "%s error: allocation counter already running\n", __FUNCTION__);
+    return;
+  }
+
+  mRunning = true;
+  mStartAllocations = getTotalAllocations();
+}
+
+size_t AllocationCounter::stop() {
+  if (!mRunning) {
+    Logger::log(1, "%s error: allocation counter not running\n", __FUNCTION__);
+    return 0;
+  }
+  mRunning = false;
+
+  return getTotalAllocations() - mStartAllocations;
+}
+
+size_t AllocationCounter::getTotalAllocations() {
+  return totalAllocations.load(std::memory_order_relaxed);
+}
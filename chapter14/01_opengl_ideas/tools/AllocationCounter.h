@@ -0,0 +1,17 @@
+/* counts the heap allocations done via the global operator new */
+#pragma once
+
+#include <cstddef>
+
+class AllocationCounter {
+  public:
+    void start();
+    /* stops counter and returns the number of allocations since start, of ALL threads */
+    size_t stop();
+
+    static size_t getTotalAllocations();
+
+  private:
+    bool mRunning = false;
+    size_t mStartAllocations = 0;
+};
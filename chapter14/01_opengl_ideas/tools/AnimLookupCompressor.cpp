@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+
+#include "AnimLookupCompressor.h"
+#include "Logger.h"
+
+namespace {
+  /* the three smaller components of a unit quaternion are within +/- 1/sqrt(2) */
+  const float SQRT2 = 1.41421356f;
+  const float QUANTIZATION_STEPS = 65535.0f;
+
+  uint32_t floatBits(float value) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+}
+
+void AnimLookupCompressor::compress(const std::vector<glm::vec4>& animLookupData, float maxError,
+    std::vector<uint32_t>& compressedData, AnimLookupCompressionStats& stats) {
+  stats = AnimLookupCompressionStats{};
+  compressedData.clear();
+
+  const int numberOfSamples = LOOKUP_WIDTH - 1;
+  size_t numberOfChannels = animLookupData.size() / LOOKUP_WIDTH;
+
+  /* a fixed translation error would be too coarse for small models and too fine for large ones */
+  float translationExtent = 0.0f;
+  for (size_t channel = 0; channel < numberOfChannels; channel += 3) {
+    for (int i = 1; i < LOOKUP_WIDTH; ++i) {
+      glm::vec3 translation = glm::abs(glm::vec3(animLookupData.at(channel * LOOKUP_WIDTH + i)));
+      translationExtent = std::max({ translationExtent, translation.x, translation.y, translation.z });
+    }
+  }
+
+  compressedData.resize(numberOfChannels * CHANNEL_HEADER_SIZE, 0);
+
+  std::vector<std::array<uint32_t, 2>> encodedSamples(numberOfSamples);
+  std::vector<glm::vec4> decodedSamples(numberOfSamples);
+  std::vector<int> keys{};
+
+  for (size_t channel = 0; channel < numberOfChannels; ++channel) {
+    bool isTranslation = channel % 3 == 0;
+    bool isRotation = channel % 3 == 1;
+    float tolerance = isTranslation ? maxError * translationExtent : maxError;
+
+    float invTimeScale = animLookupData.at(channel * LOOKUP_WIDTH).x;
+    const glm::vec4* samples = animLookupData.data() + channel * LOOKUP_WIDTH + 1;
+
+    /* the halfs store the offset to the center, that keeps the precision for large translations */
+    glm::vec3 center = glm::vec3(0.0f);
+    if (!isRotation) {
+      glm::vec3 minValue = glm::vec3(samples[0]);
+      glm::vec3 maxValue = glm::vec3(samples[0]);
+      for (int i = 1; i < numberOfSamples; ++i) {
+        minValue = glm::min(minValue, glm::vec3(samples[i]));
+        maxValue = glm::max(maxValue, glm::vec3(samples[i]));
+      }
+      center = (minValue + maxValue) * 0.5f;
+    }
+
+    /* the reduction checks against the quantized values the shader will see */
+    for (int i = 0; i < numberOfSamples; ++i) {
+      if (isRotation) {
+        encodeRotation(samples[i], encodedSamples.at(i).data());
+        decodedSamples.at(i) = decodeRotation(encodedSamples.at(i).data());
+      } else {
+        encodeVector(glm::vec3(samples[i]), center, encodedSamples.at(i).data());
+        decodedSamples.at(i) = glm::vec4(decodeVector(encodedSamples.at(i).data(), center), 1.0f);
+      }
+    }
+
+    auto segmentFits = [&](int start, int end) {
+      for (int i = start + 1; i < end; ++i) {
+        float factor = static_cast<float>(i - start) / static_cast<float>(end - start);
+        glm::vec4 value = interpolate(decodedSamples.at(start), decodedSamples.at(end), factor, isRotation);
+        if (getError(value, samples[i], isRotation) > tolerance) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    keys.clear();
+    keys.emplace_back(0);
+    int start = 0;
+    while (start < numberOfSamples - 1) {
+      /* double the segment while it fits, then search the longest fitting segment in between */
+      int fittingEnd = start + 1;
+      int failingEnd = numberOfSamples;
+      int step = 2;
+      while (fittingEnd < numberOfSamples - 1) {
+        int end = std::min(start + step, numberOfSamples - 1);
+        if (!segmentFits(start, end)) {
+          failingEnd = end;
+          break;
+        }
+        fittingEnd = end;
+        step *= 2;
+      }
+
+      while (failingEnd - fittingEnd > 1) {
+        int end = (fittingEnd + failingEnd) / 2;
+        if (segmentFits(start, end)) {
+          fittingEnd = end;
+        } else {
+          failingEnd = end;
+        }
+      }
+
+      keys.emplace_back(fittingEnd);
+      start = fittingEnd;
+    }
+
+    /* the real error, the keys have a quantization error too */
+    float channelError = 0.0f;
+    for (size_t key = 0; key + 1 < keys.size(); ++key) {
+      for (int i = keys.at(key); i <= keys.at(key + 1); ++i) {
+        float factor = static_cast<float>(i - keys.at(key)) / static_cast<float>(keys.at(key + 1) - keys.at(key));
+        glm::vec4 value = interpolate(decodedSamples.at(keys.at(key)), decodedSamples.at(keys.at(key + 1)), factor,
+          isRotation);
+        channelError = std::max(channelError, getError(value, samples[i], isRotation));
+      }
+    }
+
+    if (isTranslation) {
+      stats.maxTranslationError = std::max(stats.maxTranslationError, channelError);
+    } else if (isRotation) {
+      stats.maxRotationError = std::max(stats.maxRotationError, channelError);
+    } else {
+      stats.maxScaleError = std::max(stats.maxScaleError, channelError);
+    }
+
+    size_t headerOffset = channel * CHANNEL_HEADER_SIZE;
+    compressedData.at(headerOffset) = compressedData.size();
+    compressedData.at(headerOffset + 1) = keys.size();
+    compressedData.at(headerOffset + 2) = floatBits(invTimeScale);
+    compressedData.at(headerOffset + 4) = floatBits(center.x);
+    compressedData.at(headerOffset + 5) = floatBits(center.y);
+    compressedData.at(headerOffset + 6) = floatBits(center.z);
+
+    for (size_t key = 0; key < keys.size(); key += 2) {
+      uint32_t secondKey = key + 1 < keys.size() ? keys.at(key + 1) : 0;
+      compressedData.emplace_back(static_cast<uint32_t>(keys.at(key)) | secondKey << 16);
+    }
+    for (const auto key : keys) {
+      compressedData.emplace_back(encodedSamples.at(key).at(0));
+      compressedData.emplace_back(encodedSamples.at(key).at(1));
+    }
+
+    stats.numberOfSamples += numberOfSamples;
+    stats.numberOfKeys += keys.size();
+  }
+
+  stats.uncompressedSize = animLookupData.size() * sizeof(glm::vec4);
+  stats.compressedSize = compressedData.size() * sizeof(uint32_t);
+
+  Logger::log(1, "%s: kept %i of %i samples, %i bytes instead of %i (max errors: translation %f, rotation %f, scale %f)\n",
+    __FUNCTION__, stats.numberOfKeys, stats.numberOfSamples, stats.compressedSize, stats.uncompressedSize,
+    stats.maxTranslationError, stats.maxRotationError, stats.maxScaleError);
+}
+
+void AnimLookupCompressor::encodeVector(glm::vec3 value, glm::vec3 center, uint32_t* encodedData) {
+  glm::vec3 offset = value - center;
+  encodedData[0] = glm::packHalf2x16(glm::vec2(offset.x, offset.y));
+  encodedData[1] = glm::packHalf2x16(glm::vec2(offset.z, 0.0f));
+}
+
+glm::vec3 AnimLookupCompressor::decodeVector(const uint32_t* encodedData, glm::vec3 center) {
+  glm::vec2 offsetXY = glm::unpackHalf2x16(encodedData[0]);
+  glm::vec2 offsetZ = glm::unpackHalf2x16(encodedData[1]);
+  return center + glm::vec3(offsetXY.x, offsetXY.y, offsetZ.x);
+}
+
+void AnimLookupCompressor::encodeRotation(glm::vec4 rotation, uint32_t* encodedData) {
+  rotation = glm::normalize(rotation);
+
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (std::fabs(rotation[i]) > std::fabs(rotation[largest])) {
+      largest = i;
+    }
+  }
+
+  /* q and -q are the same rotation, the dropped component is always positive */
+  if (rotation[largest] < 0.0f) {
+    rotation = -rotation;
+  }
+
+  uint32_t components[3] = { 0, 0, 0 };
+  int component = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+    float normalized = std::clamp(rotation[i] * SQRT2 * 0.5f + 0.5f, 0.0f, 1.0f);
+    components[component++] = static_cast<uint32_t>(std::round(normalized * QUANTIZATION_STEPS));
+  }
+
+  encodedData[0] = components[0] | components[1] << 16;
+  encodedData[1] = components[2] | static_cast<uint32_t>(largest) << 16;
+}
+
+glm::vec4 AnimLookupCompressor::decodeRotation(const uint32_t* encodedData) {
+  uint32_t components[3] = { encodedData[0] & 0xFFFF, encodedData[0] >> 16, encodedData[1] & 0xFFFF };
+  int largest = encodedData[1] >> 16;
+
+  glm::vec4 rotation = glm::vec4(0.0f);
+  float squaredSum = 0.0f;
+  int component = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+    rotation[i] = (components[component++] / QUANTIZATION_STEPS * 2.0f - 1.0f) / SQRT2;
+    squaredSum += rotation[i] * rotation[i];
+  }
+  rotation[largest] = std::sqrt(std::max(0.0f, 1.0f - squaredSum));
+  return rotation;
+}
+
+float AnimLookupCompressor::getError(glm::vec4 value, glm::vec4 reference, bool isRotation) {
+  if (isRotation) {
+    /* angle between the rotations, from the chord length to stay precise for small angles */
+    value = glm::normalize(value);
+    reference = glm::normalize(reference);
+    if (glm::dot(value, reference) < 0.0f) {
+      reference = -reference;
+    }
+    return 4.0f * std::asin(std::min(glm::length(value - reference) * 0.5f, 1.0f));
+  }
+  return glm::length(glm::vec3(value) - glm::vec3(reference));
+}
+
+glm::vec4 AnimLookupCompressor::interpolate(glm::vec4 first, glm::vec4 second, float factor, bool isRotation) {
+  if (isRotation) {
+    /* nlerp along the shorter arc, the same as the shader */
+    if (glm::dot(first, second) < 0.0f) {
+      second = -second;
+    }
+    return glm::normalize(glm::mix(first, second, factor));
+  }
+  return glm::mix(first, second, factor);
+}
@@ -0,0 +1,45 @@
+/* keyframe reduction and quantization of the animation lookup tables */
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+struct AnimLookupCompressionStats {
+  size_t uncompressedSize = 0;
+  size_t compressedSize = 0;
+  size_t numberOfSamples = 0;
+  size_t numberOfKeys = 0;
+  /* measured against the uncompressed lookups, including the quantization */
+  float maxTranslationError = 0.0f;
+  float maxRotationError = 0.0f;
+  float maxScaleError = 0.0f;
+};
+
+/*
+ * compressed layout, all values are uints:
+ *  - a header of CHANNEL_HEADER_SIZE per lookup row, ordered like the uncompressed rows
+ *    ((clip * numberOfBones + bone) * 3 + channel), channel is translation, rotation or scale
+ *    header: key offset, number of keys, inverse time scaling (float bits), unused, channel center (3 float bits), unused
+ *  - per channel the key sample indices, two 16 bit values per uint
+ *  - per channel two uints per key: half precision offsets to the center for translation and scale,
+ *    smallest-three quaternions with 16 bit components and the index of the largest component for rotation
+ */
+class AnimLookupCompressor {
+  public:
+    /* maxError is the rotation error in radians, the scale error, and the translation error relative to the largest translation */
+    static void compress(const std::vector<glm::vec4>& animLookupData, float maxError,
+      std::vector<uint32_t>& compressedData, AnimLookupCompressionStats& stats);
+
+    static const int LOOKUP_WIDTH = 1023 + 1;
+    static const size_t CHANNEL_HEADER_SIZE = 8;
+
+  private:
+    static void encodeVector(glm::vec3 value, glm::vec3 center, uint32_t* encodedData);
+    static glm::vec3 decodeVector(const uint32_t* encodedData, glm::vec3 center);
+    static void encodeRotation(glm::vec4 rotation, uint32_t* encodedData);
+    static glm::vec4 decodeRotation(const uint32_t* encodedData);
+
+    static float getError(glm::vec4 value, glm::vec4 reference, bool isRotation);
+    static glm::vec4 interpolate(glm::vec4 first, glm::vec4 second, float factor, bool isRotation);
+};
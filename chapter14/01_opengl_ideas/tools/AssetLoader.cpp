@@ -0,0 +1,101 @@
+#include <algorithm>
+
+#include "AssetLoader.h"
+#include "Logger.h"
+
+void AssetLoader::init(unsigned int numThreads) {
+  cleanup();
+
+  mShutdown = false;
+  for (unsigned int i = 0; i < std::max(1u, numThreads); ++i) {
+    mWorkers.emplace_back(&AssetLoader::workerLoop, this);
+  }
+
+  Logger::log(1, "%s: asset loader uses %i threads\n", __FUNCTION__, mWorkers.size());
+}
+
+void AssetLoader::addJob(assetJobFunction job) {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mJobs.emplace_back(std::move(job));
+    ++mNumberOfJobs;
+  }
+  mWakeCondition.notify_one();
+}
+
+void AssetLoader::waitForJobs() {
+  std::unique_lock<std::mutex> lock(mMutex);
+  mDoneCondition.wait(lock, [this]() { return mJobs.empty() && mNumberOfRunningJobs == 0; });
+}
+
+bool AssetLoader::isIdle() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mJobs.empty() && mNumberOfRunningJobs == 0;
+}
+
+size_t AssetLoader::getNumberOfJobs() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mNumberOfJobs;
+}
+
+size_t AssetLoader::getNumberOfFinishedJobs() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mNumberOfFinishedJobs;
+}
+
+size_t AssetLoader::getNumberOfFailedJobs() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mNumberOfFailedJobs;
+}
+
+void AssetLoader::resetCounters() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mNumberOfJobs = mJobs.size() + mNumberOfRunningJobs;
+  mNumberOfFinishedJobs = 0;
+  mNumberOfFailedJobs = 0;
+}
+
+void AssetLoader::workerLoop() {
+  while (true) {
+    assetJobFunction job;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWakeCondition.wait(lock, [this]() { return mShutdown || !mJobs.empty(); });
+      if (mShutdown) {
+        return;
+      }
+
+      job = std::move(mJobs.front());
+      mJobs.pop_front();
+      ++mNumberOfRunningJobs;
+    }
+
+    bool success = job();
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      --mNumberOfRunningJobs;
+      ++mNumberOfFinishedJobs;
+      if (!success) {
+        ++mNumberOfFailedJobs;
+      }
+    }
+    mDoneCondition.notify_all();
+  }
+}
+
+void AssetLoader::cleanup() {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mShutdown = true;
+    mJobs.clear();
+  }
+  mWakeCondition.notify_all();
+  mDoneCondition.notify_all();
+
+  for (auto& worker : mWorkers) {
+    worker.join();
+  }
+  mWorkers.clear();
+  mNumberOfRunningJobs = 0;
+}
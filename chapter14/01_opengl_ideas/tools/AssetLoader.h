@@ -0,0 +1,50 @@
+/* background threads for the CPU side of asset loading, i.e. model import and image decoding */
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/* returns false if the asset could not be loaded */
+using assetJobFunction = std::function<bool()>;
+
+class AssetLoader {
+  public:
+    void init(unsigned int numThreads);
+
+    /* jobs may add more jobs, i.e. a model adds a job for every texture */
+    void addJob(assetJobFunction job);
+
+    /* blocks until the queue is empty and no job is running */
+    void waitForJobs();
+    bool isIdle();
+
+    /* counters since the last reset, jobs added later are counted too */
+    size_t getNumberOfJobs();
+    size_t getNumberOfFinishedJobs();
+    size_t getNumberOfFailedJobs();
+    void resetCounters();
+
+    /* drops the queued jobs, running jobs are finished */
+    void cleanup();
+
+  private:
+    void workerLoop();
+
+    std::vector<std::thread> mWorkers{};
+
+    std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    std::condition_variable mDoneCondition;
+    bool mShutdown = false;
+
+    std::deque<assetJobFunction> mJobs{};
+    size_t mNumberOfRunningJobs = 0;
+
+    size_t mNumberOfJobs = 0;
+    size_t mNumberOfFinishedJobs = 0;
+    size_t mNumberOfFailedJobs = 0;
+};
@@ -0,0 +1,33 @@
+#include "CacheFileSections.h"
+
+void CacheFileSections::writeStrings(std::ofstream& outFile, const std::vector<std::string>& strings) {
+  std::vector<uint32_t> stringEnds;
+  std::vector<char> characters;
+  for (const auto& string : strings) {
+    characters.insert(characters.end(), string.begin(), string.end());
+    stringEnds.emplace_back(characters.size());
+  }
+
+  writeSection(outFile, stringEnds);
+  writeSection(outFile, characters);
+}
+
+bool CacheFileSections::readStrings(const char* fileData, size_t fileSize, size_t& offset, std::vector<std::string>& strings) {
+  std::vector<uint32_t> stringEnds;
+  std::vector<char> characters;
+  if (!readSection(fileData, fileSize, offset, stringEnds) || !readSection(fileData, fileSize, offset, characters)) {
+    return false;
+  }
+
+  strings.clear();
+  strings.reserve(stringEnds.size());
+  uint32_t stringStart = 0;
+  for (const auto stringEnd : stringEnds) {
+    if (stringEnd < stringStart || stringEnd > characters.size()) {
+      return false;
+    }
+    strings.emplace_back(characters.data() + stringStart, stringEnd - stringStart);
+    stringStart = stringEnd;
+  }
+  return true;
+}
@@ -0,0 +1,63 @@
+/* sections of the binary cache files, every section is a small header followed by the raw elements */
+#pragma once
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+class CacheFileSections {
+  public:
+    template <typename T>
+    static void writeSection(std::ofstream& outFile, const std::vector<T>& data) {
+      SectionHeader sectionHeader{};
+      sectionHeader.numberOfElements = data.size();
+      sectionHeader.elementSize = sizeof(T);
+      outFile.write(reinterpret_cast<const char*>(&sectionHeader), sizeof(sectionHeader));
+      outFile.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+
+      const char zeros[SECTION_ALIGNMENT] = {};
+      size_t paddingSize = (SECTION_ALIGNMENT - (data.size() * sizeof(T)) % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+      outFile.write(zeros, paddingSize);
+    }
+
+    template <typename T>
+    static bool readSection(const char* fileData, size_t fileSize, size_t& offset, std::vector<T>& data) {
+      if (offset + sizeof(SectionHeader) > fileSize) {
+        return false;
+      }
+
+      SectionHeader sectionHeader{};
+      std::memcpy(&sectionHeader, fileData + offset, sizeof(sectionHeader));
+      offset += sizeof(sectionHeader);
+
+      if (sectionHeader.elementSize != sizeof(T)) {
+        return false;
+      }
+
+      size_t dataSize = sectionHeader.numberOfElements * sizeof(T);
+      if (sectionHeader.numberOfElements > fileSize / sizeof(T) || offset + dataSize > fileSize) {
+        return false;
+      }
+
+      data.resize(sectionHeader.numberOfElements);
+      std::memcpy(data.data(), fileData + offset, dataSize);
+      offset += dataSize + (SECTION_ALIGNMENT - dataSize % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+      return true;
+    }
+
+    /* strings are stored as one section of end offsets and one section of characters */
+    static void writeStrings(std::ofstream& outFile, const std::vector<std::string>& strings);
+    static bool readStrings(const char* fileData, size_t fileSize, size_t& offset, std::vector<std::string>& strings);
+
+  private:
+    struct SectionHeader {
+      uint64_t numberOfElements;
+      uint32_t elementSize;
+      uint32_t padding;
+    };
+
+    /* section data starts on this boundary */
+    static const size_t SECTION_ALIGNMENT = 16;
+};
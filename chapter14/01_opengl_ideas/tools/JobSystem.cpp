@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include "JobSystem.h"
+#include "Logger.h"
+
+void JobSystem::init(unsigned int numThreads) {
+  cleanup();
+
+  mNumThreads = std::max(1u, numThreads);
+  mShutdown = false;
+
+  /* one queue per worker, the last queue belongs to the calling thread */
+  for (unsigned int i = 0; i < mNumThreads; ++i) {
+    mQueues.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
+  for (unsigned int i = 0; i < mNumThreads - 1; ++i) {
+    mWorkers.emplace_back(&JobSystem::workerLoop, this, i);
+  }
+
+  Logger::log(1, "%s: job system uses %i threads\n", __FUNCTION__, mNumThreads);
+}
+
+unsigned int JobSystem::getNumberOfThreads() {
+  return mNumThreads;
+}
+
+void JobSystem::parallelFor(size_t numElements, size_t chunkSize, jobRangeFunction job) {
+  if (numElements == 0) {
+    return;
+  }
+
+  chunkSize = std::max<size_t>(1, chunkSize);
+
+  /* nothing to distribute */
+  if (mWorkers.empty() || numElements <= chunkSize) {
+    job(0, numElements);
+    return;
+  }
+
+  size_t numRanges = (numElements + chunkSize - 1) / chunkSize;
+
+  /* set the job BEFORE the ranges become visible to the workers */
+  mCurrentJob = job;
+  mRangesLeft = numRanges;
+
+  /* round robin distribution, stealing evens out the rest */
+  for (size_t i = 0; i < numRanges; ++i) {
+    JobRange range{};
+    range.start = i * chunkSize;
+    range.end = std::min(numElements, range.start + chunkSize);
+
+    WorkerQueue& queue = *mQueues.at(i % mQueues.size());
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.ranges.emplace_back(range);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mJobMutex);
+    ++mJobGeneration;
+  }
+  mWakeCondition.notify_all();
+
+  /* help out on our own queue */
+  unsigned int ownQueue = mNumThreads - 1;
+  while (runNextRange(ownQueue)) {}
+
+  std::unique_lock<std::mutex> lock(mJobMutex);
+  mDoneCondition.wait(lock, [this]() { return mRangesLeft == 0; });
+}
+
+bool JobSystem::runNextRange(unsigned int queueId) {
+  JobRange range{};
+  bool found = false;
+
+  {
+    WorkerQueue& queue = *mQueues.at(queueId);
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.ranges.empty()) {
+      range = queue.ranges.front();
+      queue.ranges.pop_front();
+      found = true;
+    }
+  }
+
+  for (unsigned int i = 1; i < mQueues.size() && !found; ++i) {
+    WorkerQueue& victim = *mQueues.at((queueId + i) % mQueues.size());
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.ranges.empty()) {
+      range = victim.ranges.back();
+      victim.ranges.pop_back();
+      found = true;
+    }
+  }
+
+  if (!found) {
+    return false;
+  }
+
+  mCurrentJob(range.start, range.end);
+
+  if (--mRangesLeft == 0) {
+    std::lock_guard<std::mutex> lock(mJobMutex);
+    mDoneCondition.notify_all();
+  }
+  return true;
+}
+
+void JobSystem::workerLoop(unsigned int queueId) {
+  uint64_t lastGeneration = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mJobMutex);
+      mWakeCondition.wait(lock, [&]() { return mShutdown || mJobGeneration != lastGeneration; });
+      if (mShutdown) {
+        return;
+      }
+      lastGeneration = mJobGeneration;
+    }
+
+    while (runNextRange(queueId)) {}
+  }
+}
+
+void JobSystem::cleanup() {
+  {
+    std::lock_guard<std::mutex> lock(mJobMutex);
+    mShutdown = true;
+  }
+  mWakeCondition.notify_all();
+
+  for (auto& worker : mWorkers) {
+    worker.join();
+  }
+
+  mWorkers.clear();
+  mQueues.clear();
+  mNumThreads = 1;
+}
@@ -0,0 +1,55 @@
+/* small work stealing thread pool, splits index ranges into chunks and runs them on all workers */
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+/* job gets the start (inclusive) and end (exclusive) index of a chunk */
+using jobRangeFunction = std::function<void(size_t, size_t)>;
+
+class JobSystem {
+  public:
+    /* number of threads INCLUDING the calling thread, 1 runs everything inline */
+    void init(unsigned int numThreads);
+    unsigned int getNumberOfThreads();
+
+    /* blocks until all chunks are done, the calling thread works on the chunks too */
+    void parallelFor(size_t numElements, size_t chunkSize, jobRangeFunction job);
+
+    void cleanup();
+
+  private:
+    struct JobRange {
+      size_t start;
+      size_t end;
+    };
+
+    struct WorkerQueue {
+      std::mutex mutex;
+      std::deque<JobRange> ranges;
+    };
+
+    void workerLoop(unsigned int queueId);
+    /* pop from own queue front first, steal from the back of other queues */
+    bool runNextRange(unsigned int queueId);
+
+    unsigned int mNumThreads = 1;
+    std::vector<std::thread> mWorkers{};
+    std::vector<std::unique_ptr<WorkerQueue>> mQueues{};
+
+    jobRangeFunction mCurrentJob;
+    std::atomic<size_t> mRangesLeft = 0;
+
+    std::mutex mJobMutex;
+    std::condition_variable mWakeCondition;
+    std::condition_variable mDoneCondition;
+    uint64_t mJobGeneration = 0;
+    bool mShutdown = false;
+};
@@ -0,0 +1,189 @@
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <type_traits>
+
+#include "LevelDataCache.h"
+#include "CacheFileSections.h"
+#include "MappedFile.h"
+#include "Logger.h"
+
+namespace {
+  struct CacheFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t numberOfSections;
+    uint32_t padding;
+  };
+
+  const char CACHE_MAGIC[4] = { 'L', 'V', 'D', 'C' };
+  const uint32_t NUMBER_OF_SECTIONS = 9;
+
+  /* the sections are copied byte by byte */
+  static_assert(std::is_trivially_copyable<MeshTriangle>::value, "MeshTriangle must be trivially copyable");
+  static_assert(std::is_trivially_copyable<TriangleBVHNode>::value, "TriangleBVHNode must be trivially copyable");
+  static_assert(std::is_trivially_copyable<NavTriangle>::value, "NavTriangle must be trivially copyable");
+  static_assert(std::is_trivially_copyable<glm::vec3>::value, "glm::vec3 must be trivially copyable");
+
+  /* the path search uses unchecked access, every index must be in range */
+  bool isValidNavGraph(const NavGraph& navGraph) {
+    int numberOfNavTriangles = static_cast<int>(navGraph.navTriangles.size());
+    int numberOfNeighbors = static_cast<int>(navGraph.neighborIndices.size());
+
+    /* a graph without the trailing offset would read out of bounds */
+    if (navGraph.neighborOffsets.size() != navGraph.navTriangles.size() + 1 ||
+        navGraph.navCenters.size() != navGraph.navTriangles.size() ||
+        navGraph.neighborCosts.size() != navGraph.neighborIndices.size()) {
+      return false;
+    }
+
+    if (navGraph.neighborOffsets.front() != 0 || navGraph.neighborOffsets.back() != numberOfNeighbors) {
+      return false;
+    }
+    for (size_t i = 1; i < navGraph.neighborOffsets.size(); ++i) {
+      if (navGraph.neighborOffsets.at(i) < navGraph.neighborOffsets.at(i - 1)) {
+        return false;
+      }
+    }
+
+    for (const auto neighbor : navGraph.neighborIndices) {
+      if (neighbor < 0 || neighbor >= numberOfNavTriangles) {
+        return false;
+      }
+    }
+
+    for (const auto navIndex : navGraph.navIndices) {
+      if (navIndex < -1 || navIndex >= numberOfNavTriangles) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+}
+
+uint64_t LevelDataCache::hashData(const void* data, size_t size, uint64_t hash) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+uint64_t LevelDataCache::hashFile(std::string fileName, uint64_t hash) {
+  MappedFile file{};
+  if (!file.open(fileName)) {
+    Logger::log(1, "%s error: could not open file '%s' for hashing\n", __FUNCTION__, fileName.c_str());
+    return hash;
+  }
+
+  return hashData(file.getData(), file.getSize(), hash);
+}
+
+bool LevelDataCache::load(std::string fileName, uint64_t key, std::vector<MeshTriangle>& triangles,
+    std::vector<TriangleBVHNode>& bvhNodes, std::vector<int>& bvhTriIndices, NavGraph& navGraph) {
+  MappedFile file{};
+  if (!file.open(fileName)) {
+    return false;
+  }
+
+  const char* fileData = file.getData();
+  size_t fileSize = file.getSize();
+
+  if (fileSize < sizeof(CacheFileHeader)) {
+    Logger::log(1, "%s error: cache file '%s' is too small\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  CacheFileHeader header{};
+  std::memcpy(&header, fileData, sizeof(header));
+  if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+      header.numberOfSections != NUMBER_OF_SECTIONS) {
+    Logger::log(1, "%s: cache file '%s' has an old format, ignoring it\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  if (header.key != key) {
+    Logger::log(1, "%s: cache file '%s' was built for other level data, ignoring it\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  size_t offset = sizeof(CacheFileHeader);
+  if (!CacheFileSections::readSection(fileData, fileSize, offset, triangles) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, bvhNodes) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, bvhTriIndices) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, navGraph.navTriangles) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, navGraph.navIndices) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, navGraph.neighborOffsets) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, navGraph.neighborIndices) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, navGraph.neighborCosts) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, navGraph.navCenters)) {
+    Logger::log(1, "%s error: cache file '%s' is damaged\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  if (!isValidNavGraph(navGraph)) {
+    Logger::log(1, "%s error: cache file '%s' has an invalid nav graph\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  Logger::log(1, "%s: loaded %i triangles and %i nav triangles from cache file '%s'\n", __FUNCTION__,
+    triangles.size(), navGraph.navTriangles.size(), fileName.c_str());
+  return true;
+}
+
+bool LevelDataCache::save(std::string fileName, uint64_t key, const std::vector<MeshTriangle>& triangles,
+    const std::vector<TriangleBVHNode>& bvhNodes, const std::vector<int>& bvhTriIndices, const NavGraph& navGraph) {
+  std::filesystem::path filePath(fileName);
+  std::error_code errorCode{};
+  if (filePath.has_parent_path()) {
+    std::filesystem::create_directories(filePath.parent_path(), errorCode);
+  }
+
+  /* write to a temporary file first, a crash must not leave a half written cache */
+  std::string tempFileName = fileName + ".tmp";
+  {
+    std::ofstream outFile(tempFileName, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+      Logger::log(1, "%s error: could not open cache file '%s' for writing\n", __FUNCTION__, tempFileName.c_str());
+      return false;
+    }
+
+    CacheFileHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.numberOfSections = NUMBER_OF_SECTIONS;
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    CacheFileSections::writeSection(outFile, triangles);
+    CacheFileSections::writeSection(outFile, bvhNodes);
+    CacheFileSections::writeSection(outFile, bvhTriIndices);
+    CacheFileSections::writeSection(outFile, navGraph.navTriangles);
+    CacheFileSections::writeSection(outFile, navGraph.navIndices);
+    CacheFileSections::writeSection(outFile, navGraph.neighborOffsets);
+    CacheFileSections::writeSection(outFile, navGraph.neighborIndices);
+    CacheFileSections::writeSection(outFile, navGraph.neighborCosts);
+    CacheFileSections::writeSection(outFile, navGraph.navCenters);
+
+    if (!outFile.good()) {
+      Logger::log(1, "%s error: could not write cache file '%s'\n", __FUNCTION__, tempFileName.c_str());
+      outFile.close();
+      std::filesystem::remove(tempFileName, errorCode);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tempFileName, fileName, errorCode);
+  if (errorCode) {
+    Logger::log(1, "%s error: could not rename cache file '%s' (%s)\n", __FUNCTION__, tempFileName.c_str(),
+      errorCode.message().c_str());
+    std::filesystem::remove(tempFileName, errorCode);
+    return false;
+  }
+
+  Logger::log(1, "%s: saved level data cache file '%s'\n", __FUNCTION__, fileName.c_str());
+  return true;
+}
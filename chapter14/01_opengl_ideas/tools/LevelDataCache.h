@@ -0,0 +1,29 @@
+/* binary cache of the processed level triangles, the triangle BVH and the nav graph */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "OGLRenderData.h"
+#include "PathFinder.h"
+#include "TriangleBVH.h"
+
+class LevelDataCache {
+  public:
+    /* FNV-1a, chain the calls to build a key from several values */
+    static uint64_t hashData(const void* data, size_t size, uint64_t hash = FNV_OFFSET_BASIS);
+    static uint64_t hashFile(std::string fileName, uint64_t hash = FNV_OFFSET_BASIS);
+
+    /* fails if the file is missing, from an older version or was built for another key */
+    static bool load(std::string fileName, uint64_t key, std::vector<MeshTriangle>& triangles,
+      std::vector<TriangleBVHNode>& bvhNodes, std::vector<int>& bvhTriIndices, NavGraph& navGraph);
+    static bool save(std::string fileName, uint64_t key, const std::vector<MeshTriangle>& triangles,
+      const std::vector<TriangleBVHNode>& bvhNodes, const std::vector<int>& bvhTriIndices, const NavGraph& navGraph);
+
+    static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+  private:
+    /* bump if the layout of the file or of the stored structs changes */
+    static const uint32_t CACHE_VERSION = 2;
+};
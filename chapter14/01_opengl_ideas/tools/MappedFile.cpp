@@ -0,0 +1,120 @@
+#include "MappedFile.h"
+#include "Logger.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(std::string fileName) {
+  close();
+
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  mFileHandle = file;
+
+  LARGE_INTEGER fileSize{};
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+    close();
+    return false;
+  }
+  mSize = static_cast<size_t>(fileSize.QuadPart);
+
+  mMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mMappingHandle) {
+    Logger::log(1, "%s error: could not create mapping for file '%s'\n", __FUNCTION__, fileName.c_str());
+    close();
+    return false;
+  }
+
+  mData = static_cast<const char*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+  if (!mData) {
+    Logger::log(1, "%s error: could not map file '%s'\n", __FUNCTION__, fileName.c_str());
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void MappedFile::close() {
+  if (mData) {
+    UnmapViewOfFile(mData);
+  }
+  if (mMappingHandle) {
+    CloseHandle(mMappingHandle);
+  }
+  if (mFileHandle) {
+    CloseHandle(mFileHandle);
+  }
+
+  mData = nullptr;
+  mSize = 0;
+  mMappingHandle = nullptr;
+  mFileHandle = nullptr;
+}
+#else
+bool MappedFile::open(std::string fileName) {
+  close();
+
+  mFileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+  if (mFileDescriptor < 0) {
+    return false;
+  }
+
+  struct stat fileStat{};
+  if (fstat(mFileDescriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+    close();
+    return false;
+  }
+  mSize = static_cast<size_t>(fileStat.st_size);
+
+  void* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFileDescriptor, 0);
+  if (data == MAP_FAILED) {
+    Logger::log(1, "%s error: could not map file '%s'\n", __FUNCTION__, fileName.c_str());
+    close();
+    return false;
+  }
+  mData = static_cast<const char*>(data);
+
+  /* the whole file is read once from front to back */
+  madvise(data, mSize, MADV_SEQUENTIAL);
+
+  return true;
+}
+
+void MappedFile::close() {
+  if (mData) {
+    munmap(const_cast<char*>(mData), mSize);
+  }
+  if (mFileDescriptor >= 0) {
+    ::close(mFileDescriptor);
+  }
+
+  mData = nullptr;
+  mSize = 0;
+  mFileDescriptor = -1;
+}
+#endif
+
+const char* MappedFile::getData() {
+  return mData;
+}
+
+size_t MappedFile::getSize() {
+  return mSize;
+}
@@ -0,0 +1,32 @@
+/* read-only memory mapping of a whole file */
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+class MappedFile {
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(std::string fileName);
+    void close();
+
+    /* valid until close(), nullptr if nothing is mapped */
+    const char* getData();
+    size_t getSize();
+
+  private:
+    const char* mData = nullptr;
+    size_t mSize = 0;
+
+#ifdef _WIN32
+    void* mFileHandle = nullptr;
+    void* mMappingHandle = nullptr;
+#else
+    int mFileDescriptor = -1;
+#endif
+};
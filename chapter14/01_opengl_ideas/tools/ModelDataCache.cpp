@@ -0,0 +1,377 @@
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <type_traits>
+
+#include "ModelDataCache.h"
+#include "CacheFileSections.h"
+#include "LevelDataCache.h"
+#include "MappedFile.h"
+#include "AnimLookupCompressor.h"
+#include "Logger.h"
+
+namespace {
+  struct CacheFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+  };
+
+  struct CacheModelInfo {
+    uint32_t triangleCount;
+    uint32_t vertexCount;
+    uint32_t numAnimatedMeshes;
+    uint32_t numberOfMeshes;
+    uint32_t numberOfEmbeddedTextures;
+    float maxClipDuration;
+    float importTime;
+    uint32_t padding;
+    glm::mat4 rootTransformMatrix;
+  };
+
+  struct CacheMeshInfo {
+    uint32_t usesPBRColors;
+    uint32_t numberOfMorphMeshes;
+    uint32_t numberOfTextures;
+    uint32_t padding;
+  };
+
+  struct CacheTextureInfo {
+    int32_t width;
+    int32_t height;
+  };
+
+  const char CACHE_MAGIC[4] = { 'M', 'D', 'L', 'C' };
+
+  /* the sections are copied byte by byte */
+  static_assert(std::is_trivially_copyable<OGLVertex>::value, "OGLVertex must be trivially copyable");
+  static_assert(std::is_trivially_copyable<OGLMorphVertex>::value, "OGLMorphVertex must be trivially copyable");
+  static_assert(std::is_trivially_copyable<glm::mat4>::value, "glm::mat4 must be trivially copyable");
+}
+
+std::string ModelDataCache::getCacheFileName(std::string modelFileName) {
+  return modelFileName + ".modelcache";
+}
+
+uint64_t ModelDataCache::createKey(std::string modelFileName, const std::vector<std::string>& sourceFiles,
+    unsigned int importFlags) {
+  std::filesystem::path modelPath = std::filesystem::path(modelFileName);
+  std::string modelName = modelPath.filename().generic_string();
+
+  uint64_t key = LevelDataCache::hashFile(modelFileName);
+  for (const auto& sourceFile : sourceFiles) {
+    if (sourceFile == modelName) {
+      continue;
+    }
+    /* the name is part of the key too, a missing file must not hash like an empty one */
+    key = LevelDataCache::hashData(sourceFile.data(), sourceFile.size(), key);
+    key = LevelDataCache::hashFile((modelPath.parent_path() / sourceFile).generic_string(), key);
+  }
+  return LevelDataCache::hashData(&importFlags, sizeof(importFlags), key);
+}
+
+bool ModelDataCache::load(std::string fileName, std::string modelFileName, unsigned int importFlags,
+    ModelCacheData& modelData) {
+  MappedFile file{};
+  if (!file.open(fileName)) {
+    return false;
+  }
+
+  const char* fileData = file.getData();
+  size_t fileSize = file.getSize();
+
+  if (fileSize < sizeof(CacheFileHeader)) {
+    Logger::log(1, "%s error: cache file '%s' is too small\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  CacheFileHeader header{};
+  std::memcpy(&header, fileData, sizeof(header));
+  if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION) {
+    Logger::log(1, "%s: cache file '%s' has an old format, ignoring it\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  size_t offset = sizeof(CacheFileHeader);
+
+  /* the source files are stored first, the key needs them */
+  if (!CacheFileSections::readStrings(fileData, fileSize, offset, modelData.sourceFiles)) {
+    Logger::log(1, "%s error: cache file '%s' is damaged\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  modelData.sourceKey = createKey(modelFileName, modelData.sourceFiles, importFlags);
+  if (header.key != modelData.sourceKey) {
+    Logger::log(1, "%s: cache file '%s' was built for other source files, ignoring it\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  std::vector<CacheModelInfo> modelInfo;
+  std::vector<CacheMeshInfo> meshInfos;
+  std::vector<int32_t> textureTypes;
+  std::vector<std::string> textureNames;
+  if (!CacheFileSections::readSection(fileData, fileSize, offset, modelInfo) || modelInfo.size() != 1 ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, meshInfos) ||
+      meshInfos.size() != modelInfo.at(0).numberOfMeshes ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, textureTypes) ||
+      !CacheFileSections::readStrings(fileData, fileSize, offset, textureNames) ||
+      textureTypes.size() != textureNames.size()) {
+    Logger::log(1, "%s error: cache file '%s' is damaged\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  modelData.triangleCount = modelInfo.at(0).triangleCount;
+  modelData.vertexCount = modelInfo.at(0).vertexCount;
+  modelData.numAnimatedMeshes = modelInfo.at(0).numAnimatedMeshes;
+  modelData.maxClipDuration = modelInfo.at(0).maxClipDuration;
+  modelData.importTime = modelInfo.at(0).importTime;
+  modelData.rootTransformMatrix = modelInfo.at(0).rootTransformMatrix;
+
+  modelData.meshes.clear();
+  modelData.meshes.resize(meshInfos.size());
+  size_t textureIndex = 0;
+  for (size_t i = 0; i < meshInfos.size(); ++i) {
+    const CacheMeshInfo& meshInfo = meshInfos.at(i);
+    OGLMesh& mesh = modelData.meshes.at(i);
+
+    mesh.usesPBRColors = meshInfo.usesPBRColors != 0;
+
+    if (textureIndex + meshInfo.numberOfTextures > textureNames.size()) {
+      Logger::log(1, "%s error: cache file '%s' has invalid texture names\n", __FUNCTION__, fileName.c_str());
+      return false;
+    }
+    for (uint32_t j = 0; j < meshInfo.numberOfTextures; ++j, ++textureIndex) {
+      mesh.textures.insert({static_cast<aiTextureType>(textureTypes.at(textureIndex)), textureNames.at(textureIndex)});
+    }
+
+    std::vector<OGLMorphVertex> morphVertices;
+    if (!CacheFileSections::readSection(fileData, fileSize, offset, mesh.vertices) ||
+        !CacheFileSections::readSection(fileData, fileSize, offset, mesh.indices) ||
+        !CacheFileSections::readSection(fileData, fileSize, offset, morphVertices) ||
+        morphVertices.size() != mesh.vertices.size() * meshInfo.numberOfMorphMeshes) {
+      Logger::log(1, "%s error: cache file '%s' has damaged mesh data\n", __FUNCTION__, fileName.c_str());
+      return false;
+    }
+
+    /* every morph mesh has the same number of vertices as the mesh itself */
+    mesh.morphMeshes.resize(meshInfo.numberOfMorphMeshes);
+    for (uint32_t j = 0; j < meshInfo.numberOfMorphMeshes; ++j) {
+      mesh.morphMeshes.at(j).morphVertices.assign(morphVertices.begin() + j * mesh.vertices.size(),
+        morphVertices.begin() + (j + 1) * mesh.vertices.size());
+    }
+  }
+
+  std::vector<CacheTextureInfo> textureInfos;
+  std::vector<std::string> embeddedTextureNames;
+  if (!CacheFileSections::readStrings(fileData, fileSize, offset, modelData.nodeNames) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, modelData.nodeParentIndices) ||
+      !CacheFileSections::readStrings(fileData, fileSize, offset, modelData.boneNames) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, modelData.boneIds) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, modelData.boneOffsetMatrices) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, modelData.boneParentIndices) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, modelData.boneLevelData) ||
+      !CacheFileSections::readStrings(fileData, fileSize, offset, modelData.clipNames) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, modelData.clipDurations) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, modelData.clipTicksPerSecond) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, modelData.animLookupData) ||
+      !CacheFileSections::readSection(fileData, fileSize, offset, textureInfos) ||
+      !CacheFileSections::readStrings(fileData, fileSize, offset, embeddedTextureNames) ||
+      textureInfos.size() != modelInfo.at(0).numberOfEmbeddedTextures ||
+      embeddedTextureNames.size() != textureInfos.size()) {
+    Logger::log(1, "%s error: cache file '%s' is damaged\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  modelData.embeddedTextures.clear();
+  modelData.embeddedTextures.resize(textureInfos.size());
+  for (size_t i = 0; i < textureInfos.size(); ++i) {
+    ModelCacheTexture& texture = modelData.embeddedTextures.at(i);
+    texture.name = embeddedTextureNames.at(i);
+    texture.width = textureInfos.at(i).width;
+    texture.height = textureInfos.at(i).height;
+    if (!CacheFileSections::readSection(fileData, fileSize, offset, texture.data)) {
+      Logger::log(1, "%s error: cache file '%s' has damaged texture data\n", __FUNCTION__, fileName.c_str());
+      return false;
+    }
+  }
+
+  /* the lists must fit to each other, the model code uses them without checks */
+  size_t numberOfBones = modelData.boneNames.size();
+  size_t numberOfClips = modelData.clipNames.size();
+  if (modelData.nodeParentIndices.size() != modelData.nodeNames.size() || modelData.nodeNames.empty() ||
+      modelData.boneIds.size() != numberOfBones || modelData.boneOffsetMatrices.size() != numberOfBones ||
+      modelData.boneParentIndices.size() != numberOfBones ||
+      modelData.clipDurations.size() != numberOfClips || modelData.clipTicksPerSecond.size() != numberOfClips) {
+    Logger::log(1, "%s error: cache file '%s' has inconsistent model data\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  for (size_t i = 0; i < modelData.nodeParentIndices.size(); ++i) {
+    if (modelData.nodeParentIndices.at(i) >= static_cast<int32_t>(i) || (i > 0 && modelData.nodeParentIndices.at(i) < 0)) {
+      Logger::log(1, "%s error: cache file '%s' has an invalid node tree\n", __FUNCTION__, fileName.c_str());
+      return false;
+    }
+  }
+
+  /* the compute shaders index the bone lists with the stored values */
+  for (const auto& parentIndex : modelData.boneParentIndices) {
+    if (parentIndex < -1 || parentIndex >= static_cast<int32_t>(numberOfBones)) {
+      Logger::log(1, "%s error: cache file '%s' has invalid bone parents\n", __FUNCTION__, fileName.c_str());
+      return false;
+    }
+  }
+
+  /* number of levels, start offset of every level plus the end offset, bone ids */
+  const std::vector<int32_t>& levelData = modelData.boneLevelData;
+  bool validLevels = !levelData.empty() && levelData.at(0) >= 0 &&
+    levelData.size() == static_cast<size_t>(levelData.at(0)) + 2 + numberOfBones;
+  if (validLevels) {
+    int32_t numberOfLevels = levelData.at(0);
+    validLevels = levelData.at(1) == 0 && levelData.at(numberOfLevels + 1) == static_cast<int32_t>(numberOfBones);
+
+    /* every bone exactly once, the parent must be in one of the previous levels */
+    std::vector<int32_t> boneLevels(numberOfBones, -1);
+    for (int32_t level = 0; validLevels && level < numberOfLevels; ++level) {
+      int32_t levelStart = levelData.at(level + 1);
+      int32_t levelEnd = levelData.at(level + 2);
+      if (levelStart > levelEnd) {
+        validLevels = false;
+        break;
+      }
+      for (int32_t i = levelStart; i < levelEnd; ++i) {
+        int32_t boneId = levelData.at(numberOfLevels + 2 + i);
+        if (boneId < 0 || boneId >= static_cast<int32_t>(numberOfBones) || boneLevels.at(boneId) >= 0) {
+          validLevels = false;
+          break;
+        }
+        int32_t parentBone = modelData.boneParentIndices.at(boneId);
+        if (parentBone >= 0 && (boneLevels.at(parentBone) < 0 || boneLevels.at(parentBone) >= level)) {
+          validLevels = false;
+          break;
+        }
+        boneLevels.at(boneId) = level;
+      }
+    }
+  }
+  if (!validLevels) {
+    Logger::log(1, "%s error: cache file '%s' has invalid bone levels\n", __FUNCTION__, fileName.c_str());
+    return false;
+  }
+
+  /* translation, rotation and scale row for every bone in every clip */
+  size_t lookupSize = numberOfClips * numberOfBones * AnimLookupCompressor::LOOKUP_WIDTH * 3;
+  if (modelData.animLookupData.size() != lookupSize) {
+    Logger::log(1, "%s error: cache file '%s' has %i elements of lookup data, expected %i\n", __FUNCTION__,
+      fileName.c_str(), modelData.animLookupData.size(), lookupSize);
+    return false;
+  }
+
+  Logger::log(1, "%s: loaded %i meshes, %i bones and %i clips from cache file '%s'\n", __FUNCTION__,
+    modelData.meshes.size(), numberOfBones, numberOfClips, fileName.c_str());
+  return true;
+}
+
+bool ModelDataCache::save(std::string fileName, const ModelCacheData& modelData) {
+  CacheModelInfo modelInfo{};
+  modelInfo.triangleCount = modelData.triangleCount;
+  modelInfo.vertexCount = modelData.vertexCount;
+  modelInfo.numAnimatedMeshes = modelData.numAnimatedMeshes;
+  modelInfo.numberOfMeshes = modelData.meshes.size();
+  modelInfo.numberOfEmbeddedTextures = modelData.embeddedTextures.size();
+  modelInfo.maxClipDuration = modelData.maxClipDuration;
+  modelInfo.importTime = modelData.importTime;
+  modelInfo.rootTransformMatrix = modelData.rootTransformMatrix;
+
+  std::vector<CacheMeshInfo> meshInfos;
+  std::vector<int32_t> textureTypes;
+  std::vector<std::string> textureNames;
+  for (const auto& mesh : modelData.meshes) {
+    CacheMeshInfo meshInfo{};
+    meshInfo.usesPBRColors = mesh.usesPBRColors ? 1 : 0;
+    meshInfo.numberOfMorphMeshes = mesh.morphMeshes.size();
+    meshInfo.numberOfTextures = mesh.textures.size();
+    meshInfos.emplace_back(meshInfo);
+
+    for (const auto& texture : mesh.textures) {
+      textureTypes.emplace_back(static_cast<int32_t>(texture.first));
+      textureNames.emplace_back(texture.second);
+    }
+  }
+
+  std::vector<CacheTextureInfo> textureInfos;
+  std::vector<std::string> embeddedTextureNames;
+  for (const auto& texture : modelData.embeddedTextures) {
+    textureInfos.push_back({texture.width, texture.height});
+    embeddedTextureNames.emplace_back(texture.name);
+  }
+
+  /* write to a temporary file first, a crash must not leave a half written cache */
+  std::error_code errorCode{};
+  std::string tempFileName = fileName + ".tmp";
+  {
+    std::ofstream outFile(tempFileName, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+      Logger::log(1, "%s error: could not open cache file '%s' for writing\n", __FUNCTION__, tempFileName.c_str());
+      return false;
+    }
+
+    CacheFileHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.key = modelData.sourceKey;
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    CacheFileSections::writeStrings(outFile, modelData.sourceFiles);
+
+    CacheFileSections::writeSection(outFile, std::vector<CacheModelInfo>{ modelInfo });
+    CacheFileSections::writeSection(outFile, meshInfos);
+    CacheFileSections::writeSection(outFile, textureTypes);
+    CacheFileSections::writeStrings(outFile, textureNames);
+
+    for (const auto& mesh : modelData.meshes) {
+      std::vector<OGLMorphVertex> morphVertices;
+      for (const auto& morphMesh : mesh.morphMeshes) {
+        morphVertices.insert(morphVertices.end(), morphMesh.morphVertices.begin(), morphMesh.morphVertices.end());
+      }
+
+      CacheFileSections::writeSection(outFile, mesh.vertices);
+      CacheFileSections::writeSection(outFile, mesh.indices);
+      CacheFileSections::writeSection(outFile, morphVertices);
+    }
+
+    CacheFileSections::writeStrings(outFile, modelData.nodeNames);
+    CacheFileSections::writeSection(outFile, modelData.nodeParentIndices);
+    CacheFileSections::writeStrings(outFile, modelData.boneNames);
+    CacheFileSections::writeSection(outFile, modelData.boneIds);
+    CacheFileSections::writeSection(outFile, modelData.boneOffsetMatrices);
+    CacheFileSections::writeSection(outFile, modelData.boneParentIndices);
+    CacheFileSections::writeSection(outFile, modelData.boneLevelData);
+    CacheFileSections::writeStrings(outFile, modelData.clipNames);
+    CacheFileSections::writeSection(outFile, modelData.clipDurations);
+    CacheFileSections::writeSection(outFile, modelData.clipTicksPerSecond);
+    CacheFileSections::writeSection(outFile, modelData.animLookupData);
+    CacheFileSections::writeSection(outFile, textureInfos);
+    CacheFileSections::writeStrings(outFile, embeddedTextureNames);
+    for (const auto& texture : modelData.embeddedTextures) {
+      CacheFileSections::writeSection(outFile, texture.data);
+    }
+
+    if (!outFile.good()) {
+      Logger::log(1, "%s error: could not write cache file '%s'\n", __FUNCTION__, tempFileName.c_str());
+      outFile.close();
+      std::filesystem::remove(tempFileName, errorCode);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tempFileName, fileName, errorCode);
+  if (errorCode) {
+    Logger::log(1, "%s error: could not rename cache file '%s' (%s)\n", __FUNCTION__, tempFileName.c_str(),
+      errorCode.message().c_str());
+    std::filesystem::remove(tempFileName, errorCode);
+    return false;
+  }
+
+  Logger::log(1, "%s: saved model cache file '%s'\n", __FUNCTION__, fileName.c_str());
+  return true;
+}
@@ -0,0 +1,68 @@
+/* binary cache of a fully processed Assimp model, stored next to the model file */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "OGLRenderData.h"
+
+/* embedded textures keep the data as stored by Assimp, compressed images have a height of 0 */
+struct ModelCacheTexture {
+  std::string name;
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> data{};
+};
+
+struct ModelCacheData {
+  /* all files Assimp opened for the import, relative to the directory of the model file */
+  std::vector<std::string> sourceFiles{};
+  /* hash of the source files and the import flags */
+  uint64_t sourceKey = 0;
+
+  unsigned int triangleCount = 0;
+  unsigned int vertexCount = 0;
+  unsigned int numAnimatedMeshes = 0;
+  float maxClipDuration = 0.0f;
+  /* duration of the Assimp import in ms, for the load time comparison */
+  float importTime = 0.0f;
+  glm::mat4 rootTransformMatrix = glm::mat4(1.0f);
+
+  std::vector<OGLMesh> meshes{};
+
+  /* node list in insertion order, the parent of a node is always stored before the node */
+  std::vector<std::string> nodeNames{};
+  std::vector<int32_t> nodeParentIndices{};
+
+  std::vector<std::string> boneNames{};
+  std::vector<uint32_t> boneIds{};
+  std::vector<glm::mat4> boneOffsetMatrices{};
+  std::vector<int32_t> boneParentIndices{};
+  std::vector<int32_t> boneLevelData{};
+
+  std::vector<std::string> clipNames{};
+  std::vector<float> clipDurations{};
+  std::vector<float> clipTicksPerSecond{};
+  std::vector<glm::vec4> animLookupData{};
+
+  std::vector<ModelCacheTexture> embeddedTextures{};
+};
+
+class ModelDataCache {
+  public:
+    static std::string getCacheFileName(std::string modelFileName);
+    /* the model file is always part of the key, even if it is missing in the source files */
+    static uint64_t createKey(std::string modelFileName, const std::vector<std::string>& sourceFiles,
+      unsigned int importFlags);
+
+    /* fails if the file is missing, from an older version or one of the source files has changed */
+    static bool load(std::string fileName, std::string modelFileName, unsigned int importFlags, ModelCacheData& modelData);
+    /* the key is the sourceKey of the model data */
+    static bool save(std::string fileName, const ModelCacheData& modelData);
+
+  private:
+    /* bump if the layout of the file or of the stored structs changes */
+    static const uint32_t CACHE_VERSION = 2;
+};
@@ -1,18 +1,27 @@
 #include "PathFinder.h"
 
-#include <queue>
+#include <algorithm>
+#include <unordered_map>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
 #include "Logger.h"
 
-void PathFinder::generateGroundTriangles(OGLRenderData& renderData, std::shared_ptr<TriangleOctree> octree, BoundingBox3D worldbox) {
-  mNavTriangles.clear();
+thread_local PathSearchContext PathFinder::mSearchContext{};
 
-  mLevelGroundMesh = std::make_shared<OGLLineMesh>();
+void PathFinder::generateGroundTriangles(OGLRenderData& renderData, std::shared_ptr<TriangleBVH> bvh) {
+  /* build a new graph, searches still running on the old one keep their copy */
+  std::shared_ptr<NavGraph> navGraph = std::make_shared<NavGraph>();
+  std::vector<NavTriangle>& navTriangles = navGraph->navTriangles;
+  std::vector<int>& navIndices = navGraph->navIndices;
 
-  /* get all triangles frm octree */
-  std::vector<MeshTriangle> levelTris = octree->query(worldbox);
+  /* the triangle index is the position in the BVH triangle list */
+  const std::vector<MeshTriangle>& levelTris = bvh->getTriangles();
   Logger::log(1, "%s: level has %i triangles \n", __FUNCTION__, levelTris.size());
 
+  navIndices.resize(levelTris.size(), -1);
+
   /* find all triangles that face upwards */
   std::vector<MeshTriangle> groundTris{};
   NavTriangle navTri;
@@ -25,15 +34,18 @@ void PathFinder::generateGroundTriangles(OGLRenderData& renderData, std::shared_
       navTri.index = tri.index;
       navTri.center = (tri.points.at(0) + tri.points.at(1) + tri.points.at(2)) / 3.0f;
 
-      mNavTriangles.insert(std::make_pair(tri.index, navTri));
+      navIndices.at(tri.index) = navTriangles.size();
+      navTriangles.emplace_back(navTri);
+      navGraph->navCenters.emplace_back(navTri.center);
     }
   }
 
-  Logger::log(1, "%s: level has %i (%i) possible ground triangles\n", __FUNCTION__, groundTris.size(), mNavTriangles.size());
-
-  OGLLineVertex vert;
-  vert.color = glm::vec3(0.0f, 0.2f, 0.8f);
+  Logger::log(1, "%s: level has %i (%i) possible ground triangles\n", __FUNCTION__, groundTris.size(), navTriangles.size());
 
+  /* ground triangles are in the same order as the nav triangles */
+  navGraph->neighborOffsets.reserve(groundTris.size() + 1);
+  std::vector<int> neighborTris{};
+  std::vector<int> nearbyTris{};
   for (const auto& tri : groundTris) {
     BoundingBox3D triBox = tri.boundingBox;
 
@@ -42,10 +54,12 @@ void PathFinder::generateGroundTriangles(OGLRenderData& renderData, std::shared_
     glm::vec3 boxSize = glm::vec3(triBox.getSize().x, triBox.getSize().y + renderData.rdMaxStairstepHeight * 2, triBox.getSize().z);
     BoundingBox3D queryBox = BoundingBox3D(boxPos, boxSize);
 
-    std::vector<MeshTriangle> nearbyTris = octree->query(queryBox);
+    nearbyTris.clear();
+    bvh->query(queryBox, nearbyTris);
 
-    NavTriangle& navTri = mNavTriangles.at(tri.index);
-    for (const auto& peer : nearbyTris) {
+    neighborTris.clear();
+    for (const auto peerTriIndex : nearbyTris) {
+      const MeshTriangle& peer = bvh->getTriangle(peerTriIndex);
       /* ignore myself */
       if (tri.index == peer.index) {
         continue;
@@ -56,12 +70,12 @@ void PathFinder::generateGroundTriangles(OGLRenderData& renderData, std::shared_
         continue;
       }
 
-      if (mNavTriangles.count(peer.index) == 0) {
+      if (peer.index >= static_cast<int>(navIndices.size()) || navIndices.at(peer.index) == -1) {
         Logger::log(1, "%s error: peer triangle %i for triangle %i not found\n", __FUNCTION__, peer.index, tri.index);
         continue;
       }
 
-      NavTriangle& peerNavTri = mNavTriangles.at(peer.index);
+      int peerNavIndex = navIndices.at(peer.index);
       for (int i = 0; i < 3; ++i) {
         for (int j = 0; j < 3; ++j) {
           /* get distance of triangle points from peer sides, and of peer points from triangle sides */
@@ -71,157 +85,501 @@ void PathFinder::generateGroundTriangles(OGLRenderData& renderData, std::shared_
           float peerPointDistance = glm::length(peerPointToTriLine) / tri.edgeLengths.at(i);
 
           if ((pointDistance < 0.01f || peerPointDistance < 0.01f)) {
-            navTri.neighborTris.insert(peerNavTri.index);
+            neighborTris.emplace_back(peerNavIndex);
           }
 
           /* also add ground triangles which have less than step width a differences in Y direction */
           if (std::fabs(tri.points.at(j).y - peer.points.at(i).y) < renderData.rdMaxStairstepHeight &&
               std::fabs(peer.points.at(j).y - tri.points.at(i).y) < renderData.rdMaxStairstepHeight) {
-            navTri.neighborTris.insert(peerNavTri.index);
+            neighborTris.emplace_back(peerNavIndex);
           }
         }
       }
     }
 
-    vert.position = tri.points.at(0) + tri.normal * 0.1f;
+    /* every neighbor only once, sorted for a linear memory walk during the search */
+    std::sort(neighborTris.begin(), neighborTris.end());
+    neighborTris.erase(std::unique(neighborTris.begin(), neighborTris.end()), neighborTris.end());
+
+    const NavTriangle& currentNavTri = navTriangles.at(navIndices.at(tri.index));
+    navGraph->neighborOffsets.emplace_back(navGraph->neighborIndices.size());
+    for (const auto neighbor : neighborTris) {
+      navGraph->neighborIndices.emplace_back(neighbor);
+      navGraph->neighborCosts.emplace_back(glm::distance(currentNavTri.center, navTriangles.at(neighbor).center));
+    }
+
+  }
+  navGraph->neighborOffsets.emplace_back(navGraph->neighborIndices.size());
+
+  Logger::log(1, "%s: nav graph has %i nodes and %i edges\n", __FUNCTION__, navTriangles.size(), navGraph->neighborIndices.size());
+
+  setNavGraph(renderData, navGraph);
+}
+
+void PathFinder::setNavGraph(OGLRenderData& renderData, std::shared_ptr<NavGraph> navGraph) {
+  /* clusters are cheap to build and depend on the UI setting, they are never loaded */
+  navGraph->navClusters.clear();
+  navGraph->clusterCenters.clear();
+  navGraph->clusterNeighborOffsets.clear();
+  navGraph->clusterNeighborIndices.clear();
+  navGraph->clusterNeighborCosts.clear();
+  generateClusters(*navGraph, renderData.rdNavClusterSize);
+
+  mLevelGroundMesh = std::make_shared<OGLLineMesh>();
+  OGLLineVertex vert;
+  vert.color = glm::vec3(0.0f, 0.2f, 0.8f);
+  for (const auto& navTri : navGraph->navTriangles) {
+    vert.position = navTri.points.at(0) + navTri.normal * 0.1f;
     mLevelGroundMesh->vertices.emplace_back(vert);
-    vert.position = tri.points.at(1) + tri.normal * 0.1f;
+    vert.position = navTri.points.at(1) + navTri.normal * 0.1f;
     mLevelGroundMesh->vertices.emplace_back(vert);
-    vert.position = tri.points.at(2) + tri.normal * 0.1f;
+    vert.position = navTri.points.at(2) + navTri.normal * 0.1f;
     mLevelGroundMesh->vertices.emplace_back(vert);
   }
+
+  mNavGraph = navGraph;
+}
+
+void PathFinder::generateClusters(NavGraph& navGraph, float clusterSize) {
+  navGraph.navClusters.assign(navGraph.navTriangles.size(), -1);
+  if (navGraph.navTriangles.empty()) {
+    navGraph.clusterNeighborOffsets.emplace_back(0);
+    return;
+  }
+
+  clusterSize = std::max(clusterSize, 1.0f);
+
+  glm::vec3 minPos = navGraph.navCenters.at(0);
+  for (const auto& center : navGraph.navCenters) {
+    minPos = glm::min(minPos, center);
+  }
+
+  /* every occupied grid cell becomes a cluster, in order of the first triangle */
+  std::unordered_map<int64_t, int> cellClusters{};
+  std::vector<int> clusterTriangleCount{};
+  for (size_t i = 0; i < navGraph.navCenters.size(); ++i) {
+    const glm::vec3& center = navGraph.navCenters.at(i);
+    int64_t cellX = static_cast<int64_t>(std::floor((center.x - minPos.x) / clusterSize));
+    int64_t cellZ = static_cast<int64_t>(std::floor((center.z - minPos.z) / clusterSize));
+    int64_t cellKey = (cellX << 32) | (cellZ & 0xffffffff);
+
+    auto cellIter = cellClusters.find(cellKey);
+    int cluster = 0;
+    if (cellIter == cellClusters.end()) {
+      cluster = navGraph.clusterCenters.size();
+      cellClusters.emplace(cellKey, cluster);
+      navGraph.clusterCenters.emplace_back(0.0f);
+      clusterTriangleCount.emplace_back(0);
+    } else {
+      cluster = cellIter->second;
+    }
+
+    navGraph.navClusters.at(i) = cluster;
+    navGraph.clusterCenters.at(cluster) += center;
+    ++clusterTriangleCount.at(cluster);
+  }
+
+  for (size_t i = 0; i < navGraph.clusterCenters.size(); ++i) {
+    navGraph.clusterCenters.at(i) /= static_cast<float>(clusterTriangleCount.at(i));
+  }
+
+  /* every triangle edge crossing a cluster border is a portal, keep the cheapest portal per cluster pair */
+  struct ClusterEdge {
+    int from;
+    int to;
+    float cost;
+  };
+  std::vector<ClusterEdge> clusterEdges{};
+  for (size_t i = 0; i < navGraph.navTriangles.size(); ++i) {
+    int cluster = navGraph.navClusters.at(i);
+    for (int j = navGraph.neighborOffsets.at(i); j < navGraph.neighborOffsets.at(i + 1); ++j) {
+      int neighbor = navGraph.neighborIndices.at(j);
+      int neighborCluster = navGraph.navClusters.at(neighbor);
+      if (cluster == neighborCluster) {
+        continue;
+      }
+
+      glm::vec3 portalPos = (navGraph.navCenters.at(i) + navGraph.navCenters.at(neighbor)) / 2.0f;
+      float cost = glm::distance(navGraph.clusterCenters.at(cluster), portalPos) +
+        glm::distance(portalPos, navGraph.clusterCenters.at(neighborCluster));
+      clusterEdges.emplace_back(ClusterEdge{cluster, neighborCluster, cost});
+    }
+  }
+
+  std::sort(clusterEdges.begin(), clusterEdges.end(), [](const ClusterEdge& a, const ClusterEdge& b) {
+    if (a.from != b.from) {
+      return a.from < b.from;
+    }
+    if (a.to != b.to) {
+      return a.to < b.to;
+    }
+    return a.cost < b.cost;
+  });
+
+  /* the cheapest edge of a pair comes first */
+  size_t edgeIndex = 0;
+  for (int cluster = 0; cluster < static_cast<int>(navGraph.clusterCenters.size()); ++cluster) {
+    navGraph.clusterNeighborOffsets.emplace_back(navGraph.clusterNeighborIndices.size());
+    int lastNeighbor = -1;
+    for (; edgeIndex < clusterEdges.size() && clusterEdges.at(edgeIndex).from == cluster; ++edgeIndex) {
+      const ClusterEdge& edge = clusterEdges.at(edgeIndex);
+      if (edge.to == lastNeighbor) {
+        continue;
+      }
+      lastNeighbor = edge.to;
+      navGraph.clusterNeighborIndices.emplace_back(edge.to);
+      navGraph.clusterNeighborCosts.emplace_back(edge.cost);
+    }
+  }
+  navGraph.clusterNeighborOffsets.emplace_back(navGraph.clusterNeighborIndices.size());
+
+  Logger::log(1, "%s: cluster graph has %i nodes and %i edges (cluster size %f)\n", __FUNCTION__,
+    navGraph.clusterCenters.size(), navGraph.clusterNeighborIndices.size(), clusterSize);
+}
+
+int NavGraph::getNavIndex(int triIndex) const {
+  if (triIndex < 0 || triIndex >= static_cast<int>(navIndices.size())) {
+    return -1;
+  }
+  return navIndices.at(triIndex);
+}
+
+std::shared_ptr<const NavGraph> PathFinder::getNavGraph() {
+  return mNavGraph;
 }
 
 std::vector<int> PathFinder::getGroundTriangleNeighbors(int groundTriIndex) {
-  if (mNavTriangles.count(groundTriIndex) ==  0) {
+  int navIndex = mNavGraph->getNavIndex(groundTriIndex);
+  if (navIndex == -1) {
     return std::vector<int>{};
   }
 
-  std::unordered_set neighborIndices = mNavTriangles.at(groundTriIndex).neighborTris;
-
   std::vector<int> neighbors{};
-  for (const auto index : neighborIndices) {
-    neighbors.push_back(index);
+  for (int i = mNavGraph->neighborOffsets.at(navIndex); i < mNavGraph->neighborOffsets.at(navIndex + 1); ++i) {
+    neighbors.push_back(mNavGraph->navTriangles.at(mNavGraph->neighborIndices.at(i)).index);
   }
 
   return neighbors;
 }
 
-std::vector<int> PathFinder::findPath(int startTriIndex, int targetTriIndex) {
-  if (mNavTriangles.count(targetTriIndex) == 0) {
-    Logger::log(1, "%s error: target triangle id %i not found\n", __FUNCTION__, targetTriIndex);
-    return std::vector<int>{};
+std::vector<int> PathFinder::getGroundTriangleIndices() {
+  std::vector<int> indices{};
+  for (const auto& navTri : mNavGraph->navTriangles) {
+    indices.emplace_back(navTri.index);
   }
+  return indices;
+}
+
+void PathFinder::pushOpenHeap(PathSearchData& searchData, int navIndex) {
+  searchData.openHeap.emplace_back(navIndex);
+  searchData.heapPosition[navIndex] = searchData.openHeap.size() - 1;
+  moveUpOpenHeap(searchData, searchData.openHeap.size() - 1);
+}
 
-  NavTriangle targetTri = mNavTriangles.at(targetTriIndex);
-  glm::vec3 targetPoint = targetTri.center;
+int PathFinder::popOpenHeap(PathSearchData& searchData) {
+  int lowestCostIndex = searchData.openHeap.front();
 
-  if (mNavTriangles.count(startTriIndex) == 0) {
-    Logger::log(1, "%s error: source triangle id %i not found\n", __FUNCTION__, startTriIndex);
-    return std::vector<int>{};
+  int lastIndex = searchData.openHeap.back();
+  searchData.openHeap.pop_back();
+  if (!searchData.openHeap.empty()) {
+    searchData.openHeap.front() = lastIndex;
+    searchData.heapPosition[lastIndex] = 0;
+    moveDownOpenHeap(searchData, 0);
+  }
+
+  /* closed */
+  searchData.heapPosition[lowestCostIndex] = -1;
+  return lowestCostIndex;
+}
+
+void PathFinder::moveUpOpenHeap(PathSearchData& searchData, int heapPos) {
+  std::vector<int>& heap = searchData.openHeap;
+  int navIndex = heap[heapPos];
+  float cost = searchData.estimatedCost[navIndex];
+
+  while (heapPos > 0) {
+    int parentPos = (heapPos - 1) / 2;
+    if (searchData.estimatedCost[heap[parentPos]] <= cost) {
+      break;
+    }
+    heap[heapPos] = heap[parentPos];
+    searchData.heapPosition[heap[heapPos]] = heapPos;
+    heapPos = parentPos;
+  }
+
+  heap[heapPos] = navIndex;
+  searchData.heapPosition[navIndex] = heapPos;
+}
+
+void PathFinder::moveDownOpenHeap(PathSearchData& searchData, int heapPos) {
+  std::vector<int>& heap = searchData.openHeap;
+  int heapSize = heap.size();
+  int navIndex = heap[heapPos];
+  float cost = searchData.estimatedCost[navIndex];
+
+  while (true) {
+    int childPos = heapPos * 2 + 1;
+    if (childPos >= heapSize) {
+      break;
+    }
+
+    /* use the cheaper child */
+    if (childPos + 1 < heapSize && searchData.estimatedCost[heap[childPos + 1]] < searchData.estimatedCost[heap[childPos]]) {
+      ++childPos;
+    }
+    if (cost <= searchData.estimatedCost[heap[childPos]]) {
+      break;
+    }
+
+    heap[heapPos] = heap[childPos];
+    searchData.heapPosition[heap[heapPos]] = heapPos;
+    heapPos = childPos;
   }
 
-  NavTriangle startTri = mNavTriangles.at(startTriIndex);
-  glm::vec3 startPoint = startTri.center;
+  heap[heapPos] = navIndex;
+  searchData.heapPosition[navIndex] = heapPos;
+}
 
-  std::unordered_set<int> navOpenList{};
-  std::unordered_set<int> navClosedList{};
-  std::unordered_map<int, NavData> navPoints{};
+const std::vector<int>& PathFinder::findPath(int startTriIndex, int targetTriIndex, bool hierarchical) {
+  return findPath(*mNavGraph, startTriIndex, targetTriIndex, hierarchical);
+}
+
+size_t PathFinder::getLastNodesExpanded() {
+  return mSearchContext.nodesExpanded;
+}
+
+int PathFinder::getNumberOfClusters() {
+  return mNavGraph->clusterCenters.size();
+}
+
+bool PathFinder::searchGraph(PathSearchData& searchData, const std::vector<glm::vec3>& positions,
+    const std::vector<int>& offsets, const std::vector<int>& indices, const std::vector<float>& costs,
+    int startIndex, int targetIndex, const std::vector<int>* nodeClusters, PathSearchContext& context) {
+  /* every thread keeps its arrays, no allocations after the first search on a level */
+  size_t numberOfNodes = positions.size();
+  if (searchData.searchIds.size() != numberOfNodes) {
+    searchData.costFromStart.resize(numberOfNodes);
+    searchData.estimatedCost.resize(numberOfNodes);
+    searchData.prevNavIndex.resize(numberOfNodes);
+    searchData.heapPosition.resize(numberOfNodes);
+    searchData.searchIds.assign(numberOfNodes, 0);
+    searchData.currentSearchId = 0;
+  }
+
+  /* a new search id invalidates the old values, no need to clear the arrays */
+  ++searchData.currentSearchId;
+  if (searchData.currentSearchId == 0) {
+    std::fill(searchData.searchIds.begin(), searchData.searchIds.end(), 0);
+    searchData.currentSearchId = 1;
+  }
+  unsigned int searchId = searchData.currentSearchId;
 
-  int currentIndex = startTriIndex;
+  searchData.openHeap.clear();
+
+  glm::vec3 targetPoint = positions[targetIndex];
 
   /* insert start data */
-  NavData navStartPoint{};
-  navStartPoint.triIndex = startTriIndex;
-  navStartPoint.prevTriIndex = -1;
-  navStartPoint.distanceFromSource = 0;
-  navStartPoint.heuristicToDest = glm::distance(startPoint, targetPoint);
-  navStartPoint.distanceToDest = navStartPoint.distanceFromSource + navStartPoint.heuristicToDest;
-  navPoints.emplace(std::make_pair(startTriIndex, navStartPoint));
-  navOpenList.insert(startTriIndex);
-
-  while (currentIndex != targetTriIndex) {
-    NavTriangle currentTri = mNavTriangles.at(currentIndex);
-    glm::vec3 currentTriPoint = currentTri.center;
-    std::unordered_set<int> neighborTris = currentTri.neighborTris;
-
-    for (const auto& navTriIndex : neighborTris) {
-      NavTriangle navTri = mNavTriangles.at(navTriIndex);
-      glm::vec3 navTriPoint = navTri.center;
-
-      if (navClosedList.count(navTriIndex) == 0) {
-        if (navOpenList.count(navTriIndex) == 0) {
-          /* insert new node */
-          navOpenList.insert(navTriIndex);
-
-          NavData navPoint{};
-
-          navPoint.triIndex = navTriIndex;
-          navPoint.prevTriIndex = currentIndex;
-
-          NavData prevNavPoint = navPoints.at(navPoint.prevTriIndex);
-          navPoint.distanceFromSource = prevNavPoint.distanceFromSource + glm::distance(currentTriPoint, navTriPoint);
-          navPoint.heuristicToDest = glm::distance(navTriPoint, targetPoint);
-          navPoint.distanceToDest = navPoint.distanceFromSource + navPoint.heuristicToDest;
-
-          navPoints.emplace(std::make_pair(navTriIndex, navPoint));
-        } else {
-          /* update triangle if in open list and already visited - and if path with new prev triangle is shorter */
-          NavData& navPoint = navPoints.at(navTriIndex);
-
-          NavData possibleNewPrevNavPoint = navPoints.at(currentIndex);
-          float newDistanceFromSource = possibleNewPrevNavPoint.distanceFromSource + glm::distance(currentTriPoint, navTriPoint);
-          float newDistanceToDest = newDistanceFromSource + navPoint.heuristicToDest;
-          if (newDistanceToDest < navPoint.distanceToDest) {
-            navPoint.prevTriIndex = currentIndex;
-            navPoint.distanceFromSource = newDistanceFromSource;
-            navPoint.distanceToDest = newDistanceToDest;
-          }
-        }
+  searchData.searchIds[startIndex] = searchId;
+  searchData.costFromStart[startIndex] = 0.0f;
+  searchData.estimatedCost[startIndex] = glm::distance(positions[startIndex], targetPoint);
+  searchData.prevNavIndex[startIndex] = -1;
+  pushOpenHeap(searchData, startIndex);
+
+  while (!searchData.openHeap.empty()) {
+    int currentIndex = popOpenHeap(searchData);
+    ++context.nodesExpanded;
+
+    if (currentIndex == targetIndex) {
+      return true;
+    }
+
+    float currentCost = searchData.costFromStart[currentIndex];
+    for (int i = offsets[currentIndex]; i < offsets[currentIndex + 1]; ++i) {
+      int neighborIndex = indices[i];
+
+      /* refinement stays inside the cluster corridor */
+      if (nodeClusters && context.corridorIds[(*nodeClusters)[neighborIndex]] != context.currentCorridorId) {
+        continue;
+      }
+
+      float newCostFromStart = currentCost + costs[i];
+
+      if (searchData.searchIds[neighborIndex] != searchId) {
+        /* insert new node */
+        searchData.searchIds[neighborIndex] = searchId;
+        searchData.costFromStart[neighborIndex] = newCostFromStart;
+        searchData.estimatedCost[neighborIndex] = newCostFromStart + glm::distance(positions[neighborIndex], targetPoint);
+        searchData.prevNavIndex[neighborIndex] = currentIndex;
+        pushOpenHeap(searchData, neighborIndex);
+      } else if (searchData.heapPosition[neighborIndex] >= 0 && newCostFromStart < searchData.costFromStart[neighborIndex]) {
+        /* update node if in open list and the path with the new prev node is shorter */
+        float heuristicToDest = searchData.estimatedCost[neighborIndex] - searchData.costFromStart[neighborIndex];
+        searchData.costFromStart[neighborIndex] = newCostFromStart;
+        searchData.estimatedCost[neighborIndex] = newCostFromStart + heuristicToDest;
+        searchData.prevNavIndex[neighborIndex] = currentIndex;
+        moveUpOpenHeap(searchData, searchData.heapPosition[neighborIndex]);
       }
     }
-    navClosedList.insert(currentIndex);
+  }
+
+  return false;
+}
+
+const std::vector<int>& PathFinder::findPath(const NavGraph& navGraph, int startTriIndex, int targetTriIndex, bool hierarchical) {
+  PathSearchContext& context = mSearchContext;
+  PathSearchData& searchData = context.navSearch;
+
+  searchData.foundPath.clear();
+  context.nodesExpanded = 0;
+
+  int targetNavIndex = navGraph.getNavIndex(targetTriIndex);
+  if (targetNavIndex == -1) {
+    Logger::log(1, "%s error: target triangle id %i not found\n", __FUNCTION__, targetTriIndex);
+    return searchData.foundPath;
+  }
+
+  int startNavIndex = navGraph.getNavIndex(startTriIndex);
+  if (startNavIndex == -1) {
+    Logger::log(1, "%s error: source triangle id %i not found\n", __FUNCTION__, startTriIndex);
+    return searchData.foundPath;
+  }
+
+  bool pathFound = false;
+  bool refined = false;
+
+  if (hierarchical && !navGraph.clusterCenters.empty()) {
+    int startCluster = navGraph.navClusters[startNavIndex];
+    int targetCluster = navGraph.navClusters[targetNavIndex];
+
+    /* portals come from the triangle edges, no cluster route means there is no path at all */
+    if (!searchGraph(context.clusterSearch, navGraph.clusterCenters, navGraph.clusterNeighborOffsets,
+        navGraph.clusterNeighborIndices, navGraph.clusterNeighborCosts, startCluster, targetCluster, nullptr, context)) {
+      Logger::log(1, "%s error: no cluster route from %i to %i\n", __FUNCTION__, startTriIndex, targetTriIndex);
+      return searchData.foundPath;
+    }
 
-    if (navOpenList.empty()) {
-      Logger::log(1, "%s error: nav open list empty while searching for neighbor to %i\n", __FUNCTION__, currentIndex);
-      return std::vector<int>{};
+    if (context.corridorIds.size() != navGraph.clusterCenters.size()) {
+      context.corridorIds.assign(navGraph.clusterCenters.size(), 0);
+      context.currentCorridorId = 0;
+    }
+    ++context.currentCorridorId;
+    if (context.currentCorridorId == 0) {
+      std::fill(context.corridorIds.begin(), context.corridorIds.end(), 0);
+      context.currentCorridorId = 1;
     }
 
-    /* create comparator for min prio queue  */
-    auto cmp = [](NavData left, NavData right) { return left.distanceToDest > right.distanceToDest; };
+    for (int cluster = targetCluster; cluster != -1; cluster = context.clusterSearch.prevNavIndex[cluster]) {
+      context.corridorIds[cluster] = context.currentCorridorId;
+    }
+
+    pathFound = searchGraph(searchData, navGraph.navCenters, navGraph.neighborOffsets, navGraph.neighborIndices,
+      navGraph.neighborCosts, startNavIndex, targetNavIndex, &navGraph.navClusters, context);
+    refined = true;
+  }
 
-    /* create prio queue to find lowest distance to destination  */
-    std::priority_queue<NavData, std::vector<NavData>, decltype(cmp)> naviDataQueue(cmp);
-    for (const auto& navTriIndex : navOpenList) {
-      NavData navPoint = navPoints.at(navTriIndex);
-      naviDataQueue.push(navPoint);
+  /* clusters may be split inside (floors above each other), search the whole graph if the corridor is a dead end */
+  if (!pathFound) {
+    if (refined) {
+      Logger::log(2, "%s: corridor from %i to %i has no path, using flat search\n", __FUNCTION__, startTriIndex, targetTriIndex);
     }
+    pathFound = searchGraph(searchData, navGraph.navCenters, navGraph.neighborOffsets, navGraph.neighborIndices,
+      navGraph.neighborCosts, startNavIndex, targetNavIndex, nullptr, context);
+  }
 
-    NavData nextPointToDest{};
-    nextPointToDest = naviDataQueue.top();
-    currentIndex = nextPointToDest.triIndex;
+  if (!pathFound) {
+    Logger::log(1, "%s error: nav open list empty while searching path from %i to %i\n", __FUNCTION__, startTriIndex, targetTriIndex);
+    return searchData.foundPath;
+  }
 
-    /* remove from open list */
-    navOpenList.erase(currentIndex);
+  /* walk backwards, then turn vector around, start to end */
+  for (int index = targetNavIndex; index != -1; index = searchData.prevNavIndex[index]) {
+    searchData.foundPath.emplace_back(navGraph.navTriangles[index].index);
   }
+  std::reverse(searchData.foundPath.begin(), searchData.foundPath.end());
+  return searchData.foundPath;
+}
+
+void PathFinder::buildFlowField(FlowField& flowField, int targetTriIndex) {
+  std::shared_ptr<const NavGraph> navGraph = mNavGraph;
+  PathSearchData& searchData = mSearchContext.navSearch;
+
+  flowField.navGraph = navGraph;
+  flowField.targetTriIndex = targetTriIndex;
 
-  std::vector<int> foundPath{};
-  /* target point is currentIndex (end condition of while() loop)  */
-  foundPath.emplace_back(currentIndex);
+  size_t numberOfNavTriangles = navGraph->navTriangles.size();
+  flowField.nextNavIndex.assign(numberOfNavTriangles, -1);
+  flowField.costToTarget.assign(numberOfNavTriangles, std::numeric_limits<float>::max());
 
-  /* walk backwards */
-  NavData navPoint = navPoints.at(currentIndex);
-  while (navPoint.prevTriIndex != -1) {
-    foundPath.emplace_back(navPoint.prevTriIndex);
-    navPoint = navPoints.at(navPoint.prevTriIndex);
+  int targetNavIndex = navGraph->getNavIndex(targetTriIndex);
+  if (targetNavIndex == -1) {
+    Logger::log(1, "%s error: target triangle id %i not found\n", __FUNCTION__, targetTriIndex);
+    return;
+  }
+
+  if (searchData.searchIds.size() != numberOfNavTriangles) {
+    searchData.costFromStart.resize(numberOfNavTriangles);
+    searchData.estimatedCost.resize(numberOfNavTriangles);
+    searchData.prevNavIndex.resize(numberOfNavTriangles);
+    searchData.heapPosition.resize(numberOfNavTriangles);
+    searchData.searchIds.assign(numberOfNavTriangles, 0);
+    searchData.currentSearchId = 0;
+  }
+
+  ++searchData.currentSearchId;
+  if (searchData.currentSearchId == 0) {
+    std::fill(searchData.searchIds.begin(), searchData.searchIds.end(), 0);
+    searchData.currentSearchId = 1;
+  }
+  unsigned int searchId = searchData.currentSearchId;
+
+  searchData.openHeap.clear();
+
+  /* no heuristic, the heap is ordered by the plain cost to the target */
+  searchData.searchIds[targetNavIndex] = searchId;
+  searchData.estimatedCost[targetNavIndex] = 0.0f;
+  pushOpenHeap(searchData, targetNavIndex);
+  flowField.costToTarget[targetNavIndex] = 0.0f;
+
+  /* the neighbor relation is symmetric, expanding from the target gives the way back for every triangle */
+  while (!searchData.openHeap.empty()) {
+    int currentIndex = popOpenHeap(searchData);
+    float currentCost = searchData.estimatedCost[currentIndex];
+
+    for (int i = navGraph->neighborOffsets[currentIndex]; i < navGraph->neighborOffsets[currentIndex + 1]; ++i) {
+      int neighborIndex = navGraph->neighborIndices[i];
+      float newCost = currentCost + navGraph->neighborCosts[i];
+
+      if (searchData.searchIds[neighborIndex] != searchId) {
+        searchData.searchIds[neighborIndex] = searchId;
+        searchData.estimatedCost[neighborIndex] = newCost;
+        flowField.costToTarget[neighborIndex] = newCost;
+        flowField.nextNavIndex[neighborIndex] = currentIndex;
+        pushOpenHeap(searchData, neighborIndex);
+      } else if (searchData.heapPosition[neighborIndex] >= 0 && newCost < searchData.estimatedCost[neighborIndex]) {
+        searchData.estimatedCost[neighborIndex] = newCost;
+        flowField.costToTarget[neighborIndex] = newCost;
+        flowField.nextNavIndex[neighborIndex] = currentIndex;
+        moveUpOpenHeap(searchData, searchData.heapPosition[neighborIndex]);
+      }
+    }
   }
-  /* start point is added in while() loop as last parent */
-  //foundPath.emplace_back(startTriIndex);
+}
+
+bool PathFinder::isFlowFieldValid(const FlowField& flowField, int targetTriIndex) {
+  return flowField.navGraph == mNavGraph && flowField.targetTriIndex == targetTriIndex;
+}
 
-  /* turn vector around, start to end */
-  std::reverse(foundPath.begin(), foundPath.end());
+int PathFinder::getFlowFieldNextTriangle(const FlowField& flowField, int triIndex) {
+  int navIndex = flowField.navGraph ? flowField.navGraph->getNavIndex(triIndex) : -1;
+  if (navIndex == -1 || flowField.nextNavIndex[navIndex] == -1) {
+    return -1;
+  }
+  return flowField.navGraph->navTriangles[flowField.nextNavIndex[navIndex]].index;
+}
 
-  return foundPath;
+bool PathFinder::isFlowFieldReachable(const FlowField& flowField, int triIndex) {
+  int navIndex = flowField.navGraph ? flowField.navGraph->getNavIndex(triIndex) : -1;
+  return navIndex != -1 && flowField.costToTarget[navIndex] < std::numeric_limits<float>::max();
 }
 
 std::shared_ptr<OGLLineMesh> PathFinder::getGroundLevelMesh() {
@@ -229,11 +587,12 @@ std::shared_ptr<OGLLineMesh> PathFinder::getGroundLevelMesh() {
 }
 
 glm::vec3 PathFinder::getTriangleCenter(int index) {
-  if (mNavTriangles.count(index) == 0) {
+  int navIndex = mNavGraph->getNavIndex(index);
+  if (navIndex == -1) {
     return glm::vec3(0.0f);
   }
 
-  return mNavTriangles.at(index).center;
+  return mNavGraph->navTriangles.at(navIndex).center;
 }
 
 
@@ -249,16 +608,18 @@ std::shared_ptr<OGLLineMesh> PathFinder::getAsLineMesh(std::vector<int> indices,
   vert.color = color;
 
   for (int i = 0; i < indices.size() - 1; ++i) {
-    if (mNavTriangles.count(indices.at(i)) == 0 || mNavTriangles.count(indices.at(i + 1)) == 0) {
+    int navIndex = mNavGraph->getNavIndex(indices.at(i));
+    int nextNavIndex = mNavGraph->getNavIndex(indices.at(i + 1));
+    if (navIndex == -1 || nextNavIndex == -1) {
       continue;
     }
 
-    NavTriangle tri = mNavTriangles.at(indices.at(i));
+    const NavTriangle& tri = mNavGraph->navTriangles.at(navIndex);
     vert.position = tri.center + tri.normal * offset;
     pointMesh->vertices.emplace_back(vert);
 
-    tri = mNavTriangles.at(indices.at(i + 1));
-    vert.position = tri.center + tri.normal * offset;
+    const NavTriangle& nextTri = mNavGraph->navTriangles.at(nextNavIndex);
+    vert.position = nextTri.center + nextTri.normal * offset;
     pointMesh->vertices.emplace_back(vert);
   }
 
@@ -272,7 +633,11 @@ std::shared_ptr<OGLLineMesh> PathFinder::getAsTriangleMesh(std::vector<int> indi
   OGLLineVertex normalVert;
 
   for (const auto index : indices) {
-    NavTriangle tri = mNavTriangles.at(index);
+    int navIndex = mNavGraph->getNavIndex(index);
+    if (navIndex == -1) {
+      continue;
+    }
+    const NavTriangle& tri = mNavGraph->navTriangles.at(navIndex);
 
     vert.color = color;
     /* move wireframe overdraw a bit above the planes */
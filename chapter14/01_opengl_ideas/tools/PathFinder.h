@@ -1,38 +1,115 @@
 #pragma once
 
 #include <vector>
-#include <vector>
-#include <unordered_map>
-#include <unordered_set>
+#include <array>
 #include <memory>
 #include <glm/glm.hpp>
 
-#include "TriangleOctree.h"
+#include "TriangleBVH.h"
 #include "BoundingBox3D.h"
 #include "OGLRenderData.h"
 
 struct NavTriangle {
+  /* index of the level triangle */
   int index;
   std::array<glm::vec3, 3> points{};
   glm::vec3 center{};
   glm::vec3 normal{};
-  std::unordered_set<int> neighborTris{};
 };
 
-struct NavData {
-  int triIndex;
-  int prevTriIndex;
-  float distanceFromSource;
-  float heuristicToDest;
-  float distanceToDest;
+/* per-thread search state, all arrays are indexed by the dense node index of the searched graph */
+struct PathSearchData {
+  std::vector<float> costFromStart{};
+  std::vector<float> estimatedCost{};
+  std::vector<int> prevNavIndex{};
+  /* position in the open heap, -1 if the triangle is closed */
+  std::vector<int> heapPosition{};
+  /* the other values of a triangle are only valid if the id matches the current search */
+  std::vector<unsigned int> searchIds{};
+  unsigned int currentSearchId = 0;
+
+  /* binary min heap of nav triangle indices, ordered by estimated cost */
+  std::vector<int> openHeap{};
+
+  std::vector<int> foundPath{};
+};
+
+/* all per-thread data of a flat or hierarchical search */
+struct PathSearchContext {
+  PathSearchData navSearch{};
+  PathSearchData clusterSearch{};
+
+  /* clusters on the abstract path are stamped with the current corridor id */
+  std::vector<unsigned int> corridorIds{};
+  unsigned int currentCorridorId = 0;
+
+  size_t nodesExpanded = 0;
+};
+
+/* the immutable part of the nav data, path searches on other threads keep their own reference */
+struct NavGraph {
+  /* dense list of the ground triangles */
+  std::vector<NavTriangle> navTriangles{};
+  /* level triangle index to nav triangle index, -1 for non-ground triangles */
+  std::vector<int> navIndices{};
+
+  /* neighbors in CSR layout, the neighbors of triangle i are in [neighborOffsets[i], neighborOffsets[i + 1]) */
+  std::vector<int> neighborOffsets{};
+  std::vector<int> neighborIndices{};
+  /* distance between the triangle centers */
+  std::vector<float> neighborCosts{};
+  /* dense copy of the triangle centers, the search reads only the centers */
+  std::vector<glm::vec3> navCenters{};
+
+  /* abstract graph, ground triangles are grouped into spatial clusters on a XZ grid */
+  std::vector<int> navClusters{};
+  std::vector<glm::vec3> clusterCenters{};
+  /* same CSR layout as above, cost is the cheapest way between the cluster centers through a portal edge */
+  std::vector<int> clusterNeighborOffsets{};
+  std::vector<int> clusterNeighborIndices{};
+  std::vector<float> clusterNeighborCosts{};
+
+  int getNavIndex(int triIndex) const;
+};
+
+/* distance field of all ground triangles to a single target triangle, shared by every instance walking to the target */
+struct FlowField {
+  /* graph the field was built on, a new graph makes the field invalid */
+  std::shared_ptr<const NavGraph> navGraph = nullptr;
+  int targetTriIndex = -1;
+
+  /* indexed by the nav triangle index, next triangle is -1 for the target and for unreachable triangles */
+  std::vector<int> nextNavIndex{};
+  std::vector<float> costToTarget{};
 };
 
 class PathFinder {
   public:
-    void generateGroundTriangles(OGLRenderData& renderData, std::shared_ptr<TriangleOctree> octree, BoundingBox3D worldbox);
+    void generateGroundTriangles(OGLRenderData& renderData, std::shared_ptr<TriangleBVH> bvh);
+    /* uses a graph built before (i.e. from the level data cache), adds clusters and the ground mesh */
+    void setNavGraph(OGLRenderData& renderData, std::shared_ptr<NavGraph> navGraph);
     std::vector<int> getGroundTriangleNeighbors(int groundTriIndex);
+    std::vector<int> getGroundTriangleIndices();
+
+    /* returns the level triangle indices from start to target, empty if there is no path
+     * the reference stays valid until the next call of findPath() in the same thread */
+    /* the hierarchical search finds a cluster route first and refines only inside the clusters of the route */
+    const std::vector<int>& findPath(int startTriIndex, int targetTriIndex, bool hierarchical);
+    /* same search on a graph snapshot, safe to call from any thread */
+    static const std::vector<int>& findPath(const NavGraph& navGraph, int startTriIndex, int targetTriIndex, bool hierarchical);
+    /* nodes taken from the open list by the last search in this thread, both graph layers */
+    static size_t getLastNodesExpanded();
+    int getNumberOfClusters();
 
-    std::vector<int> findPath(int startTriIndex, int targetTriIndex);
+    /* Dijkstra from the target over the whole ground graph, reuses the arrays of the field */
+    void buildFlowField(FlowField& flowField, int targetTriIndex);
+    bool isFlowFieldValid(const FlowField& flowField, int targetTriIndex);
+    /* level triangle index of the next step, -1 if the triangle is the target or unreachable */
+    int getFlowFieldNextTriangle(const FlowField& flowField, int triIndex);
+    bool isFlowFieldReachable(const FlowField& flowField, int triIndex);
+
+    /* the graph is replaced, not changed, when the level changes */
+    std::shared_ptr<const NavGraph> getNavGraph();
 
     glm::vec3 getTriangleCenter(int index);
 
@@ -41,6 +118,20 @@ class PathFinder {
     std::shared_ptr<OGLLineMesh> getAsTriangleMesh(std::vector<int> indices, glm::vec3 color, glm::vec3 normalColor, glm::vec3 offset);
 
   private:
-    std::unordered_map<int, NavTriangle> mNavTriangles{};
+    void generateClusters(NavGraph& navGraph, float clusterSize);
+
+    /* A* on a CSR graph, nodes outside the corridor are ignored if nodeClusters is set */
+    static bool searchGraph(PathSearchData& searchData, const std::vector<glm::vec3>& positions,
+      const std::vector<int>& offsets, const std::vector<int>& indices, const std::vector<float>& costs,
+      int startIndex, int targetIndex, const std::vector<int>* nodeClusters, PathSearchContext& context);
+
+    static void pushOpenHeap(PathSearchData& searchData, int navIndex);
+    static int popOpenHeap(PathSearchData& searchData);
+    static void moveUpOpenHeap(PathSearchData& searchData, int heapPos);
+    static void moveDownOpenHeap(PathSearchData& searchData, int heapPos);
+
+    std::shared_ptr<const NavGraph> mNavGraph = std::make_shared<NavGraph>();
+    static thread_local PathSearchContext mSearchContext;
+
     std::shared_ptr<OGLLineMesh> mLevelGroundMesh = nullptr;
 };
@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include "PathService.h"
+#include "Logger.h"
+
+void PathService::init(unsigned int numThreads) {
+  cleanup();
+
+  mShutdown = false;
+  for (unsigned int i = 0; i < std::max(1u, numThreads); ++i) {
+    mWorkers.emplace_back(&PathService::workerLoop, this);
+  }
+
+  Logger::log(1, "%s: path service uses %i threads\n", __FUNCTION__, mWorkers.size());
+}
+
+void PathService::setNavGraph(std::shared_ptr<const NavGraph> navGraph) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mNavGraph = navGraph;
+
+  mRequests = {};
+  std::fill(mLatestSequences.begin(), mLatestSequences.end(), 0);
+  mNumberOfPendingRequests = 0;
+  mResults.clear();
+}
+
+void PathService::requestPath(int owner, int startTriIndex, int targetTriIndex, int priority, bool hierarchical) {
+  if (owner < 0) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (owner >= static_cast<int>(mLatestSequences.size())) {
+      mLatestSequences.resize(owner + 1, 0);
+    }
+
+    /* the old request of the owner stays in the queue, but will be skipped */
+    if (mLatestSequences.at(owner) == 0) {
+      ++mNumberOfPendingRequests;
+    }
+
+    PathRequest request{};
+    request.owner = owner;
+    request.startTriIndex = startTriIndex;
+    request.targetTriIndex = targetTriIndex;
+    request.priority = priority;
+    request.hierarchical = hierarchical;
+    request.sequence = mNextSequence++;
+
+    mLatestSequences.at(owner) = request.sequence;
+    mRequests.push(request);
+  }
+  mWakeCondition.notify_one();
+}
+
+bool PathService::getResult(PathResult& result) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mResults.empty()) {
+    return false;
+  }
+
+  result = std::move(mResults.front());
+  mResults.pop_front();
+  return true;
+}
+
+size_t PathService::getNumberOfPendingRequests() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mNumberOfPendingRequests;
+}
+
+void PathService::workerLoop() {
+  PathRequest request{};
+  PathResult result{};
+
+  while (true) {
+    std::shared_ptr<const NavGraph> navGraph = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWakeCondition.wait(lock, [this]() { return mShutdown || !mRequests.empty(); });
+      if (mShutdown) {
+        return;
+      }
+
+      request = mRequests.top();
+      mRequests.pop();
+
+      /* replaced by a newer request of the same owner */
+      if (mLatestSequences.at(request.owner) != request.sequence) {
+        continue;
+      }
+      navGraph = mNavGraph;
+    }
+
+    if (!navGraph) {
+      continue;
+    }
+
+    /* the snapshot is never changed, no lock needed during the search */
+    const std::vector<int>& path = PathFinder::findPath(*navGraph, request.startTriIndex, request.targetTriIndex,
+      request.hierarchical);
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      /* graph was replaced or the owner asked again during the search */
+      if (navGraph != mNavGraph || mLatestSequences.at(request.owner) != request.sequence) {
+        continue;
+      }
+
+      mLatestSequences.at(request.owner) = 0;
+      --mNumberOfPendingRequests;
+
+      result.owner = request.owner;
+      result.startTriIndex = request.startTriIndex;
+      result.targetTriIndex = request.targetTriIndex;
+      result.path = path;
+      result.nodesExpanded = PathFinder::getLastNodesExpanded();
+      mResults.emplace_back(std::move(result));
+    }
+  }
+}
+
+void PathService::cleanup() {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mShutdown = true;
+  }
+  mWakeCondition.notify_all();
+
+  for (auto& worker : mWorkers) {
+    worker.join();
+  }
+  mWorkers.clear();
+
+  mRequests = {};
+  mLatestSequences.clear();
+  mNumberOfPendingRequests = 0;
+  mResults.clear();
+}
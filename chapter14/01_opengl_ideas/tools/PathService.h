@@ -0,0 +1,78 @@
+/* asynchronous path searches, a few background threads work on a snapshot of the nav graph */
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <queue>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include "PathFinder.h"
+
+struct PathRequest {
+  /* the id of the requesting instance */
+  int owner = -1;
+  int startTriIndex = -1;
+  int targetTriIndex = -1;
+  /* higher values are searched first */
+  int priority = 0;
+  bool hierarchical = false;
+  uint64_t sequence = 0;
+};
+
+struct PathResult {
+  int owner = -1;
+  int startTriIndex = -1;
+  int targetTriIndex = -1;
+  /* empty if the target is unreachable */
+  std::vector<int> path{};
+  size_t nodesExpanded = 0;
+};
+
+class PathService {
+  public:
+    void init(unsigned int numThreads);
+
+    /* drops all pending requests and results, they belong to the old graph */
+    void setNavGraph(std::shared_ptr<const NavGraph> navGraph);
+
+    /* replaces a pending request of the same owner */
+    void requestPath(int owner, int startTriIndex, int targetTriIndex, int priority, bool hierarchical);
+    /* returns false if no result is waiting */
+    bool getResult(PathResult& result);
+
+    size_t getNumberOfPendingRequests();
+
+    void cleanup();
+
+  private:
+    struct PathRequestCompare {
+      bool operator()(const PathRequest& a, const PathRequest& b) const {
+        /* highest priority first, oldest request first */
+        if (a.priority != b.priority) {
+          return a.priority < b.priority;
+        }
+        return a.sequence > b.sequence;
+      }
+    };
+
+    void workerLoop();
+
+    std::vector<std::thread> mWorkers{};
+
+    std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    bool mShutdown = false;
+
+    std::priority_queue<PathRequest, std::vector<PathRequest>, PathRequestCompare> mRequests{};
+    /* sequence of the newest request per owner, older requests of the owner are skipped */
+    std::vector<uint64_t> mLatestSequences{};
+    uint64_t mNextSequence = 1;
+    size_t mNumberOfPendingRequests = 0;
+
+    std::deque<PathResult> mResults{};
+    std::shared_ptr<const NavGraph> mNavGraph = nullptr;
+};
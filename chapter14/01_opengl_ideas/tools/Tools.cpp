@@ -1,4 +1,6 @@
 #include <limits>
+#include <cstdlib>
+#include <cmath>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
@@ -60,7 +62,7 @@ glm::mat4 Tools::convertAiToGLM(aiMatrix4x4 inMat) {
 }
 
 /* Möller-Trumbore ray-triangle intersection */
-std::optional<glm::vec3> Tools::rayTriangleIntersection(glm::vec3 rayOrigin, glm::vec3 rayDirection, MeshTriangle triangle) {
+std::optional<glm::vec3> Tools::rayTriangleIntersection(glm::vec3 rayOrigin, glm::vec3 rayDirection, const MeshTriangle& triangle) {
   constexpr float epsilon = std::numeric_limits<float>::epsilon();
 
   glm::vec3 edge1 = triangle.points.at(1) - triangle.points.at(0);
@@ -148,3 +150,31 @@ std::vector<std::string> Tools::getDirectoryContent(std::string path, std::strin
 
   return files;
 }
+
+std::optional<int> Tools::parseInt(std::string text) {
+  if (text.empty()) {
+    return {};
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  long value = std::strtol(text.c_str(), &end, 10);
+  if (errno != 0 || *end != '\0' || value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+    return {};
+  }
+  return static_cast<int>(value);
+}
+
+std::optional<float> Tools::parseFloat(std::string text) {
+  if (text.empty()) {
+    return {};
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  float value = std::strtof(text.c_str(), &end);
+  if (errno != 0 || *end != '\0' || !std::isfinite(value)) {
+    return {};
+  }
+  return value;
+}
@@ -16,10 +16,14 @@ class Tools {
 
     static glm::mat4 convertAiToGLM(aiMatrix4x4 inMat);
 
-    static std::optional<glm::vec3> rayTriangleIntersection(glm::vec3 rayOrigin, glm::vec3 rayDirection, MeshTriangle triangle);
+    static std::optional<glm::vec3> rayTriangleIntersection(glm::vec3 rayOrigin, glm::vec3 rayDirection, const MeshTriangle& triangle);
 
     static glm::vec4 extractGlobalPosition(glm::mat4 nodeMatrix);
     static glm::quat extractGlobalRotation(glm::mat4 nodeMatrix);
 
     static std::vector<std::string> getDirectoryContent(std::string path, std::string extension);
+
+    /* for command line arguments, empty if the whole text is not a number */
+    static std::optional<int> parseInt(std::string text);
+    static std::optional<float> parseFloat(std::string text);
 };
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+
+#include "VertexPacker.h"
+
+bool VertexPacker::canPack(const std::vector<OGLVertex>& vertices) {
+  for (const auto& vertex : vertices) {
+    if (glm::any(glm::greaterThan(vertex.boneNumber, glm::uvec4(255)))) {
+      return false;
+    }
+    if (glm::any(glm::greaterThan(glm::abs(glm::vec3(vertex.position)), glm::vec3(MAX_HALF_VALUE)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<OGLPackedVertex> VertexPacker::pack(const std::vector<OGLVertex>& vertices) {
+  std::vector<OGLPackedVertex> packedVertices;
+  packedVertices.reserve(vertices.size());
+  for (const auto& vertex : vertices) {
+    packedVertices.emplace_back(packVertex(vertex));
+  }
+  return packedVertices;
+}
+
+OGLPackedVertex VertexPacker::packVertex(const OGLVertex& vertex) {
+  OGLPackedVertex packedVertex{};
+  packedVertex.position = glm::packHalf(glm::vec4(glm::vec3(vertex.position), 0.0f));
+  packedVertex.uv = glm::vec2(vertex.position.w, vertex.normal.w);
+  packedVertex.normal = encodeNormal(glm::vec3(vertex.normal));
+  packedVertex.color = glm::packUnorm<glm::uint8>(glm::clamp(vertex.color, 0.0f, 1.0f));
+  packedVertex.boneNumber = glm::u8vec4(vertex.boneNumber);
+  packedVertex.boneWeight = encodeWeights(vertex.boneWeight);
+  return packedVertex;
+}
+
+glm::i16vec2 VertexPacker::encodeNormal(glm::vec3 normal) {
+  /* project to the octahedron and fold the lower half over the diagonals */
+  float length = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+  if (length == 0.0f) {
+    return glm::i16vec2(0);
+  }
+
+  glm::vec2 encoded = glm::vec2(normal) / length;
+  if (normal.z < 0.0f) {
+    glm::vec2 signs = glm::vec2(encoded.x >= 0.0f ? 1.0f : -1.0f, encoded.y >= 0.0f ? 1.0f : -1.0f);
+    encoded = (1.0f - glm::abs(glm::vec2(encoded.y, encoded.x))) * signs;
+  }
+  return glm::packSnorm<glm::int16>(encoded);
+}
+
+glm::u8vec4 VertexPacker::encodeWeights(glm::vec4 weights) {
+  glm::vec4 scaled = glm::clamp(weights, 0.0f, 1.0f) * 255.0f;
+  glm::ivec4 quantized = glm::ivec4(glm::round(scaled));
+
+  /* keep the sum of the weights, the rounding error goes to the largest weight */
+  int sum = static_cast<int>(std::round(std::min(scaled.x + scaled.y + scaled.z + scaled.w, 255.0f)));
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (quantized[i] > quantized[largest]) {
+      largest = i;
+    }
+  }
+  quantized[largest] = std::clamp(quantized[largest] + sum - (quantized.x + quantized.y + quantized.z + quantized.w), 0, 255);
+
+  return glm::u8vec4(quantized);
+}
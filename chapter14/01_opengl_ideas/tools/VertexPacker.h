@@ -0,0 +1,22 @@
+/* conversion of the Assimp vertices to the packed vertex layout */
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "OGLRenderData.h"
+
+class VertexPacker {
+  public:
+    /* the bone ids must fit into a byte and the positions into a half float */
+    static bool canPack(const std::vector<OGLVertex>& vertices);
+    static std::vector<OGLPackedVertex> pack(const std::vector<OGLVertex>& vertices);
+
+  private:
+    static OGLPackedVertex packVertex(const OGLVertex& vertex);
+    static glm::i16vec2 encodeNormal(glm::vec3 normal);
+    static glm::u8vec4 encodeWeights(glm::vec4 weights);
+
+    /* largest finite half float */
+    static constexpr float MAX_HALF_VALUE = 65504.0f;
+};
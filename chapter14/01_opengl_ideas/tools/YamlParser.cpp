@@ -185,6 +185,18 @@ YAML::Emitter& operator<<(YAML::Emitter& out, const ActionAnimation& settings) {
   return out;
 }
 
+YAML::Emitter& operator<<(YAML::Emitter& out, const AnimationLodTier& settings) {
+  out << YAML::BeginMap;
+  out << YAML::Key << "min-distance";
+  out << YAML::Value << settings.altMinDistance;
+  out << YAML::Key << "update-interval";
+  out << YAML::Value << settings.altUpdateInterval;
+  out << YAML::Key << "reduced-skeleton";
+  out << YAML::Value << settings.altReducedSkeleton;
+  out << YAML::EndMap;
+  return out;
+}
+
 YAML::Emitter& operator<<(YAML::Emitter& out, const ModelSettings& settings) {
   out << YAML::Key << "model-name";
   out << YAML::Value << settings.msModelFilename;
@@ -192,6 +204,8 @@ YAML::Emitter& operator<<(YAML::Emitter& out, const ModelSettings& settings) {
   out << YAML::Value << settings.msModelFilenamePath;
   out << YAML::Key << "is-nav-target";
   out << YAML::Value << settings.msUseAsNavigationTarget;
+  out << YAML::Key << "pack-vertices";
+  out << YAML::Value << settings.msPackVertices;
   if (!settings.msIWRBlendings.empty()) {
     out << YAML::Key << "idle-walk-run-clips";
     out << YAML::Value;
@@ -274,6 +288,17 @@ YAML::Emitter& operator<<(YAML::Emitter& out, const ModelSettings& settings) {
     out << YAML::EndSeq;
 
   }
+  if (settings.msUseAnimationLod) {
+    out << YAML::Key << "animation-lod-tiers";
+    out << YAML::Value;
+    out << YAML::BeginSeq;
+    for (auto& setting : settings.msAnimationLodTiers) {
+      out << YAML::Value << setting;
+    }
+    out << YAML::EndSeq;
+    out << YAML::Key << "reduced-skeleton-depth";
+    out << YAML::Value << settings.msReducedSkeletonDepth;
+  }
   return out;
 }
 
@@ -84,6 +84,30 @@ namespace YAML {
     }
   };
 
+  /* read and write AnimationLodTier */
+  template<>
+  struct convert<AnimationLodTier> {
+    static Node encode(const AnimationLodTier& rhs) {
+      Node node;
+      node["min-distance"] = rhs.altMinDistance;
+      node["update-interval"] = rhs.altUpdateInterval;
+      node["reduced-skeleton"] = rhs.altReducedSkeleton;
+      return node;
+    }
+
+    static bool decode(const Node& node, AnimationLodTier& rhs) {
+      try {
+        rhs.altMinDistance = node["min-distance"].as<float>();
+        rhs.altUpdateInterval = node["update-interval"].as<int>();
+        rhs.altReducedSkeleton = node["reduced-skeleton"].as<bool>();
+      } catch (...) {
+        Logger::log(1, "%s warning: could not parse animation LOD tier, using defaults\n", __FUNCTION__);
+        rhs = AnimationLodTier{};
+      }
+      return true;
+    }
+  };
+
   /* read and write moveState */
   template<>
   struct convert<moveState> {
@@ -563,6 +587,7 @@ namespace YAML {
       node["model-file"] = rhs.msModelFilenamePath;
       node["model-name"] = rhs.msModelFilename;
       node["is-nav-target"] = rhs.msUseAsNavigationTarget;
+      node["pack-vertices"] = rhs.msPackVertices;
       Node clips = node["idle-walk-run-clips"];
       for (const auto& blend : rhs.msIWRBlendings) {
         clips[blend.first] = blend.second;
@@ -581,6 +606,12 @@ namespace YAML {
       for (const auto& state : rhs.msHeadMoveClipMappings) {
         clips[state.first] = state.second;
       }
+      if (rhs.msUseAnimationLod) {
+        for (const auto& tier : rhs.msAnimationLodTiers) {
+          node["animation-lod-tiers"].push_back(tier);
+        }
+        node["reduced-skeleton-depth"] = rhs.msReducedSkeletonDepth;
+      }
       return node;
     }
 
@@ -684,6 +715,26 @@ namespace YAML {
           rhs.msFootIKChainNodes.at(1).clear();
         }
       }
+      if (Node clipNode = node["animation-lod-tiers"]) {
+        try {
+          for (size_t i = 0; i < clipNode.size() && i < rhs.msAnimationLodTiers.size(); ++i) {
+            rhs.msAnimationLodTiers.at(i) = clipNode[i].as<AnimationLodTier>();
+          }
+          rhs.msUseAnimationLod = true;
+        } catch (...) {
+          Logger::log(1, "%s warning: could not parse animation LOD tiers of model '%s', disabling\n", __FUNCTION__, rhs.msModelFilename.c_str());
+          rhs.msAnimationLodTiers = defaultSettings.msAnimationLodTiers;
+          rhs.msUseAnimationLod = false;
+        }
+      }
+      if (node["reduced-skeleton-depth"]) {
+        try {
+          rhs.msReducedSkeletonDepth = node["reduced-skeleton-depth"].as<int>();
+        } catch (...) {
+          Logger::log(1, "%s warning: could not parse reduced skeleton depth of model '%s', using default\n", __FUNCTION__, rhs.msModelFilename.c_str());
+          rhs.msReducedSkeletonDepth = defaultSettings.msReducedSkeletonDepth;
+        }
+      }
       if (node["is-nav-target"]) {
         try {
           rhs.msUseAsNavigationTarget = node["is-nav-target"].as<bool>();
@@ -692,6 +743,14 @@ namespace YAML {
           rhs.msUseAsNavigationTarget = false;
         }
       }
+      if (node["pack-vertices"]) {
+        try {
+          rhs.msPackVertices = node["pack-vertices"].as<bool>();
+        } catch (...) {
+          Logger::log(1, "%s warning: could not parse vertex packing of model '%s', disabling\n", __FUNCTION__, rhs.msModelFilename.c_str());
+          rhs.msPackVertices = false;
+        }
+      }
       return true;
     }
   };